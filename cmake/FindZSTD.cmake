@@ -0,0 +1,44 @@
+# - Try to find zstd include dirs and libraries
+#
+# Usage of this module as follows:
+#
+#     find_package(ZSTD)
+#
+# Variables used by this module, they can change the default behaviour and need
+# to be set before calling find_package:
+#
+#  ZSTD_ROOT_DIR             Set this variable to the root installation of
+#                            zstd if the module has problems finding the
+#                            proper installation path.
+#
+# Variables defined by this module:
+#
+#  ZSTD_FOUND                System has zstd, include and library dirs found
+#  ZSTD_INCLUDE_DIR          The zstd include directories.
+#  ZSTD_LIBRARY              The zstd library
+
+find_path(ZSTD_ROOT_DIR
+    NAMES include/zstd.h
+)
+
+find_path(ZSTD_INCLUDE_DIR
+    NAMES zstd.h
+    HINTS ${ZSTD_ROOT_DIR}/include
+)
+
+find_library(ZSTD_LIBRARY
+    NAMES zstd zstd_static
+    HINTS ${ZSTD_ROOT_DIR}/lib
+)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(ZSTD DEFAULT_MSG
+    ZSTD_LIBRARY
+    ZSTD_INCLUDE_DIR
+)
+
+mark_as_advanced(
+    ZSTD_ROOT_DIR
+    ZSTD_INCLUDE_DIR
+    ZSTD_LIBRARY
+)
@@ -0,0 +1,6924 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <string>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <linux/filter.h>
+#include <linux/if_packet.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "pcap.h"
+#include "netinet/if_ether.h"
+#include "netinet/ip.h"
+#include "netinet/udp.h"
+#include "arrow/api.h"
+#include "arrow/filesystem/api.h"
+#include "arrow/io/file.h"
+#include "arrow/io/memory.h"
+#include "arrow/ipc/api.h"
+#include "parquet/bloom_filter.h"
+#include "parquet/bloom_filter_reader.h"
+#include "parquet/column_reader.h"
+#include "parquet/column_writer.h"
+#include "parquet/exception.h"
+#include "parquet/file_reader.h"
+#include "parquet/file_writer.h"
+#include "parquet/page_index.h"
+#include "parquet/schema.h"
+#include "zlib.h"
+#include "zstd.h"
+
+#include "itch_types.h"
+
+// pcap to parquet conversion shared by the itch feeds, included after the feed types once namespace feed names them, ie namespace feed = nasdaq::itch
+
+///////////////////////////////////////////////////////////////////////
+// line arbitration
+///////////////////////////////////////////////////////////////////////
+
+// earliest copy of each moldudp64 message across the A and B lines, holes stay open until the other line fills them or they age out
+struct arbiter {
+
+    using session_name = decltype(feed::session::data);
+
+    // missing [first, last) sequence numbers
+    struct gap {
+        session_name session;
+        std::uint64_t first = 0;
+        std::uint64_t last = 0;
+        std::chrono::nanoseconds opened{0}; // capture time of the packet after the hole
+    };
+
+    struct line {
+        session_name session;
+        std::uint64_t next = 0; // first sequence number past everything seen
+        std::vector<gap> open;
+    };
+
+    enum class verdict { none, all, some };
+
+    bool drop_duplicates = true;
+    std::chrono::nanoseconds window{std::chrono::seconds{1}}; // open gaps older than this are final
+    std::vector<line> lines;
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> fresh; // accepted [first, last) of the last packet
+    std::vector<gap> closed; // final gaps, drained by the converter
+
+    std::uint64_t packets = 0;
+    std::uint64_t duplicate_packets = 0; // dropped whole before decoding
+    std::uint64_t duplicate_messages = 0;
+    std::uint64_t gaps = 0;
+    std::uint64_t missing = 0; // messages in final gaps
+
+    line& find(const session_name& session) {
+        for (auto& candidate : lines) {
+            if (candidate.session.view() == session.view()) {
+                return candidate;
+            }
+        }
+        return lines.emplace_back(line{session, 0, {}});
+    }
+
+    // drop the copy of a packet already seen on the other line, fresh holds the accepted ranges when some messages are new
+    verdict arbitrate(const session_name& session, const std::uint64_t first, const std::uint16_t count, const std::chrono::nanoseconds now) {
+        // end of session
+        if (count == 0xffff) {
+            return verdict::none;
+        }
+
+        packets += 1;
+
+        auto& line = find(session);
+        const auto last = first + count;
+
+        expire(line, now);
+        fresh.clear();
+
+        if (line.next == 0) {
+            line.next = first;
+        }
+
+        // late copies fill holes left by the first line
+        for (std::size_t index = 0; index < line.open.size();) {
+            auto& hole = line.open[index];
+            const auto from = std::max(hole.first, first);
+            const auto to = std::min(hole.last, last);
+
+            if (from >= to) {
+                ++index;
+                continue;
+            }
+
+            fresh.emplace_back(from, to);
+
+            if (hole.first < from && to < hole.last) {
+                auto right = hole;
+                right.first = to;
+                hole.last = from;
+                line.open.insert(line.open.begin() + static_cast<std::ptrdiff_t>(index) + 1, right);
+                index += 2;
+            }
+            else if (hole.first < from) {
+                hole.last = from;
+                ++index;
+            }
+            else if (to < hole.last) {
+                hole.first = to;
+                ++index;
+            }
+            else {
+                line.open.erase(line.open.begin() + static_cast<std::ptrdiff_t>(index));
+            }
+        }
+
+        if (first > line.next) {
+            line.open.push_back(gap{session, line.next, first, now});
+        }
+
+        if (last > line.next) {
+            fresh.emplace_back(std::max(first, line.next), last);
+            line.next = last;
+        }
+
+        std::uint64_t accepted = 0;
+        for (const auto& [from, to] : fresh) {
+            accepted += to - from;
+        }
+        duplicate_messages += count - accepted;
+
+        if (!drop_duplicates || accepted == count) {
+            return verdict::all;
+        }
+
+        if (accepted == 0) {
+            duplicate_packets += count > 0 ? 1 : 0;
+            return verdict::none;
+        }
+
+        return verdict::some;
+    }
+
+    // message of a partly duplicated packet is new
+    [[nodiscard]] bool accepts(const std::uint64_t sequence) const {
+        return std::any_of(fresh.begin(), fresh.end(), [sequence](const auto& range) { return range.first <= sequence && sequence < range.second; });
+    }
+
+    void expire(line& line, const std::chrono::nanoseconds now) {
+        for (std::size_t index = 0; index < line.open.size();) {
+            if (now - line.open[index].opened > window) {
+                close(line.open[index]);
+                line.open.erase(line.open.begin() + static_cast<std::ptrdiff_t>(index));
+            } else {
+                ++index;
+            }
+        }
+    }
+
+    void close(const gap& hole) {
+        gaps += 1;
+        missing += hole.last - hole.first;
+        closed.push_back(hole);
+    }
+
+    // every open gap is final at the end of the capture
+    void finish() {
+        for (auto& line : lines) {
+            for (const auto& hole : line.open) {
+                close(hole);
+            }
+            line.open.clear();
+        }
+    }
+
+    // sidecar table of final gaps, opened in nanoseconds like the pcap_timestamp column
+    static auto schema() {
+        return std::static_pointer_cast<parquet::schema::GroupNode>(parquet::schema::GroupNode::Make("schema", parquet::Repetition::REQUIRED, parquet::schema::NodeVector{
+            parquet::schema::PrimitiveNode::Make("session", parquet::Repetition::REQUIRED, parquet::Type::BYTE_ARRAY, parquet::ConvertedType::UTF8),
+            parquet::schema::PrimitiveNode::Make("first_sequence", parquet::Repetition::REQUIRED, parquet::Type::INT64, parquet::ConvertedType::UINT_64),
+            parquet::schema::PrimitiveNode::Make("missing", parquet::Repetition::REQUIRED, parquet::Type::INT64, parquet::ConvertedType::UINT_64),
+            parquet::schema::PrimitiveNode::Make(pcap_timestamp::name, parquet::Repetition::REQUIRED, pcap_timestamp::logical_type(), parquet::Type::INT64)}));
+    }
+
+    // final gaps as one row group through the column writers
+    static void write(parquet::ParquetFileWriter& file, const std::vector<gap>& holes) {
+        if (holes.empty()) {
+            return;
+        }
+
+        std::vector<parquet::ByteArray> sessions;
+        std::vector<std::int64_t> firsts;
+        std::vector<std::int64_t> missing;
+        std::vector<std::int64_t> opened;
+
+        for (const auto& hole : holes) {
+            const auto session = hole.session.view();
+            sessions.emplace_back(static_cast<std::uint32_t>(session.size()), reinterpret_cast<const std::uint8_t*>(session.data()));
+            firsts.push_back(parquet_value(hole.first));
+            missing.push_back(parquet_value(hole.last - hole.first));
+            opened.push_back(parquet_value(hole.opened));
+        }
+
+        const auto rows = static_cast<std::int64_t>(holes.size());
+        auto* row_group = file.AppendRowGroup();
+        static_cast<parquet::ByteArrayWriter*>(row_group->NextColumn())->WriteBatch(rows, nullptr, nullptr, sessions.data());
+        static_cast<parquet::Int64Writer*>(row_group->NextColumn())->WriteBatch(rows, nullptr, nullptr, firsts.data());
+        static_cast<parquet::Int64Writer*>(row_group->NextColumn())->WriteBatch(rows, nullptr, nullptr, missing.data());
+        static_cast<parquet::Int64Writer*>(row_group->NextColumn())->WriteBatch(rows, nullptr, nullptr, opened.data());
+        row_group->Close();
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& out, const arbiter& lines) {
+    return out << lines.packets << " packets, " << lines.duplicate_packets << " duplicate packets dropped, "
+               << lines.duplicate_messages << " duplicate messages, " << lines.missing << " messages missing in " << lines.gaps << " gaps";
+}
+
+///////////////////////////////////////////////////////////////////////
+// pcap reader
+///////////////////////////////////////////////////////////////////////
+
+// captured packet header with nanosecond timestamp
+struct packet_header {
+    std::chrono::nanoseconds timestamp{0};
+    std::uint32_t caplen = 0;
+    std::uint32_t len = 0;
+};
+
+// udp datagram of an ethernet frame
+struct datagram {
+    const ip* header = nullptr;
+    const udphdr* udp = nullptr;
+    const u_char* payload = nullptr;
+    std::uint32_t length = 0; // payload bytes
+};
+
+// 802.1q and 802.1ad tags, q in q at most
+constexpr int max_vlan_tags = 2;
+
+// ethernet, vlan, ipv4 and udp headers, false for other traffic and for frames cut short of the udp length
+inline bool read_datagram(const u_char* frame, const std::uint32_t caplen, datagram* out) {
+    std::uint32_t offset = 12;
+    std::uint16_t type = 0;
+
+    for (int tags = 0;; ++tags) {
+        if (offset + 2 > caplen) {
+            return false;
+        }
+        type = static_cast<std::uint16_t>(frame[offset] << 8 | frame[offset + 1]);
+        if ((type != ETHERTYPE_VLAN && type != 0x88a8) || tags == max_vlan_tags) {
+            break;
+        }
+        offset += 4;
+    }
+    offset += 2;
+
+    if (type != ETHERTYPE_IP || offset + sizeof(ip) > caplen) {
+        return false;
+    }
+
+    // a header length under five words would put the udp header inside the ip header
+    out->header = reinterpret_cast<const ip*>(frame + offset);
+    if (out->header->ip_hl < 5) {
+        return false;
+    }
+    offset += out->header->ip_hl * 4u;
+
+    if (out->header->ip_p != IPPROTO_UDP || offset + sizeof(udphdr) > caplen) {
+        return false;
+    }
+
+    out->udp = reinterpret_cast<const udphdr*>(frame + offset);
+    offset += sizeof(udphdr);
+
+    const std::uint32_t length = ntohs(out->udp->uh_ulen);
+    if (length < sizeof(udphdr) || offset + length - sizeof(udphdr) > caplen) {
+        return false;
+    }
+
+    out->payload = frame + offset;
+    out->length = length - static_cast<std::uint32_t>(sizeof(udphdr));
+
+    return true;
+}
+
+// compiled bpf filter of ethernet frames, ie "udp and dst host 233.54.12.111", frames failing it are dropped before parsing
+struct packet_filter {
+
+    static constexpr int snapshot = 262144;
+
+    std::string expression;
+    bpf_program program{};
+
+    explicit packet_filter(const std::string& expression) : expression{expression} {
+        const auto compiler = pcap_open_dead(DLT_EN10MB, snapshot);
+        if (compiler == nullptr) {
+            throw std::runtime_error("Unable to compile packet filter " + expression);
+        }
+
+        if (pcap_compile(compiler, &program, expression.c_str(), 1, PCAP_NETMASK_UNKNOWN) != 0) {
+            const std::string error = pcap_geterr(compiler);
+            pcap_close(compiler);
+            throw std::invalid_argument("Invalid packet filter " + expression + ": " + error);
+        }
+
+        pcap_close(compiler);
+    }
+
+    packet_filter(const packet_filter&) = delete;
+    packet_filter& operator=(const packet_filter&) = delete;
+
+    ~packet_filter() {
+        pcap_freecode(&program);
+    }
+
+    [[nodiscard]] bool matches(const packet_header& header, const u_char* frame) const {
+        return bpf_filter(program.bf_insns, frame, header.len, header.caplen) != 0;
+    }
+};
+
+// decompressed bytes with headroom in front, the unread tail of the previous block is copied there
+struct inflated_block {
+    std::vector<u_char> bytes;
+    std::size_t offset = 0; // first byte
+};
+
+// gzip and zstd captures decompressed ahead of the reader on their own threads, finished blocks are handed over whole so decompression overlaps decoding
+struct decompressor {
+
+    static constexpr std::size_t block_size = 16 << 20;
+    static constexpr std::size_t headroom = 1 << 20; // longest record carried across a block boundary
+    static constexpr std::size_t frame_limit = 64 << 20; // zstd frames up to this size decompress in parallel
+    static constexpr std::size_t release_window = 64 << 20;
+
+    enum class codec { gzip, zstd };
+
+    int descriptor = -1;
+    const u_char* input = nullptr;
+    std::size_t size = 0;
+    std::size_t released = 0;
+    std::string path;
+    codec kind;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::vector<std::optional<inflated_block>> slots; // blocks decompressed ahead, by sequence modulo depth
+    std::vector<std::vector<u_char>> spare; // recycled block buffers
+    std::size_t consumed = 0; // blocks handed to the reader
+    std::size_t claimed = 0; // frames handed to workers
+    std::size_t offset = 0; // next frame
+    std::size_t finished = 0; // workers done
+    bool streaming = false; // a worker is streaming an oversized frame, claims wait for it
+    bool stopping = false;
+    std::exception_ptr error;
+    std::vector<std::thread> workers;
+
+    // codec from the file magic, none for uncompressed files
+    static std::optional<codec> codec_of(const std::string& path) {
+        std::array<u_char, 4> magic{};
+
+        const auto descriptor = ::open(path.c_str(), O_RDONLY);
+        if (descriptor < 0) {
+            return std::nullopt;
+        }
+        const auto length = ::read(descriptor, magic.data(), magic.size());
+        ::close(descriptor);
+
+        if (length >= 2 && magic[0] == 0x1f && magic[1] == 0x8b) {
+            return codec::gzip;
+        }
+        if (length == 4 && magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd) {
+            return codec::zstd;
+        }
+        return std::nullopt;
+    }
+
+    decompressor(const std::string& path, const codec kind, const std::size_t threads) : path{path}, kind{kind} {
+        descriptor = ::open(path.c_str(), O_RDONLY);
+        if (descriptor < 0) {
+            throw std::runtime_error("Unable to open file " + path);
+        }
+
+        struct stat status{};
+        if (::fstat(descriptor, &status) != 0 || status.st_size == 0) {
+            ::close(descriptor);
+            throw std::runtime_error("Unable to read file " + path);
+        }
+        size = static_cast<std::size_t>(status.st_size);
+
+        auto mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(descriptor);
+            throw std::runtime_error("Unable to map file " + path);
+        }
+        ::madvise(mapping, size, MADV_SEQUENTIAL);
+        input = static_cast<const u_char*>(mapping);
+
+        // independent small frames, as written by pzstd or the seekable format, decompress on every thread
+        if (kind == codec::zstd && threads > 1 && framed()) {
+            slots.resize(2 * threads);
+            for (std::size_t index = 0; index < threads; ++index) {
+                workers.emplace_back([this] { run(&decompressor::decompress_frames); });
+            }
+            return;
+        }
+
+        // double buffered, one block decompressing while the reader decodes the last
+        slots.resize(2);
+        const auto step = kind == codec::gzip ? &decompressor::inflate_gzip : &decompressor::inflate_zstd;
+        workers.emplace_back([this, step] { run(step); });
+    }
+
+    decompressor(const decompressor&) = delete;
+    decompressor& operator=(const decompressor&) = delete;
+
+    ~decompressor() {
+        {
+            std::lock_guard lock{mutex};
+            stopping = true;
+        }
+        changed.notify_all();
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        ::munmap(const_cast<u_char*>(input), size);
+        ::close(descriptor);
+    }
+
+    // first frame declares a size under the limit and more frames follow
+    [[nodiscard]] bool framed() const {
+        const auto content = ZSTD_getFrameContentSize(input, size);
+        if (content == ZSTD_CONTENTSIZE_UNKNOWN || content == ZSTD_CONTENTSIZE_ERROR || content > frame_limit) {
+            return false;
+        }
+
+        const auto length = ZSTD_findFrameCompressedSize(input, size);
+        return !ZSTD_isError(length) && length < size;
+    }
+
+    // next block in file order, false once everything is decompressed
+    bool next(inflated_block* block) {
+        std::unique_lock lock{mutex};
+
+        while (true) {
+            auto& slot = slots[consumed % slots.size()];
+            changed.wait(lock, [&] { return error || slot.has_value() || finished == workers.size(); });
+
+            if (error) {
+                std::rethrow_exception(error);
+            }
+            if (!slot.has_value()) {
+                return false;
+            }
+
+            *block = std::move(*slot);
+            slot.reset();
+            consumed += 1;
+            changed.notify_all();
+
+            // skippable frames decompress to nothing
+            if (block->bytes.size() > block->offset) {
+                return true;
+            }
+            spare.push_back(std::move(block->bytes));
+        }
+    }
+
+    // buffer of a block the reader is done with
+    void recycle(std::vector<u_char>&& bytes) {
+        if (bytes.capacity() > 0) {
+            std::lock_guard lock{mutex};
+            spare.push_back(std::move(bytes));
+        }
+    }
+
+    template <typename work>
+    void run(work step) {
+        try {
+            (this->*step)();
+        } catch (...) {
+            std::lock_guard lock{mutex};
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+
+        {
+            std::lock_guard lock{mutex};
+            finished += 1;
+        }
+        changed.notify_all();
+    }
+
+    // empty block with length bytes after the headroom
+    inflated_block take(const std::size_t length) {
+        inflated_block block;
+        {
+            std::lock_guard lock{mutex};
+            if (!spare.empty()) {
+                block.bytes = std::move(spare.back());
+                spare.pop_back();
+            }
+        }
+        block.bytes.resize(headroom + length);
+        block.offset = headroom;
+        return block;
+    }
+
+    // hand over block sequence once the reader is within depth of it, false when stopping
+    bool publish(const std::size_t sequence, inflated_block&& block) {
+        std::unique_lock lock{mutex};
+        changed.wait(lock, [&] { return stopping || sequence < consumed + slots.size(); });
+
+        if (stopping) {
+            return false;
+        }
+
+        slots[sequence % slots.size()] = std::move(block);
+        changed.notify_all();
+        return true;
+    }
+
+    // drop compressed pages already decompressed
+    void release(const std::size_t position) {
+        if (position - released < release_window) {
+            return;
+        }
+
+        const auto length = (position - released) & ~(static_cast<std::size_t>(::getpagesize()) - 1);
+        ::madvise(const_cast<u_char*>(input + released), length, MADV_DONTNEED);
+        released += length;
+    }
+
+    // concatenated gzip members, inflate is called until it stops making progress
+    // since it can hold back output after the last input is fed, a last member without its trailer is an error and zero padding after it ends the stream
+    void inflate_gzip() {
+        z_stream stream{};
+        if (inflateInit2(&stream, 15 + 16) != Z_OK) {
+            throw std::runtime_error("Unable to start gzip decompression " + path);
+        }
+        std::unique_ptr<z_stream, decltype(&inflateEnd)> guard{&stream, inflateEnd};
+
+        std::size_t fed = 0;
+        bool done = false;
+        bool truncated = false;
+
+        for (std::size_t sequence = 0; !done; ++sequence) {
+            auto block = take(block_size);
+            stream.next_out = block.bytes.data() + headroom;
+            stream.avail_out = block_size;
+
+            while (stream.avail_out > 0) {
+                // avail_in is 32 bits
+                if (stream.avail_in == 0 && fed < size) {
+                    stream.next_in = const_cast<Bytef*>(input + fed);
+                    stream.avail_in = static_cast<uInt>(std::min<std::size_t>(size - fed, 1 << 30));
+                    fed += stream.avail_in;
+                }
+
+                const auto result = inflate(&stream, Z_NO_FLUSH);
+
+                if (result == Z_STREAM_END) {
+                    const auto zero = [](const Bytef byte) { return byte == 0; };
+                    if (std::all_of(stream.next_in, stream.next_in + stream.avail_in, zero) && std::all_of(input + fed, input + size, zero)) {
+                        done = true;
+                        break;
+                    }
+                    inflateReset(&stream);
+                }
+                // no progress with output space left, only possible once the input is spent
+                else if (result == Z_BUF_ERROR && stream.avail_in == 0 && fed == size) {
+                    done = true;
+                    truncated = true;
+                    break;
+                }
+                else if (result != Z_OK) {
+                    throw std::runtime_error("Corrupt gzip stream " + path);
+                }
+            }
+
+            block.bytes.resize(headroom + block_size - stream.avail_out);
+            if (!publish(sequence, std::move(block))) {
+                return;
+            }
+            release(fed - stream.avail_in);
+        }
+
+        if (truncated) {
+            throw std::runtime_error("Truncated gzip stream " + path);
+        }
+    }
+
+    // single zstd stream, a truncated last frame is an error as with gzip
+    void inflate_zstd() {
+        std::unique_ptr<ZSTD_DStream, decltype(&ZSTD_freeDStream)> stream{ZSTD_createDStream(), ZSTD_freeDStream};
+        ZSTD_initDStream(stream.get());
+
+        ZSTD_inBuffer in{input, size, 0};
+        bool done = false;
+        bool truncated = false;
+
+        for (std::size_t sequence = 0; !done; ++sequence) {
+            auto block = take(block_size);
+            ZSTD_outBuffer out{block.bytes.data() + headroom, block_size, 0};
+
+            while (out.pos < out.size) {
+                const auto result = ZSTD_decompressStream(stream.get(), &out, &in);
+                if (ZSTD_isError(result)) {
+                    throw std::runtime_error("Corrupt zstd stream " + path + ": " + ZSTD_getErrorName(result));
+                }
+
+                // output space left over means everything decodable is flushed, a frame still expecting input never ended
+                if (in.pos == in.size && (result == 0 || out.pos < out.size)) {
+                    done = true;
+                    truncated = result != 0;
+                    break;
+                }
+            }
+
+            block.bytes.resize(headroom + out.pos);
+            if (!publish(sequence, std::move(block))) {
+                return;
+            }
+            release(in.pos);
+        }
+
+        if (truncated) {
+            throw std::runtime_error("Truncated zstd stream " + path);
+        }
+    }
+
+    // whole zstd frames, each worker claims the next frame within depth of the reader
+    // every frame is checked against the limit, larger frames and frames without a declared size stream in bounded blocks
+    void decompress_frames() {
+        std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> context{ZSTD_createDCtx(), ZSTD_freeDCtx};
+
+        while (true) {
+            const u_char* source = nullptr;
+            std::size_t length = 0;
+            std::size_t sequence = 0;
+            unsigned long long content = 0;
+            bool truncated = false;
+            bool oversized = false;
+            {
+                std::unique_lock lock{mutex};
+                changed.wait(lock, [&] { return stopping || offset == size || (!streaming && claimed < consumed + slots.size()); });
+
+                if (stopping || offset == size) {
+                    return;
+                }
+
+                // a truncated last frame is an error, as with the single stream, the other workers stop claiming
+                length = ZSTD_findFrameCompressedSize(input + offset, size - offset);
+                if (ZSTD_isError(length)) {
+                    offset = size;
+                    changed.notify_all();
+                    truncated = true;
+                } else {
+                    source = input + offset;
+                    content = ZSTD_getFrameContentSize(source, length);
+                    oversized = content == ZSTD_CONTENTSIZE_UNKNOWN || (content != ZSTD_CONTENTSIZE_ERROR && content > frame_limit);
+                    streaming = oversized;
+                    offset += length;
+                    sequence = claimed++;
+                }
+            }
+
+            if (truncated) {
+                throw std::runtime_error("Truncated zstd frame " + path + ": " + ZSTD_getErrorName(length));
+            }
+            if (content == ZSTD_CONTENTSIZE_ERROR) {
+                throw std::runtime_error("Corrupt zstd frame " + path);
+            }
+
+            if (oversized) {
+                if (!stream_frame(context.get(), source, length, sequence)) {
+                    return;
+                }
+                continue;
+            }
+
+            auto block = take(static_cast<std::size_t>(content));
+            const auto written = ZSTD_decompressDCtx(context.get(), block.bytes.data() + headroom, content, source, length);
+            if (ZSTD_isError(written)) {
+                throw std::runtime_error("Corrupt zstd frame " + path + ": " + ZSTD_getErrorName(written));
+            }
+
+            block.bytes.resize(headroom + written);
+            if (!publish(sequence, std::move(block))) {
+                return;
+            }
+        }
+    }
+
+    // one frame through the streaming decoder into block sized blocks, sequence is the first block's
+    // claims stay closed until the frame ends so its blocks are numbered back to back, false when stopping
+    bool stream_frame(ZSTD_DCtx* context, const u_char* source, const std::size_t length, std::size_t sequence) {
+        ZSTD_DCtx_reset(context, ZSTD_reset_session_only);
+        ZSTD_inBuffer in{source, length, 0};
+
+        while (true) {
+            auto block = take(block_size);
+            ZSTD_outBuffer out{block.bytes.data() + headroom, block_size, 0};
+
+            std::size_t result = 0;
+            do {
+                result = ZSTD_decompressStream(context, &out, &in);
+                if (ZSTD_isError(result)) {
+                    throw std::runtime_error("Corrupt zstd frame " + path + ": " + ZSTD_getErrorName(result));
+                }
+            } while (result != 0 && out.pos < out.size && in.pos < in.size);
+
+            // the frame was measured whole, input spent before it ends means a corrupt header
+            if (result != 0 && out.pos < out.size) {
+                throw std::runtime_error("Corrupt zstd frame " + path);
+            }
+
+            block.bytes.resize(headroom + out.pos);
+            if (!publish(sequence, std::move(block))) {
+                return false;
+            }
+
+            std::lock_guard lock{mutex};
+            if (result == 0) {
+                streaming = false;
+                changed.notify_all();
+                return true;
+            }
+            sequence = claimed++;
+        }
+    }
+};
+
+// input framing, pcap covers pcap and pcapng
+enum class input_format { pcap, moldudp64, binaryfile };
+
+// input framing by name, auto detects pcap and pcapng from the file magic
+inline input_format input_named(const std::string_view name) {
+    if (name == "auto" || name == "pcap") return input_format::pcap;
+    if (name == "moldudp64") return input_format::moldudp64;
+    if (name == "binaryfile") return input_format::binaryfile;
+    throw std::invalid_argument("Unknown input format " + std::string{name});
+}
+
+// memory mapped pcap, pcapng, raw moldudp64 and binaryfile reader, packets point straight into the mapping
+// or into the current decompressed block of a gzip or zstd capture
+struct capture {
+
+    static constexpr std::uint32_t pcap_micro_magic = 0xa1b2c3d4;
+    static constexpr std::uint32_t pcap_nano_magic = 0xa1b23c4d;
+    static constexpr std::uint32_t pcapng_magic = 0x1a2b3c4d;
+    static constexpr std::uint32_t section_header_block = 0x0a0d0d0a;
+    static constexpr std::uint32_t interface_description_block = 0x00000001;
+    static constexpr std::uint32_t obsolete_packet_block = 0x00000002;
+    static constexpr std::uint32_t simple_packet_block = 0x00000003;
+    static constexpr std::uint32_t enhanced_packet_block = 0x00000006;
+    static constexpr std::uint16_t if_tsresol = 9;
+    static constexpr std::size_t pcap_header_size = 24;
+    static constexpr std::size_t pcap_record_size = 16;
+    static constexpr std::size_t moldudp64_header_size = 20;
+    static constexpr std::uint16_t end_of_session = 0xffff;
+    static constexpr std::size_t release_window = 64 << 20;
+
+    enum class file_format { pcap, pcapng, moldudp64, binaryfile };
+
+    int descriptor = -1;
+    const u_char* begin = nullptr;
+    const u_char* end = nullptr;
+    const u_char* current = nullptr;
+    const u_char* released = nullptr;
+    std::size_t size = 0;
+    file_format format = file_format::pcap;
+    bool swapped = false;
+    bool nanoseconds = false;
+    std::vector<std::uint64_t> resolutions; // pcapng timestamp units per second, by interface
+    std::unique_ptr<decompressor> stream; // compressed captures
+    inflated_block window; // decompressed bytes begin to end point into
+    std::shared_ptr<const packet_filter> filter; // pcap and pcapng frames only
+    std::uint64_t filtered = 0; // packets the filter dropped
+
+    explicit capture(const std::string& path, const input_format input = input_format::pcap, const std::size_t threads = 1) {
+        if (const auto codec = decompressor::codec_of(path)) {
+            stream = std::make_unique<decompressor>(path, *codec, threads);
+
+            while (static_cast<std::size_t>(end - current) < pcap_header_size && refill()) {
+            }
+            if (end - begin < 4) {
+                throw std::runtime_error("Unable to read file " + path);
+            }
+
+            open_section(path, input);
+            return;
+        }
+
+        descriptor = ::open(path.c_str(), O_RDONLY);
+        if (descriptor < 0) {
+            throw std::runtime_error("Unable to open file " + path);
+        }
+
+        struct stat status{};
+        if (::fstat(descriptor, &status) != 0 || status.st_size < 4) {
+            ::close(descriptor);
+            throw std::runtime_error("Unable to read file " + path);
+        }
+        size = static_cast<std::size_t>(status.st_size);
+
+        auto mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(descriptor);
+            throw std::runtime_error("Unable to map file " + path);
+        }
+
+        // hints only, the kernel is free to ignore either
+        ::madvise(mapping, size, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+        ::madvise(mapping, size, MADV_HUGEPAGE);
+#endif
+
+        begin = static_cast<const u_char*>(mapping);
+        end = begin + size;
+        released = begin;
+
+        open_section(path, input);
+    }
+
+    capture(const capture&) = delete;
+    capture& operator=(const capture&) = delete;
+
+    ~capture() {
+        if (begin != nullptr && stream == nullptr) {
+            ::munmap(const_cast<u_char*>(begin), size);
+        }
+        if (descriptor >= 0) {
+            ::close(descriptor);
+        }
+    }
+
+    // identify format and byte order from the file magic, raw dumps have none
+    void open_section(const std::string& path, const input_format input) {
+        if (input != input_format::pcap) {
+            format = input == input_format::moldudp64 ? file_format::moldudp64 : file_format::binaryfile;
+            current = begin;
+            return;
+        }
+
+        switch (const auto magic = read(begin); magic) {
+            case pcap_micro_magic:
+            case pcap_nano_magic:
+            case __builtin_bswap32(pcap_micro_magic):
+            case __builtin_bswap32(pcap_nano_magic):
+                swapped = magic == __builtin_bswap32(pcap_micro_magic) || magic == __builtin_bswap32(pcap_nano_magic);
+                nanoseconds = magic == pcap_nano_magic || magic == __builtin_bswap32(pcap_nano_magic);
+                if (static_cast<std::size_t>(end - begin) < pcap_header_size) {
+                    throw std::runtime_error("Truncated pcap header " + path);
+                }
+                format = file_format::pcap;
+                current = begin + pcap_header_size;
+                break;
+
+            case section_header_block:
+                format = file_format::pcapng;
+                current = begin;
+                break;
+
+            default:
+                throw std::runtime_error("Unknown capture format " + path + ", raw dumps need --format");
+        }
+    }
+
+    [[nodiscard]] std::uint16_t read16(const u_char* data) const {
+        std::uint16_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return swapped ? __builtin_bswap16(value) : value;
+    }
+
+    // moldudp64 and itch lengths are big endian whatever the capture byte order
+    [[nodiscard]] static std::uint16_t read_be16(const u_char* data) {
+        return static_cast<std::uint16_t>((data[0] << 8) | data[1]);
+    }
+
+    [[nodiscard]] std::uint32_t read(const u_char* data) const {
+        std::uint32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return swapped ? __builtin_bswap32(value) : value;
+    }
+
+    // resumable read position, pcapng sections carry byte order and interface resolutions
+    struct cursor {
+        std::size_t offset = 0;
+        bool swapped = false;
+        std::vector<std::uint64_t> resolutions;
+    };
+
+    [[nodiscard]] cursor position() const {
+        return cursor{static_cast<std::size_t>(current - begin), swapped, resolutions};
+    }
+
+    // read from a packet boundary found by an earlier pass, up to limit bytes into the file
+    void seek(const cursor& cursor, const std::size_t limit) {
+        const auto page = static_cast<std::size_t>(::getpagesize());
+
+        current = begin + std::min(cursor.offset, size);
+        end = begin + std::min(limit, size);
+        released = begin + (static_cast<std::size_t>(current - begin) & ~(page - 1));
+        swapped = cursor.swapped;
+        resolutions = cursor.resolutions;
+    }
+
+    // next packet passing the filter, false at end of file or on a truncated record
+    bool next(packet_header* header, const u_char** packet) {
+        while (next_captured(header, packet)) {
+            if (!filter || filter->matches(*header, *packet)) {
+                return true;
+            }
+            filtered += 1;
+        }
+        return false;
+    }
+
+    bool next_captured(packet_header* header, const u_char** packet) {
+        if (stream) {
+            // records cut by the end of a block are read again from the next
+            while (!next_framed(header, packet)) {
+                if (!refill()) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        release();
+
+        return next_framed(header, packet);
+    }
+
+    // move the unread tail in front of the next decompressed block, false at the end of the stream
+    bool refill() {
+        const auto tail = static_cast<std::size_t>(end - current);
+
+        // no record is this long, the capture is corrupt
+        if (tail > decompressor::headroom) {
+            return false;
+        }
+
+        inflated_block block;
+        if (!stream->next(&block)) {
+            return false;
+        }
+
+        block.offset -= tail;
+        if (tail > 0) {
+            std::memcpy(block.bytes.data() + block.offset, current, tail);
+        }
+
+        stream->recycle(std::move(window.bytes));
+        window = std::move(block);
+
+        begin = current = released = window.bytes.data() + window.offset;
+        end = window.bytes.data() + window.bytes.size();
+
+        return true;
+    }
+
+    bool next_framed(packet_header* header, const u_char** packet) {
+        switch (format) {
+            case file_format::pcap: return next_record(header, packet);
+            case file_format::pcapng: return next_block(header, packet);
+            case file_format::moldudp64: return next_moldudp64(header, packet);
+            case file_format::binaryfile: return next_message(header, packet);
+        }
+        return false;
+    }
+
+    // moldudp64 packet without udp framing, its extent is the header plus count length prefixed messages
+    bool next_moldudp64(packet_header* header, const u_char** packet) {
+        if (static_cast<std::size_t>(end - current) < moldudp64_header_size) {
+            return false;
+        }
+
+        const auto count = read_be16(current + moldudp64_header_size - 2);
+        auto position = current + moldudp64_header_size;
+
+        for (std::uint32_t index = 0; count != end_of_session && index < count; ++index) {
+            if (end - position < 2 || static_cast<std::size_t>(end - position) - 2 < read_be16(position)) {
+                return false;
+            }
+            position += 2 + read_be16(position);
+        }
+
+        header->timestamp = std::chrono::nanoseconds{0};
+        header->caplen = header->len = static_cast<std::uint32_t>(position - current);
+        *packet = current;
+        current = position;
+
+        return true;
+    }
+
+    // binaryfile message, a two byte big endian length then the message
+    bool next_message(packet_header* header, const u_char** packet) {
+        if (end - current < 2 || static_cast<std::size_t>(end - current) - 2 < read_be16(current)) {
+            return false;
+        }
+
+        header->timestamp = std::chrono::nanoseconds{0};
+        header->caplen = header->len = 2u + read_be16(current);
+        *packet = current;
+        current += header->caplen;
+
+        return true;
+    }
+
+    bool next_record(packet_header* header, const u_char** packet) {
+        if (static_cast<std::size_t>(end - current) < pcap_record_size) {
+            return false;
+        }
+
+        const auto seconds = read(current);
+        const auto fraction = read(current + 4);
+        header->caplen = read(current + 8);
+        header->len = read(current + 12);
+
+        if (header->caplen > static_cast<std::size_t>(end - current) - pcap_record_size) {
+            return false;
+        }
+
+        header->timestamp = std::chrono::seconds{seconds} + (nanoseconds ? std::chrono::nanoseconds{fraction} : std::chrono::microseconds{fraction});
+        *packet = current + pcap_record_size;
+        current += pcap_record_size + header->caplen;
+
+        return true;
+    }
+
+    bool next_block(packet_header* header, const u_char** packet) {
+        while (static_cast<std::size_t>(end - current) >= 12) {
+            const auto block = current;
+
+            std::uint32_t type;
+            std::memcpy(&type, block, sizeof(type));
+
+            // byte order can change with every section
+            if (type == section_header_block) {
+                std::uint32_t magic;
+                std::memcpy(&magic, block + 8, sizeof(magic));
+                if (magic != pcapng_magic && magic != __builtin_bswap32(pcapng_magic)) {
+                    return false;
+                }
+                swapped = magic != pcapng_magic;
+                resolutions.clear();
+            } else {
+                type = read(block);
+            }
+
+            const auto length = read(block + 4);
+            if (length < 12 || length % 4 != 0 || length > static_cast<std::size_t>(end - block)) {
+                return false;
+            }
+            current = block + length;
+
+            const auto body = block + 8;
+            const auto body_length = length - 12;
+
+            switch (type) {
+                case interface_description_block:
+                    resolutions.push_back(interface_resolution(body, body_length));
+                    break;
+
+                case enhanced_packet_block:
+                case obsolete_packet_block: {
+                    if (body_length < 20) {
+                        return false;
+                    }
+
+                    const auto interface = type == enhanced_packet_block ? read(body) : read16(body);
+                    const auto units = (static_cast<std::uint64_t>(read(body + 4)) << 32) | read(body + 8);
+                    header->caplen = read(body + 12);
+                    header->len = read(body + 16);
+
+                    if (header->caplen > body_length - 20) {
+                        return false;
+                    }
+
+                    header->timestamp = to_nanoseconds(units, interface < resolutions.size() ? resolutions[interface] : 1'000'000);
+                    *packet = body + 20;
+
+                    return true;
+                }
+
+                case simple_packet_block: {
+                    if (body_length < 4) {
+                        return false;
+                    }
+
+                    // simple packets carry no timestamp
+                    header->len = read(body);
+                    header->caplen = std::min<std::uint32_t>(header->len, body_length - 4);
+                    header->timestamp = std::chrono::nanoseconds{0};
+                    *packet = body + 4;
+
+                    return true;
+                }
+
+                default:
+                    break;
+            }
+        }
+
+        return false;
+    }
+
+    // if_tsresol option, microseconds unless specified
+    [[nodiscard]] std::uint64_t interface_resolution(const u_char* body, const std::uint32_t length) const {
+        std::uint32_t offset = 8;
+
+        while (offset + 4 <= length) {
+            const auto code = read16(body + offset);
+            const auto option_length = read16(body + offset + 2);
+            offset += 4;
+
+            if (code == 0 || offset + option_length > length) {
+                break;
+            }
+
+            if (code == if_tsresol && option_length >= 1) {
+                const auto value = body[offset];
+                const auto exponent = value & 0x7f;
+
+                if (value & 0x80) {
+                    return exponent < 64 ? std::uint64_t{1} << exponent : 1'000'000;
+                }
+
+                std::uint64_t units = 1;
+                for (auto i = 0; i < exponent && i < 19; ++i) {
+                    units *= 10;
+                }
+                return units;
+            }
+
+            offset += (option_length + 3) & ~3u;
+        }
+
+        return 1'000'000;
+    }
+
+    static std::chrono::nanoseconds to_nanoseconds(const std::uint64_t units, const std::uint64_t resolution) {
+        const auto seconds = units / resolution;
+        const auto fraction = static_cast<unsigned __int128>(units % resolution) * 1'000'000'000 / resolution;
+
+        return std::chrono::seconds{seconds} + std::chrono::nanoseconds{static_cast<std::uint64_t>(fraction)};
+    }
+
+    // drop pages already consumed so resident memory stays bounded on large captures
+    void release() {
+        if (static_cast<std::size_t>(current - released) < release_window) {
+            return;
+        }
+
+        const auto length = static_cast<std::size_t>(current - released) & ~(static_cast<std::size_t>(::getpagesize()) - 1);
+        ::madvise(const_cast<u_char*>(released), length, MADV_DONTNEED);
+        released += length;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////
+// live capture
+///////////////////////////////////////////////////////////////////////
+
+// set by SIGINT and SIGTERM, live capture finishes the open file and returns
+inline volatile std::sig_atomic_t stop_requested = 0;
+
+inline void request_stop(int) {
+    stop_requested = 1;
+}
+
+// multicast group and udp port, ie 233.54.12.111:26477
+struct endpoint {
+    in_addr address{};
+    std::uint16_t port = 0; // zero accepts every port of the group
+
+    endpoint() = default;
+
+    explicit endpoint(const std::string& text) {
+        const auto colon = text.find(':');
+        const auto host = text.substr(0, colon);
+
+        if (inet_pton(AF_INET, host.c_str(), &address) != 1) {
+            throw std::invalid_argument("Invalid multicast group " + text);
+        }
+        if (colon != std::string::npos) {
+            port = static_cast<std::uint16_t>(std::stoul(text.substr(colon + 1)));
+        }
+    }
+};
+
+// TPACKET_V3 mmap ring on one interface, frames of retired blocks are handed out in place
+struct ring {
+
+    int socket = -1;
+    int membership = -1; // udp socket holding the group join
+    u_char* map = nullptr;
+    std::size_t map_size = 0;
+    tpacket_req3 request{};
+    std::uint32_t block = 0;
+    endpoint group;
+
+    std::uint64_t packets = 0; // frames the kernel delivered
+    std::uint64_t accepted = 0; // of the group
+    std::uint64_t drops = 0; // kernel ran out of ring
+    std::uint64_t freezes = 0; // ring full, queue frozen
+
+    ring(const std::string& interface, const endpoint& group, const std::uint32_t block_size, const std::uint32_t block_count) : group{group} {
+        const auto index = if_nametoindex(interface.c_str());
+        if (index == 0) {
+            throw std::runtime_error("Unknown interface " + interface);
+        }
+
+        socket = ::socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
+        if (socket < 0) {
+            throw std::runtime_error("Unable to open packet socket on " + interface + ": " + std::strerror(errno));
+        }
+
+        int version = TPACKET_V3;
+        if (setsockopt(socket, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) != 0) {
+            close();
+            throw std::runtime_error("Unable to select TPACKET_V3: " + std::string{std::strerror(errno)});
+        }
+
+        // blocks retire after 10 ms so a quiet feed still reaches the converter
+        request.tp_block_size = block_size;
+        request.tp_block_nr = block_count;
+        request.tp_frame_size = TPACKET_ALIGNMENT << 7;
+        request.tp_frame_nr = static_cast<unsigned int>((std::size_t{block_size} * block_count) / request.tp_frame_size);
+        request.tp_retire_blk_tov = 10;
+
+        if (setsockopt(socket, SOL_PACKET, PACKET_RX_RING, &request, sizeof(request)) != 0) {
+            close();
+            throw std::runtime_error("Unable to allocate packet ring: " + std::string{std::strerror(errno)});
+        }
+
+        map_size = std::size_t{block_size} * block_count;
+        const auto mapped = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, socket, 0);
+        if (mapped == MAP_FAILED) {
+            map = nullptr;
+            close();
+            throw std::runtime_error("Unable to map packet ring: " + std::string{std::strerror(errno)});
+        }
+        map = static_cast<u_char*>(mapped);
+
+        sockaddr_ll address{};
+        address.sll_family = AF_PACKET;
+        address.sll_protocol = htons(ETH_P_ALL);
+        address.sll_ifindex = static_cast<int>(index);
+
+        if (bind(socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            close();
+            throw std::runtime_error("Unable to bind packet socket to " + interface + ": " + std::strerror(errno));
+        }
+
+        // the packet socket sees the frames, the join only makes the switch send them
+        membership = ::socket(AF_INET, SOCK_DGRAM, 0);
+        ip_mreqn join{};
+        join.imr_multiaddr = group.address;
+        join.imr_ifindex = static_cast<int>(index);
+
+        if (membership < 0 || setsockopt(membership, IPPROTO_IP, IP_ADD_MEMBERSHIP, &join, sizeof(join)) != 0) {
+            close();
+            throw std::runtime_error("Unable to join multicast group on " + interface + ": " + std::strerror(errno));
+        }
+    }
+
+    ring(const ring&) = delete;
+    ring& operator=(const ring&) = delete;
+
+    ~ring() {
+        close();
+    }
+
+    void close() {
+        if (map != nullptr) {
+            munmap(map, map_size);
+            map = nullptr;
+        }
+        if (socket >= 0) {
+            ::close(socket);
+            socket = -1;
+        }
+        if (membership >= 0) {
+            ::close(membership);
+            membership = -1;
+        }
+    }
+
+    // udp to the group, parsed as in the converters
+    [[nodiscard]] bool accepts(const u_char* frame, const std::uint32_t length) const {
+        datagram datagram;
+        return read_datagram(frame, length, &datagram)
+            && datagram.header->ip_dst.s_addr == group.address.s_addr
+            && (group.port == 0 || ntohs(datagram.udp->uh_dport) == group.port);
+    }
+
+    // frames failing the filter are dropped by the kernel before they take ring space
+    void attach(const packet_filter& filter) {
+        sock_fprog program{static_cast<unsigned short>(filter.program.bf_len), reinterpret_cast<sock_filter*>(filter.program.bf_insns)};
+        if (setsockopt(socket, SOL_SOCKET, SO_ATTACH_FILTER, &program, sizeof(program)) != 0) {
+            throw std::runtime_error("Unable to attach packet filter " + filter.expression + ": " + std::strerror(errno));
+        }
+    }
+
+    // consume every group frame of the next retired block, false after waiting up to timeout milliseconds for one
+    template <typename consumer>
+    bool next(consumer&& consume, const int timeout) {
+        const auto descriptor = reinterpret_cast<tpacket_block_desc*>(map + std::size_t{block} * request.tp_block_size);
+        std::atomic_ref<std::uint32_t> status{descriptor->hdr.bh1.block_status};
+
+        if ((status.load(std::memory_order_acquire) & TP_STATUS_USER) == 0) {
+            pollfd readable{socket, POLLIN | POLLERR, 0};
+            ::poll(&readable, 1, timeout);
+            return false;
+        }
+
+        auto frame = reinterpret_cast<const tpacket3_hdr*>(reinterpret_cast<const u_char*>(descriptor) + descriptor->hdr.bh1.offset_to_first_pkt);
+
+        for (std::uint32_t index = 0; index < descriptor->hdr.bh1.num_pkts; ++index) {
+            const auto packet = reinterpret_cast<const u_char*>(frame) + frame->tp_mac;
+
+            if (accepts(packet, frame->tp_snaplen)) {
+                packet_header header;
+                header.timestamp = std::chrono::seconds{frame->tp_sec} + std::chrono::nanoseconds{frame->tp_nsec};
+                header.caplen = frame->tp_snaplen;
+                header.len = frame->tp_len;
+
+                consume(header, packet);
+                accepted += 1;
+            }
+
+            frame = reinterpret_cast<const tpacket3_hdr*>(reinterpret_cast<const u_char*>(frame) + frame->tp_next_offset);
+        }
+
+        packets += descriptor->hdr.bh1.num_pkts;
+
+        // frames are consumed, hand the block back
+        status.store(TP_STATUS_KERNEL, std::memory_order_release);
+        block = (block + 1) % request.tp_block_nr;
+
+        return true;
+    }
+
+    // kernel counters since the last call, returns new drops
+    std::uint64_t statistics() {
+        tpacket_stats_v3 counters{};
+        socklen_t length = sizeof(counters);
+
+        if (getsockopt(socket, SOL_PACKET, PACKET_STATISTICS, &counters, &length) != 0) {
+            return 0;
+        }
+
+        drops += counters.tp_drops;
+        freezes += counters.tp_freeze_q_cnt;
+
+        return counters.tp_drops;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////
+// run statistics
+///////////////////////////////////////////////////////////////////////
+
+// conversion stages: parse is framing and arbitration, append fills column batches, encode is parquet page encoding and compression, which parquet runs as one step
+enum class stage { parse, decode, append, encode, write, count };
+
+inline constexpr std::array<const char*, static_cast<std::size_t>(stage::count)> stage_names{"parse", "decode", "append", "encode", "write"};
+
+// packets of each sampled for parse, decode and append timings, two clock reads a message are too many to take on all of them
+constexpr std::uint64_t sample_interval = 64;
+
+// single writer counter, read by the progress thread while it runs
+struct counter {
+    std::atomic<std::uint64_t> value{0};
+
+    void add(const std::uint64_t amount) {
+        value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] std::uint64_t get() const {
+        return value.load(std::memory_order_relaxed);
+    }
+};
+
+// counters of one thread, on cache lines of their own
+struct alignas(64) thread_statistics {
+    counter packets;
+    counter bytes; // captured
+    counter non_udp; // packets without a udp payload
+    counter truncated; // packets whose messages run past the udp payload, and messages shorter than their type
+    counter unknown; // messages of a type the feed does not define
+    counter sampled; // packets timed stage by stage
+    counter bloom_bytes; // bloom filters in the parquet files closed
+    std::array<counter, 256> messages; // by message type
+    std::array<counter, static_cast<std::size_t>(stage::count)> nanoseconds;
+
+    void add(const stage stage, const std::uint64_t nanoseconds) {
+        this->nanoseconds[static_cast<std::size_t>(stage)].add(nanoseconds);
+    }
+
+    // encode and write time, nested inside every other stage
+    [[nodiscard]] std::uint64_t output() const {
+        return nanoseconds[static_cast<std::size_t>(stage::encode)].get() + nanoseconds[static_cast<std::size_t>(stage::write)].get();
+    }
+};
+
+// run totals, sampled stages scaled up to every packet of their thread
+struct totals {
+    std::uint64_t threads = 0;
+    std::uint64_t packets = 0;
+    std::uint64_t bytes = 0;
+    std::uint64_t non_udp = 0;
+    std::uint64_t truncated = 0;
+    std::uint64_t unknown = 0;
+    std::uint64_t bloom_bytes = 0;
+    std::uint64_t messages = 0;
+    std::array<std::uint64_t, 256> types{};
+    std::array<double, static_cast<std::size_t>(stage::count)> seconds{};
+};
+
+// counters of every thread that took part in the run, kept after the thread exits
+struct statistics {
+
+    std::mutex mutex;
+    std::deque<thread_statistics> threads;
+
+    static statistics& instance() {
+        static statistics all;
+        return all;
+    }
+
+    // counters of the calling thread
+    static thread_statistics& local() {
+        thread_local thread_statistics* counters = nullptr;
+
+        if (counters == nullptr) {
+            auto& all = instance();
+            std::lock_guard lock{all.mutex};
+            counters = &all.threads.emplace_back();
+        }
+
+        return *counters;
+    }
+
+    totals sum() {
+        std::lock_guard lock{mutex};
+        totals totals;
+
+        for (const auto& thread : threads) {
+            const auto packets = thread.packets.get();
+            const auto sampled = thread.sampled.get();
+
+            totals.threads += 1;
+            totals.packets += packets;
+            totals.bytes += thread.bytes.get();
+            totals.non_udp += thread.non_udp.get();
+            totals.truncated += thread.truncated.get();
+            totals.unknown += thread.unknown.get();
+            totals.bloom_bytes += thread.bloom_bytes.get();
+
+            for (std::size_t type = 0; type < thread.messages.size(); ++type) {
+                totals.types[type] += thread.messages[type].get();
+                totals.messages += thread.messages[type].get();
+            }
+
+            for (std::size_t index = 0; index < totals.seconds.size(); ++index) {
+                auto seconds = static_cast<double>(thread.nanoseconds[index].get()) / 1e9;
+                if (index <= static_cast<std::size_t>(stage::append) && sampled > 0) {
+                    seconds *= static_cast<double>(packets) / static_cast<double>(sampled);
+                }
+                totals.seconds[index] += seconds;
+            }
+        }
+
+        return totals;
+    }
+};
+
+// adds the time until destruction to a stage of the calling thread, less the encode and write time nested inside
+struct timed_stage {
+    thread_statistics& counters;
+    stage measured;
+    std::chrono::steady_clock::time_point start;
+    std::uint64_t nested;
+
+    explicit timed_stage(const stage measured)
+        : counters{statistics::local()}
+        , measured{measured}
+        , start{std::chrono::steady_clock::now()}
+        , nested{counters.output()} {}
+
+    timed_stage(const timed_stage&) = delete;
+    timed_stage& operator=(const timed_stage&) = delete;
+
+    ~timed_stage() {
+        const auto elapsed = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        counters.add(measured, elapsed - std::min(elapsed, counters.output() - nested));
+    }
+};
+
+// stage laps of a sampled packet, inert on every other packet
+struct stopwatch {
+    thread_statistics* counters = nullptr;
+    std::chrono::steady_clock::time_point mark;
+    std::uint64_t nested = 0;
+
+    explicit stopwatch(thread_statistics* statistics) {
+        if (statistics->packets.get() % sample_interval == 0) {
+            counters = statistics;
+            counters->sampled.add(1);
+            mark = std::chrono::steady_clock::now();
+            nested = counters->output();
+        }
+    }
+
+    void lap(const stage stage) {
+        if (counters == nullptr) {
+            return;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        const auto output = counters->output();
+        const auto elapsed = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - mark).count());
+
+        counters->add(stage, elapsed - std::min(elapsed, output - nested));
+        mark = now;
+        nested = output;
+    }
+};
+
+// parquet file output with its writes timed as the write stage
+struct timed_output : arrow::io::OutputStream {
+
+    std::shared_ptr<arrow::io::OutputStream> file;
+
+    explicit timed_output(std::shared_ptr<arrow::io::OutputStream> file) : file{std::move(file)} {}
+
+    using arrow::io::OutputStream::Write;
+
+    arrow::Status Write(const void* data, const std::int64_t length) override {
+        timed_stage timer{stage::write};
+        return file->Write(data, length);
+    }
+
+    arrow::Status Flush() override {
+        timed_stage timer{stage::write};
+        return file->Flush();
+    }
+
+    arrow::Status Close() override {
+        timed_stage timer{stage::write};
+        return file->Close();
+    }
+
+    [[nodiscard]] arrow::Result<std::int64_t> Tell() const override {
+        return file->Tell();
+    }
+
+    [[nodiscard]] bool closed() const override {
+        return file->closed();
+    }
+};
+
+// one line of counters so far, ie for a periodic progress report
+inline void report_progress(std::ostream& out, const totals& totals, const double seconds) {
+    out << std::fixed << std::setprecision(1)
+        << "progress: " << seconds << " s, " << totals.packets << " packets, " << totals.messages << " messages ("
+        << static_cast<double>(totals.messages) / std::max(seconds, 1e-9) / 1e6 << " M/s), "
+        << static_cast<double>(totals.bytes) / 1e6 << " MB (" << static_cast<double>(totals.bytes) / std::max(seconds, 1e-9) / 1e6 << " MB/s), "
+        << totals.non_udp << " non udp, " << totals.truncated << " truncated, " << totals.unknown << " unknown" << std::defaultfloat << std::endl;
+}
+
+// progress line every interval until destroyed, nothing when the interval is zero
+struct progress {
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::mutex mutex;
+    std::condition_variable stopped;
+    bool done = false;
+    std::thread thread;
+
+    explicit progress(const std::uint32_t seconds) {
+        if (seconds > 0) {
+            thread = std::thread{[this, seconds] { run(std::chrono::seconds{seconds}); }};
+        }
+    }
+
+    progress(const progress&) = delete;
+    progress& operator=(const progress&) = delete;
+
+    ~progress() {
+        {
+            std::lock_guard lock{mutex};
+            done = true;
+        }
+        stopped.notify_all();
+
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+    void run(const std::chrono::seconds interval) {
+        std::unique_lock lock{mutex};
+
+        while (!stopped.wait_for(lock, interval, [this] { return done; })) {
+            report_progress(std::cerr, statistics::instance().sum(), std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+    }
+};
+
+// machine readable end of run report, stage seconds are summed over threads
+inline void report_statistics(std::ostream& out, const totals& totals, const double seconds) {
+    const auto rate = [seconds](const std::uint64_t value) { return static_cast<double>(value) / std::max(seconds, 1e-9); };
+
+    double staged = 0;
+    for (const auto stage_seconds : totals.seconds) {
+        staged += stage_seconds;
+    }
+
+    out << std::fixed << std::setprecision(6)
+        << "{\"seconds\": " << seconds
+        << ", \"threads\": " << totals.threads
+        << ", \"packets\": " << totals.packets
+        << ", \"bytes\": " << totals.bytes
+        << ", \"messages\": " << totals.messages
+        << ", \"non_udp_packets\": " << totals.non_udp
+        << ", \"truncated_packets\": " << totals.truncated
+        << ", \"unknown_messages\": " << totals.unknown
+        << ", \"bloom_filter_bytes\": " << totals.bloom_bytes
+        << ", \"packets_per_second\": " << rate(totals.packets)
+        << ", \"messages_per_second\": " << rate(totals.messages)
+        << ", \"megabytes_per_second\": " << rate(totals.bytes) / 1e6
+        << ", \"message_types\": {";
+
+    auto first = true;
+    for (std::size_t type = 0; type < totals.types.size(); ++type) {
+        if (totals.types[type] == 0) {
+            continue;
+        }
+
+        const auto name = feed::all_messages::name_of(static_cast<char>(type));
+        out << (first ? "" : ", ") << "\"" << (name != nullptr ? std::string{name} : "unknown_" + std::to_string(type)) << "\": " << totals.types[type];
+        first = false;
+    }
+
+    out << "}, \"stages\": {";
+
+    for (std::size_t index = 0; index < totals.seconds.size(); ++index) {
+        out << (index == 0 ? "" : ", ") << "\"" << stage_names[index] << "\": {\"seconds\": " << totals.seconds[index]
+            << ", \"share\": " << (staged > 0 ? totals.seconds[index] / staged : 0.0) << "}";
+    }
+
+    out << "}}" << std::defaultfloat << std::endl;
+}
+
+// end of run report to a file, - for stderr
+inline void write_statistics(const std::string& path, const double seconds) {
+    const auto totals = statistics::instance().sum();
+
+    if (path == "-") {
+        report_statistics(std::cerr, totals, seconds);
+        return;
+    }
+
+    std::ofstream out{path};
+    if (!out) {
+        throw std::runtime_error("Unable to create file " + path);
+    }
+    report_statistics(out, totals, seconds);
+}
+
+///////////////////////////////////////////////////////////////////////
+// encoder pipeline
+///////////////////////////////////////////////////////////////////////
+
+// keeps producer and consumer indexes on separate lines
+constexpr std::size_t cache_line_size = 64;
+
+// bounded lock free single producer single consumer queue
+template <typename type>
+struct spsc_queue {
+
+    explicit spsc_queue(const std::size_t capacity)
+        : slots(std::bit_ceil(capacity + 1))
+        , mask{slots.size() - 1} {}
+
+    [[nodiscard]] bool try_push(const type& value) {
+        const auto head = this->head.load(std::memory_order_relaxed);
+        const auto next = (head + 1) & mask;
+
+        if (next == tail_cache) {
+            tail_cache = tail.load(std::memory_order_acquire);
+            if (next == tail_cache) {
+                return false;
+            }
+        }
+
+        slots[head] = value;
+        this->head.store(next, std::memory_order_release);
+
+        return true;
+    }
+
+    [[nodiscard]] bool try_pop(type& value) {
+        const auto tail = this->tail.load(std::memory_order_relaxed);
+
+        if (tail == head_cache) {
+            head_cache = head.load(std::memory_order_acquire);
+            if (tail == head_cache) {
+                return false;
+            }
+        }
+
+        value = slots[tail];
+        this->tail.store((tail + 1) & mask, std::memory_order_release);
+
+        return true;
+    }
+
+    // producer side
+    alignas(cache_line_size) std::atomic<std::size_t> head{0};
+    std::size_t tail_cache = 0;
+
+    // consumer side
+    alignas(cache_line_size) std::atomic<std::size_t> tail{0};
+    std::size_t head_cache = 0;
+
+    alignas(cache_line_size) std::vector<type> slots;
+    std::size_t mask;
+};
+
+// time one side of the pipeline spent waiting on the other
+struct stall {
+    std::uint64_t count = 0;
+    std::chrono::nanoseconds time{0};
+};
+
+inline std::ostream& operator<<(std::ostream& out, const stall& stall) {
+    return out << stall.count << " (" << std::chrono::duration_cast<std::chrono::milliseconds>(stall.time).count() << " ms)";
+}
+
+// yield, then sleep until ready
+template <typename predicate>
+void wait_until(predicate&& ready, stall& stall) {
+    if (ready()) {
+        return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (std::uint32_t spins = 0; !ready(); ++spins) {
+        if (spins < 128) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds{20});
+        }
+    }
+
+    stall.count += 1;
+    stall.time += std::chrono::steady_clock::now() - start;
+}
+
+// sealed batch handed to an encoder, a null encode stops the thread
+struct encode_task {
+    void (*encode)(void* writer, void* rows) = nullptr;
+    void (*release)(void* writer, void* rows) = nullptr; // hands the batch back unwritten once the encoder has failed
+    void* writer = nullptr;
+    void* rows = nullptr;
+};
+
+// encoder thread, owns writing of the parquet files assigned to it
+struct encoder {
+
+    spsc_queue<encode_task> queue;
+    std::exception_ptr error;
+    std::atomic<bool> failed{false}; // error is set, read by the decoder
+    stall idle; // waiting for the decoder
+    std::uint64_t batches = 0;
+    std::thread thread;
+
+    explicit encoder(const std::size_t queue_depth)
+        : queue{queue_depth}
+        , thread{[this] { run(); }} {}
+
+    void run() {
+        encode_task task;
+
+        while (true) {
+            wait_until([&] { return queue.try_pop(task); }, idle);
+
+            if (task.encode == nullptr) {
+                return;
+            }
+
+            // keep draining after a failure and hand every batch back, so the decoder never blocks
+            if (error) {
+                if (task.release != nullptr) {
+                    task.release(task.writer, task.rows);
+                }
+                continue;
+            }
+
+            try {
+                task.encode(task.writer, task.rows);
+                batches += 1;
+            }
+            catch (...) {
+                error = std::current_exception();
+                failed.store(true, std::memory_order_release);
+            }
+        }
+    }
+};
+
+// decoder thread hands full batches to encoder threads
+struct pipeline {
+
+    std::vector<std::unique_ptr<encoder>> encoders;
+    std::size_t queue_depth;
+    std::size_t assigned = 0;
+    stall full; // encoder queue full
+    stall starved; // no written batch to refill
+
+    pipeline(const std::size_t queue_depth, const std::size_t encoder_threads)
+        : queue_depth{std::max<std::size_t>(queue_depth, 1)} {
+        for (std::size_t index = 0; index < std::max<std::size_t>(encoder_threads, 1); ++index) {
+            encoders.push_back(std::make_unique<encoder>(this->queue_depth));
+        }
+    }
+
+    pipeline(const pipeline&) = delete;
+    pipeline& operator=(const pipeline&) = delete;
+
+    ~pipeline() {
+        stop();
+    }
+
+    // each parquet file is written by a single encoder, round robin
+    encoder* assign() {
+        return encoders[assigned++ % encoders.size()].get();
+    }
+
+    // rethrows the failure of the encoder instead of queueing behind it
+    void push(encoder* encoder, const encode_task& task) {
+        bool pushed = false;
+        wait_until([&] { return encoder->failed.load(std::memory_order_acquire) || (pushed = encoder->queue.try_push(task)); }, full);
+
+        if (!pushed) {
+            std::rethrow_exception(encoder->error);
+        }
+    }
+
+    // drain queues and join threads, rethrows the first encoder failure
+    void finish() {
+        stop();
+
+        for (const auto& encoder : encoders) {
+            if (encoder->error) {
+                std::rethrow_exception(encoder->error);
+            }
+        }
+    }
+
+    void stop() {
+        for (const auto& encoder : encoders) {
+            // a failed encoder still drains its queue, so the stop task always goes in
+            if (encoder->thread.joinable()) {
+                wait_until([&] { return encoder->queue.try_push(encode_task{}); }, full);
+                encoder->thread.join();
+            }
+        }
+    }
+
+    void report(std::ostream& out) const {
+        std::uint64_t batches = 0;
+        for (const auto& encoder : encoders) {
+            batches += encoder->batches;
+        }
+
+        out << "pipeline: " << batches << " batches, " << encoders.size() << " encoders" << std::endl;
+        out << "  decoder stalls, queue full: " << full << ", waiting for batch: " << starved << std::endl;
+
+        for (std::size_t index = 0; index < encoders.size(); ++index) {
+            out << "  encoder " << index << " stalls, queue empty: " << encoders[index]->idle << std::endl;
+        }
+    }
+};
+
+///////////////////////////////////////////////////////////////////////
+// output files
+///////////////////////////////////////////////////////////////////////
+
+// how output files are written, set from the options before the first file opens
+struct output_settings {
+    std::size_t buffer_bytes = 0; // write buffer of each local file, written in the background once full, zero writes on the encoding thread
+    std::size_t buffers = 4; // per file, filling waits once every other buffer is still being written
+    bool direct = false; // O_DIRECT, whole buffers bypass the page cache
+    std::size_t threads = 2; // writer threads shared by every file
+};
+
+inline output_settings file_output;
+
+// object store uri instead of a local path, ie s3://bucket/itch.parquet
+inline bool remote(const std::string_view path) {
+    return path.find("://") != std::string_view::npos;
+}
+
+// O_DIRECT memory, file offsets and lengths are multiples of it
+constexpr std::size_t direct_alignment = 4096;
+
+// every byte or errno of the first failure
+inline int write_at(const int descriptor, const std::byte* data, const std::size_t size, const std::uint64_t offset) {
+    for (std::size_t written = 0; written < size;) {
+        const auto result = ::pwrite(descriptor, data + written, size - written, static_cast<off_t>(offset + written));
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno;
+        }
+        written += static_cast<std::size_t>(result);
+    }
+    return 0;
+}
+
+// full buffer handed to a writer thread, a null write stops the thread
+struct write_job {
+    void (*write)(void* file, std::size_t buffer) = nullptr;
+    void* file = nullptr;
+    std::size_t buffer = 0;
+};
+
+// writer threads of every buffered file, buffers carry their file offset so they complete in any order
+struct output_writer {
+
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<write_job> jobs;
+    std::vector<std::thread> threads;
+
+    explicit output_writer(const std::size_t count) {
+        for (std::size_t index = 0; index < count; ++index) {
+            threads.emplace_back([this] { run(); });
+        }
+    }
+
+    output_writer(const output_writer&) = delete;
+    output_writer& operator=(const output_writer&) = delete;
+
+    ~output_writer() {
+        for (std::size_t index = 0; index < threads.size(); ++index) {
+            push(write_job{});
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    // started with the first buffered file
+    static output_writer& shared() {
+        static output_writer writer{std::max<std::size_t>(file_output.threads, 1)};
+        return writer;
+    }
+
+    void push(const write_job& job) {
+        {
+            std::lock_guard lock{mutex};
+            jobs.push_back(job);
+        }
+        ready.notify_one();
+    }
+
+    void run() {
+        while (true) {
+            write_job job;
+            {
+                std::unique_lock lock{mutex};
+                ready.wait(lock, [&] { return !jobs.empty(); });
+                job = jobs.front();
+                jobs.pop_front();
+            }
+
+            if (job.write == nullptr) {
+                return;
+            }
+
+            job.write(job.file, job.buffer);
+        }
+    }
+};
+
+// local file filled through large aligned buffers written by the shared writer threads, encoding continues while earlier buffers reach the disk
+struct buffered_output : arrow::io::OutputStream {
+
+    struct release {
+        void operator()(std::byte* memory) const {
+            std::free(memory);
+        }
+    };
+
+    struct buffer {
+        std::unique_ptr<std::byte, release> data;
+        std::size_t size = 0;
+        std::uint64_t offset = 0; // of its first byte in the file
+    };
+
+    std::string path;
+    bool direct;
+    std::size_t capacity; // bytes of each buffer
+    std::vector<buffer> buffers;
+    std::size_t current = 0; // buffer being filled
+    std::uint64_t position = 0; // bytes written to the stream
+    int descriptor = -1;
+
+    // shared with the writer threads
+    std::mutex mutex;
+    std::condition_variable done;
+    std::vector<std::size_t> free; // buffers ready to fill
+    std::size_t pending = 0; // buffers being written
+    int error = 0; // errno of the first failed write
+
+    buffered_output(const std::string& path, const output_settings& settings)
+        : path{path}
+        , direct{settings.direct}
+        , capacity{(std::max<std::size_t>(settings.buffer_bytes, 1) + direct_alignment - 1) / direct_alignment * direct_alignment}
+        , buffers(std::max<std::size_t>(settings.buffers, 2)) {
+        for (std::size_t index = 0; index < buffers.size(); ++index) {
+            buffers[index].data.reset(static_cast<std::byte*>(std::aligned_alloc(direct_alignment, capacity)));
+            if (!buffers[index].data) {
+                throw std::bad_alloc();
+            }
+            if (index != current) {
+                free.push_back(index);
+            }
+        }
+
+        descriptor = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC | (direct ? O_DIRECT : 0), 0644);
+
+        // file systems without direct io, ie tmpfs, write through the page cache
+        if (descriptor < 0 && direct && errno == EINVAL) {
+            direct = false;
+            descriptor = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        }
+
+        if (descriptor < 0) {
+            throw std::runtime_error("Unable to open " + path + ": " + std::strerror(errno));
+        }
+    }
+
+    buffered_output(const buffered_output&) = delete;
+    buffered_output& operator=(const buffered_output&) = delete;
+
+    ~buffered_output() override {
+        (void)Close();
+    }
+
+    using arrow::io::OutputStream::Write;
+
+    arrow::Status Write(const void* data, const std::int64_t length) override {
+        auto bytes = static_cast<const std::byte*>(data);
+        auto remaining = static_cast<std::size_t>(length);
+
+        while (remaining > 0) {
+            auto& filling = buffers[current];
+            const auto copied = std::min(remaining, capacity - filling.size);
+
+            std::memcpy(filling.data.get() + filling.size, bytes, copied);
+            filling.size += copied;
+            position += copied;
+            bytes += copied;
+            remaining -= copied;
+
+            if (filling.size == capacity) {
+                submit(capacity);
+            }
+        }
+
+        return status();
+    }
+
+    // written through the last whole block, a direct file keeps its unaligned tail buffered until close
+    arrow::Status Flush() override {
+        const auto size = buffers[current].size;
+        const auto whole = direct ? size / direct_alignment * direct_alignment : size;
+
+        if (whole > 0) {
+            submit(whole);
+        }
+
+        drain();
+        return status();
+    }
+
+    arrow::Status Close() override {
+        if (descriptor < 0) {
+            return arrow::Status::OK();
+        }
+
+        auto closed = Flush();
+
+        // the tail is not block sized, it goes through the page cache
+        const auto& tail = buffers[current];
+        if (closed.ok() && tail.size > 0) {
+            ::fcntl(descriptor, F_SETFL, ::fcntl(descriptor, F_GETFL) & ~O_DIRECT);
+            if (const auto failed = write_at(descriptor, tail.data.get(), tail.size, tail.offset); failed != 0) {
+                closed = arrow::Status::IOError("Unable to write ", path, ": ", std::strerror(failed));
+            }
+        }
+
+        if (::close(descriptor) != 0 && closed.ok()) {
+            closed = arrow::Status::IOError("Unable to close ", path, ": ", std::strerror(errno));
+        }
+        descriptor = -1;
+
+        return closed;
+    }
+
+    [[nodiscard]] arrow::Result<std::int64_t> Tell() const override {
+        return static_cast<std::int64_t>(position);
+    }
+
+    [[nodiscard]] bool closed() const override {
+        return descriptor < 0;
+    }
+
+    // hand the first bytes of the filling buffer to a writer thread, the rest starts the next buffer
+    void submit(const std::size_t bytes) {
+        std::size_t next;
+        {
+            std::unique_lock lock{mutex};
+            done.wait(lock, [&] { return !free.empty(); });
+            next = free.back();
+            free.pop_back();
+            pending += 1;
+        }
+
+        auto& filled = buffers[current];
+        auto& following = buffers[next];
+        following.size = filled.size - bytes;
+        following.offset = filled.offset + bytes;
+        std::memcpy(following.data.get(), filled.data.get() + bytes, following.size);
+        filled.size = bytes;
+
+        output_writer::shared().push(write_job{&write, this, current});
+        current = next;
+    }
+
+    // writer thread side
+    static void write(void* file, const std::size_t index) {
+        auto& output = *static_cast<buffered_output*>(file);
+        const auto& written = output.buffers[index];
+        const auto failed = write_at(output.descriptor, written.data.get(), written.size, written.offset);
+
+        // notified under the lock, a drained file may be destroyed as soon as it is released
+        std::lock_guard lock{output.mutex};
+        if (failed != 0 && output.error == 0) {
+            output.error = failed;
+        }
+        output.free.push_back(index);
+        output.pending -= 1;
+        output.done.notify_all();
+    }
+
+    void drain() {
+        std::unique_lock lock{mutex};
+        done.wait(lock, [&] { return pending == 0; });
+    }
+
+    [[nodiscard]] arrow::Status status() {
+        std::lock_guard lock{mutex};
+        if (error != 0) {
+            return arrow::Status::IOError("Unable to write ", path, ": ", std::strerror(error));
+        }
+        return arrow::Status::OK();
+    }
+};
+
+///////////////////////////////////////////////////////////////////////
+// checkpoints
+///////////////////////////////////////////////////////////////////////
+
+// fsync of a file or directory, so what was written or renamed survives a crash
+inline void sync_path(const std::filesystem::path& path) {
+    const auto descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (descriptor < 0) {
+        throw std::runtime_error("Unable to open " + path.string() + " to sync: " + std::strerror(errno));
+    }
+
+    const auto result = ::fsync(descriptor);
+    const auto error = errno;
+    ::close(descriptor);
+
+    if (result != 0) {
+        throw std::runtime_error("Unable to sync " + path.string() + ": " + std::strerror(error));
+    }
+}
+
+// directory holding a file, where its rename is recorded
+inline std::filesystem::path parent_of(const std::filesystem::path& path) {
+    return path.has_parent_path() ? path.parent_path() : std::filesystem::path{"."};
+}
+
+// temporary synced, renamed over path and the rename synced, a crash leaves the old or the new file whole
+inline void durable_rename(const std::filesystem::path& temporary, const std::filesystem::path& path) {
+    sync_path(temporary);
+    std::filesystem::rename(temporary, path);
+    sync_path(parent_of(path));
+}
+
+// last write time, tells a capture rewritten in place at the same size apart
+inline std::int64_t modified_time(const std::string& path) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::filesystem::last_write_time(path).time_since_epoch()).count();
+}
+
+// conversion progress saved each time a part file closes, a restart resumes after the last closed part and later captures continue the part numbering
+//   converted 123456 itch.20240105.pcap
+//   modified 1704499200000000000
+//   parts 12
+//   open 654321 itch.20240108.pcap
+//   modified 1704758400000000000
+//   offset 1073741824
+//   swapped 0
+//   resolution 1000000000
+//   pcap_index 2417722
+// directory, live orders, lines and event clock go to a state file beside it, see state_file
+struct checkpoint {
+
+    // capture file, told apart by path, size and last write time
+    struct source {
+        std::string path;
+        std::uint64_t size = 0;
+        std::int64_t modified = 0;
+
+        bool operator==(const source&) const = default;
+    };
+
+    std::vector<source> converted; // finished captures
+    std::size_t parts = 0; // closed part files, numbers the next
+    std::optional<source> open; // capture in progress
+    capture::cursor position; // first packet after the closed parts
+    std::uint64_t pcap_index = 0; // packets before it
+
+    [[nodiscard]] bool done(const source& capture) const {
+        return std::find(converted.begin(), converted.end(), capture) != converted.end();
+    }
+
+    [[nodiscard]] bool resumes(const source& capture) const {
+        return open && *open == capture;
+    }
+
+    // nothing converted yet when the file does not exist
+    static checkpoint load(const std::string& path) {
+        checkpoint saved;
+
+        std::ifstream in{path};
+        if (!in) {
+            return saved;
+        }
+
+        source* last = nullptr; // modified follows the capture it belongs to
+
+        std::string line;
+        while (std::getline(in, line)) {
+            const auto space = line.find(' ');
+            if (space == std::string::npos) {
+                continue;
+            }
+
+            const auto key = line.substr(0, space);
+            const auto value = line.substr(space + 1);
+
+            // number then the rest of the line, paths and session names may hold spaces
+            const auto pair = [&] {
+                const auto split = value.find(' ');
+                if (split == std::string::npos) {
+                    throw std::runtime_error("Corrupt checkpoint " + path + ": " + line);
+                }
+                return std::pair{std::stoull(value.substr(0, split)), value.substr(split + 1)};
+            };
+
+            if (key == "converted") {
+                const auto [size, file] = pair();
+                last = &saved.converted.emplace_back(source{file, size});
+            }
+            else if (key == "parts") {
+                saved.parts = std::stoul(value);
+            }
+            else if (key == "open") {
+                const auto [size, file] = pair();
+                last = &saved.open.emplace(source{file, size});
+            }
+            else if (key == "modified" && last != nullptr) {
+                last->modified = std::stoll(value);
+            }
+            else if (key == "offset") {
+                saved.position.offset = std::stoull(value);
+            }
+            else if (key == "swapped") {
+                saved.position.swapped = value == "1";
+            }
+            else if (key == "resolution") {
+                saved.position.resolutions.push_back(std::stoull(value));
+            }
+            else if (key == "pcap_index") {
+                saved.pcap_index = std::stoull(value);
+            }
+        }
+
+        return saved;
+    }
+
+    // replaced whole by a synced rename, a crash leaves the previous checkpoint
+    void save(const std::string& path) const {
+        const auto temporary = path + ".tmp";
+        {
+            std::ofstream out{temporary, std::ios::trunc};
+
+            for (const auto& capture : converted) {
+                out << "converted " << capture.size << ' ' << capture.path << '\n';
+                out << "modified " << capture.modified << '\n';
+            }
+            out << "parts " << parts << '\n';
+
+            if (open) {
+                out << "open " << open->size << ' ' << open->path << '\n';
+                out << "modified " << open->modified << '\n';
+                out << "offset " << position.offset << '\n';
+                out << "swapped " << (position.swapped ? 1 : 0) << '\n';
+                for (const auto resolution : position.resolutions) {
+                    out << "resolution " << resolution << '\n';
+                }
+                out << "pcap_index " << pcap_index << '\n';
+            }
+
+            if (!out.flush()) {
+                throw std::runtime_error("Unable to write checkpoint " + temporary);
+            }
+        }
+        durable_rename(temporary, path);
+    }
+};
+
+// converter state written raw, the header records the layout of every raw type so a build laying them out differently rejects the file
+struct snapshot {
+
+    static constexpr std::array<char, 8> magic{'i', 't', 'c', 'h', 's', 't', 'a', '2'};
+
+    // bumped whenever a type written raw changes without changing its size or alignment
+    static constexpr std::uint32_t version = 2;
+
+    // layout version, then the size and alignment of each type
+    template <typename... types>
+    static constexpr auto layout() {
+        return std::array<std::uint32_t, 1 + 2 * sizeof...(types)>{version, static_cast<std::uint32_t>(sizeof(types))..., static_cast<std::uint32_t>(alignof(types))...};
+    }
+
+    template <typename value>
+    static void write(std::ostream& out, const value& data) {
+        static_assert(std::is_trivially_copyable_v<value>);
+        out.write(reinterpret_cast<const char*>(&data), sizeof(value));
+    }
+
+    template <typename value>
+    static void write(std::ostream& out, const std::vector<value>& data) {
+        static_assert(std::is_trivially_copyable_v<value>);
+        write(out, data.size());
+        out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size() * sizeof(value)));
+    }
+
+    template <typename value>
+    static void read(std::istream& in, value& data) {
+        static_assert(std::is_trivially_copyable_v<value>);
+        in.read(reinterpret_cast<char*>(&data), sizeof(value));
+    }
+
+    // bytes left to read, counts from disk are bounded by it before anything is allocated
+    static std::uint64_t remaining(std::istream& in) {
+        const auto here = in.tellg();
+        in.seekg(0, std::ios::end);
+        const auto end = in.tellg();
+        in.seekg(here);
+        return here < 0 || end < here ? 0 : static_cast<std::uint64_t>(end - here);
+    }
+
+    template <typename value>
+    static void read(std::istream& in, std::vector<value>& data) {
+        static_assert(std::is_trivially_copyable_v<value>);
+        std::size_t count = 0;
+        read(in, count);
+
+        if (!in || count > remaining(in) / sizeof(value)) {
+            in.setstate(std::ios::failbit);
+            data.clear();
+            return;
+        }
+
+        data.resize(count);
+        in.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size() * sizeof(value)));
+    }
+};
+
+///////////////////////////////////////////////////////////////////////
+// itch converter
+///////////////////////////////////////////////////////////////////////
+
+// parquet options
+struct options {
+    std::string pcap_file = "itch.pcap";
+    std::string format = "auto"; // pcap, moldudp64 or binaryfile, auto detects pcap and pcapng
+    std::string parquet_file = "itch.parquet";
+    std::int64_t row_group_bytes = std::int64_t{128} << 20; // encoded bytes per row group
+    std::int64_t memory_budget = std::int64_t{1} << 30; // buffered row group bytes across open files and dataset partition rows, row groups close early above it, one budget for every demuxed channel
+    std::int64_t page_bytes = 0; // data page size, zero keeps the profile default
+    std::size_t batch_size = 0; // rows buffered per column flush, zero for 4096, every conversion writes column batches since the per row parquet::StreamWriter path was removed
+    std::string write_types; // message types converted, ie AFECP, empty converts every type
+    std::vector<std::string> write_columns; // wide table columns written, empty writes every column
+    bool mmap = false; // read the capture through a memory mapping instead of libpcap
+    std::string filter; // bpf expression, ie "udp and dst net 233.54.12.0/24", other packets are dropped before parsing
+    std::string demux; // channel or session, each channel of the capture converts into files of its own
+    std::size_t write_buffer_bytes = 0; // background write buffer per output file, zero writes on the encoding thread
+    std::size_t write_buffers = 4; // write buffers per output file
+    bool direct_io = false; // O_DIRECT output files, implies 8 MiB write buffers
+    std::size_t writer_threads = 2; // background writer threads shared by the output files
+    std::string stats_file; // json run report at the end, - for stderr, also prints the writer and arbiter summaries
+    std::string arrow_file; // arrow ipc stream of the wide rows, written without parquet encoding
+    std::string feather_file; // the same rows as an arrow ipc file, ie feather v2
+    std::string shm_name; // shared memory ring of arrow record batches, ie itch for /dev/shm/itch
+    std::uint64_t shm_slots = 16; // record batches a ring reader can fall behind by
+    std::uint64_t shm_slot_bytes = 16u << 20; // encoded record batch capacity of a ring slot
+    std::uint32_t arrow_flush_ms = 100; // longest a decoded row waits in a partial arrow batch with --live, zero waits for full batches
+    std::uint32_t progress_seconds = 0; // progress line interval, zero for none
+    std::size_t decompression_threads = 4; // zstd captures of many small frames, gzip and single frame zstd use one
+    bool wide = true; // wide record table
+    bool narrow = false; // one table per message type
+    bool orders = false; // track live orders to enrich executions, cancels and replaces
+    bool arbitrate = true; // drop the copy of each message already seen on the other line
+    std::int64_t gap_window_ms = 1000; // capture time the other line has to fill a sequence gap
+    std::size_t encoder_threads = 0; // parquet encoding threads, zero encodes on the decoding thread, demuxed channels share them
+    std::size_t queue_depth = 8; // batches in flight per encoder
+    std::size_t threads = 1; // parallel chunks of the capture, one numbered part file each, with orders a serial priming pass over every order message bounds the speedup
+    std::string checkpoint_file; // resumable progress, saved each time a part file closes, numbered part files only so not with --dataset
+    std::uint64_t checkpoint_bytes = std::uint64_t{1} << 30; // captured bytes per part file of a checkpointed run
+    std::size_t shards = 0; // wide table split by instrument into this many files and writer workers, demuxed channels share the workers
+    std::string dataset; // hive partitioned dataset root instead of one wide file
+    std::string partitioning{feed::default_partitioning}; // partition columns of the dataset, in directory order
+    std::uint64_t partition_buckets = 16; // instrument buckets of the dataset
+    std::size_t partition_files = 0; // open dataset files, the least recently written closes above it, zero keeps a file open per partition up to half the descriptor limit
+    std::string interface; // live capture instead of reading pcap_file
+    std::string group; // multicast group and port, ie 233.54.12.111:26477
+    std::uint32_t ring_block_size = 4u << 20; // packet ring block, retired to the converter whole
+    std::uint32_t ring_blocks = 64;
+    std::int64_t roll_seconds = 3600; // live file duration, zero disables
+    std::uint64_t roll_bytes = 0; // captured bytes per live file, zero disables
+    std::string profile = "default"; // writer property preset
+    bool page_index = true; // column and offset indexes on every column, lets readers skip pages
+    bool default_lookups = true; // bloom filters on the lookup fields
+    std::vector<std::string> lookups; // more bloom filtered columns
+    std::int32_t bloom_ndv = 1 << 20; // most distinct values per row group a filter is sized for, fewer when row groups hold fewer rows
+    double bloom_fpp = 0.01; // false positive probability at that many values
+    std::vector<std::pair<std::string, std::string>> columns; // per column overrides, ie price=byte_stream_split,zstd
+    bool read_only = false; // query existing wide parquet files instead of converting
+    std::string export_format; // csv, json or text, matching rows are written out instead of printed as record batches
+    std::string export_file = "-"; // export destination, - for stdout
+    std::size_t export_threads = 4; // row groups formatted at once
+    std::vector<std::string> select; // projected columns, empty reads every column
+    std::string message_types; // any of, ie PQ
+    std::string symbol; // directory symbol, set on every row of a listed instrument
+    std::optional<std::uint64_t> instrument; // the feed's instrument_field, ie stock locate or orderbook id
+    std::uint64_t from = 0; // range of the feed's time_field, parsed by its time_filter
+    std::uint64_t to = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t first_order = 0; // range of the feed's order_field
+    std::uint64_t last_order = std::numeric_limits<std::uint64_t>::max();
+    std::optional<std::uint64_t> match_number;
+};
+
+// rows buffered per column flush when batching is implied
+constexpr std::size_t default_batch_size = 4096;
+
+// local file, or an object store uri streamed as a multipart upload while it is written, ie s3://bucket/itch.parquet?region=us-east-1
+// object store filesystems, one per scheme and bucket so every output file shares its client
+struct object_stores {
+
+    std::mutex mutex;
+    std::unordered_map<std::string, std::shared_ptr<arrow::fs::FileSystem>> filesystems;
+    bool s3 = false; // an s3 client was made, finalized once before exit
+
+    static object_stores& instance() {
+        static object_stores all;
+        return all;
+    }
+
+    // filesystem of a uri, key is set to the path within it
+    std::shared_ptr<arrow::fs::FileSystem> of(const std::string& uri, std::string* key) {
+        const auto authority = uri.find("://") + 3;
+        const auto name = uri.substr(0, uri.find('/', authority));
+
+        std::lock_guard lock{mutex};
+        auto& filesystem = filesystems[name];
+
+        if (!filesystem) {
+            PARQUET_ASSIGN_OR_THROW(filesystem, arrow::fs::FileSystemFromUri(uri, key));
+            s3 = s3 || uri.starts_with("s3://");
+            return filesystem;
+        }
+
+        PARQUET_ASSIGN_OR_THROW(*key, filesystem->PathFromUri(uri));
+        return filesystem;
+    }
+
+    // clients go before the s3 api shuts down, arrow warns and can crash at exit without it
+    void finalize() {
+        std::lock_guard lock{mutex};
+        filesystems.clear();
+
+        if (std::exchange(s3, false)) {
+            (void)arrow::fs::FinalizeS3();
+        }
+    }
+};
+
+// finalizes the object stores when main returns or unwinds
+struct object_stores_guard {
+    object_stores_guard() = default;
+    object_stores_guard(const object_stores_guard&) = delete;
+    object_stores_guard& operator=(const object_stores_guard&) = delete;
+
+    ~object_stores_guard() {
+        object_stores::instance().finalize();
+    }
+};
+
+// object store of a uri, key is set to the path within it
+inline std::shared_ptr<arrow::fs::FileSystem> filesystem_of(const std::string& uri, std::string* key) {
+    return object_stores::instance().of(uri, key);
+}
+
+inline std::shared_ptr<arrow::io::OutputStream> open_file(const std::string& path) {
+    if (remote(path)) {
+        std::string key;
+        const auto filesystem = filesystem_of(path, &key);
+
+        std::shared_ptr<arrow::io::OutputStream> upload;
+        PARQUET_ASSIGN_OR_THROW(upload, filesystem->OpenOutputStream(key));
+        return std::make_shared<timed_output>(std::move(upload));
+    }
+
+    if (file_output.buffer_bytes > 0) {
+        return std::make_shared<timed_output>(std::make_shared<buffered_output>(path, file_output));
+    }
+
+    std::shared_ptr<arrow::io::FileOutputStream> outfile;
+    PARQUET_ASSIGN_OR_THROW(outfile, arrow::io::FileOutputStream::Open(path));
+    return std::make_shared<timed_output>(std::move(outfile));
+}
+
+// earlier output at a local path or object store uri, null when there is none
+inline std::shared_ptr<arrow::io::RandomAccessFile> open_existing(const std::string& path) {
+    std::shared_ptr<arrow::io::RandomAccessFile> existing;
+
+    if (remote(path)) {
+        std::string key;
+        const auto filesystem = filesystem_of(path, &key);
+
+        arrow::fs::FileInfo info;
+        PARQUET_ASSIGN_OR_THROW(info, filesystem->GetFileInfo(key));
+        if (info.type() == arrow::fs::FileType::File) {
+            PARQUET_ASSIGN_OR_THROW(existing, filesystem->OpenInputFile(key));
+        }
+    }
+    else if (std::filesystem::is_regular_file(path)) {
+        PARQUET_ASSIGN_OR_THROW(existing, arrow::io::ReadableFile::Open(path));
+    }
+
+    return existing;
+}
+
+// names of the files in a local directory or under an object store uri, empty when there is none
+inline std::vector<std::string> file_names(const std::string& directory) {
+    std::vector<std::string> names;
+
+    if (remote(directory)) {
+        arrow::fs::FileSelector selector;
+        const auto filesystem = filesystem_of(directory, &selector.base_dir);
+        selector.allow_not_found = true;
+
+        std::vector<arrow::fs::FileInfo> entries;
+        PARQUET_ASSIGN_OR_THROW(entries, filesystem->GetFileInfo(selector));
+        for (const auto& entry : entries) {
+            names.push_back(entry.base_name());
+        }
+    }
+    else if (std::filesystem::is_directory(directory)) {
+        for (const auto& entry : std::filesystem::directory_iterator{directory}) {
+            names.push_back(entry.path().filename().string());
+        }
+    }
+
+    return names;
+}
+
+// narrow table path next to the wide parquet file, ie itch.order_delete_message.parquet
+inline std::string message_file(const std::string& parquet_file, const std::string& message) {
+    const std::filesystem::path path{parquet_file};
+    return (path.parent_path() / (path.stem().string() + "." + message + path.extension().string())).string();
+}
+
+// numbered part file for a parallel chunk, ie itch.part0003.parquet
+inline std::string part_file(const std::string& parquet_file, const std::size_t part) {
+    const std::filesystem::path path{parquet_file};
+    char number[16];
+    std::snprintf(number, sizeof(number), ".part%04zu", part);
+    return (path.parent_path() / (path.stem().string() + number + path.extension().string())).string();
+}
+
+// numbered shard file, ie itch.shard0003.parquet
+inline std::string shard_file(const std::string& parquet_file, const std::size_t shard) {
+    const std::filesystem::path path{parquet_file};
+    char number[16];
+    std::snprintf(number, sizeof(number), ".shard%04zu", shard);
+    return (path.parent_path() / (path.stem().string() + number + path.extension().string())).string();
+}
+
+// options of one numbered part, its wide, narrow and arrow outputs are named after the part
+inline options part_options(const options& options, const std::size_t part) {
+    auto numbered = options;
+    numbered.parquet_file = part_file(options.parquet_file, part);
+    if (!options.arrow_file.empty()) {
+        numbered.arrow_file = part_file(options.arrow_file, part);
+    }
+    if (!options.feather_file.empty()) {
+        numbered.feather_file = part_file(options.feather_file, part);
+    }
+    if (!options.shm_name.empty()) {
+        numbered.shm_name = part_file(options.shm_name, part);
+    }
+    return numbered;
+}
+
+// compiled filter of the options, none without one
+inline std::shared_ptr<const packet_filter> packet_filter_of(const options& options) {
+    if (options.filter.empty()) {
+        return nullptr;
+    }
+    if (input_named(options.format) != input_format::pcap) {
+        throw std::invalid_argument("Packet filters need pcap or pcapng framing, not " + options.format);
+    }
+    return std::make_shared<const packet_filter>(options.filter);
+}
+
+// wide parquet files written for options, in packet order
+inline std::vector<std::string> parquet_files(const options& options) {
+    // every file of the dataset, earlier runs included
+    if (!options.dataset.empty()) {
+        std::vector<std::string> files;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator{options.dataset}) {
+            if (entry.is_regular_file() && entry.path().extension() == ".parquet") {
+                files.push_back(entry.path().string());
+            }
+        }
+        std::sort(files.begin(), files.end());
+        return files;
+    }
+
+    std::vector<std::string> parts;
+    if (!options.checkpoint_file.empty()) {
+        for (std::size_t part = 0; part < checkpoint::load(options.checkpoint_file).parts; ++part) {
+            parts.push_back(part_file(options.parquet_file, part));
+        }
+    } else if (options.threads <= 1) {
+        parts.push_back(options.parquet_file);
+    } else {
+        for (std::size_t part = 0; part < options.threads; ++part) {
+            parts.push_back(part_file(options.parquet_file, part));
+        }
+    }
+
+    if (options.shards == 0) {
+        return parts;
+    }
+
+    std::vector<std::string> files;
+    for (const auto& part : parts) {
+        for (std::size_t shard = 0; shard < options.shards; ++shard) {
+            files.push_back(shard_file(part, shard));
+        }
+    }
+    return files;
+}
+
+// column codec by name
+inline std::optional<arrow::Compression::type> compression_named(const std::string_view name) {
+    if (name == "uncompressed") return arrow::Compression::UNCOMPRESSED;
+    if (name == "snappy") return arrow::Compression::SNAPPY;
+    if (name == "gzip") return arrow::Compression::GZIP;
+    if (name == "brotli") return arrow::Compression::BROTLI;
+    if (name == "zstd") return arrow::Compression::ZSTD;
+    if (name == "lz4") return arrow::Compression::LZ4;
+    return std::nullopt;
+}
+
+// column encoding by name
+inline std::optional<parquet::Encoding::type> encoding_named(const std::string_view name) {
+    if (name == "plain") return parquet::Encoding::PLAIN;
+    if (name == "dictionary") return parquet::Encoding::RLE_DICTIONARY;
+    if (name == "delta") return parquet::Encoding::DELTA_BINARY_PACKED;
+    if (name == "delta_length") return parquet::Encoding::DELTA_LENGTH_BYTE_ARRAY;
+    if (name == "delta_bytes") return parquet::Encoding::DELTA_BYTE_ARRAY;
+    if (name == "byte_stream_split") return parquet::Encoding::BYTE_STREAM_SPLIT;
+    return std::nullopt;
+}
+
+// writer properties for a named profile plus per column overrides
+//   default          library defaults, dictionary pages and no compression
+//   archive-zstd     zstd level 9 with the field encodings, smallest files
+//   fast-lz4         lz4 with the field encodings, cheapest to write
+//   query-optimized  snappy with the field encodings and smaller pages for selective reads
+inline std::shared_ptr<parquet::WriterProperties> writer_properties(const options& options) {
+    parquet::WriterProperties::Builder builder;
+
+    // nanosecond timestamps need format 2.6
+    builder.version(parquet::ParquetVersion::PARQUET_2_6);
+
+    if (options.profile == "archive-zstd") {
+        builder.compression(arrow::Compression::ZSTD);
+        builder.compression_level(9);
+        feed::prefer_encodings(builder);
+    }
+    else if (options.profile == "fast-lz4") {
+        builder.compression(arrow::Compression::LZ4);
+        feed::prefer_encodings(builder);
+    }
+    else if (options.profile == "query-optimized") {
+        builder.compression(arrow::Compression::SNAPPY);
+        builder.data_pagesize(128 << 10);
+        feed::prefer_encodings(builder);
+    }
+    else if (options.profile != "default") {
+        throw std::invalid_argument("Unknown profile " + options.profile);
+    }
+
+    if (options.page_bytes > 0) {
+        builder.data_pagesize(options.page_bytes);
+    }
+
+    if (options.page_index) {
+        builder.enable_write_page_index();
+    }
+
+    auto lookups = options.default_lookups ? feed::lookup_columns() : std::vector<std::string>{};
+    lookups.insert(lookups.end(), options.lookups.begin(), options.lookups.end());
+
+    // a lookup column holds at most a value a row, rows are estimated from the shortest message so the count errs high
+    const auto rows = std::max<std::int64_t>(options.row_group_bytes / feed::all_messages::smallest_wire_size, 1);
+
+    parquet::BloomFilterOptions bloom;
+    bloom.ndv = static_cast<std::int32_t>(std::min<std::int64_t>(rows, options.bloom_ndv));
+    bloom.fpp = options.bloom_fpp;
+
+    for (const auto& column : lookups) {
+        builder.enable_bloom_filter(column, bloom);
+    }
+
+    for (const auto& [column, settings] : options.columns) {
+        std::string_view remaining{settings};
+
+        while (!remaining.empty()) {
+            const auto comma = remaining.find(',');
+            const auto setting = remaining.substr(0, comma);
+            remaining = comma == std::string_view::npos ? std::string_view{} : remaining.substr(comma + 1);
+
+            if (const auto compression = compression_named(setting)) {
+                builder.compression(column, *compression);
+            }
+            else if (const auto encoding = encoding_named(setting); encoding == parquet::Encoding::RLE_DICTIONARY) {
+                builder.enable_dictionary(column);
+            }
+            else if (encoding) {
+                builder.disable_dictionary(column);
+                builder.encoding(column, *encoding);
+            }
+            else {
+                throw std::invalid_argument("Unknown column setting " + std::string{setting} + " for " + column);
+            }
+        }
+    }
+
+    return builder.build();
+}
+
+// row group sizing shared by every file of a converter, buffered row groups are held in memory until closed
+struct row_group_budget {
+    std::int64_t target = 0; // encoded bytes per row group
+    std::int64_t memory = 0; // buffered bytes across files
+    std::atomic<std::int64_t> buffered{0};
+
+    explicit row_group_budget(const options& options)
+        : target{options.row_group_bytes}
+        , memory{options.memory_budget} {}
+
+    // row group grew from previous to bytes, true when over budget and should close
+    [[nodiscard]] bool charge(const std::int64_t previous, const std::int64_t bytes) {
+        const auto total = buffered.fetch_add(bytes - previous, std::memory_order_relaxed) + bytes - previous;
+        return total > memory;
+    }
+
+    void release(const std::int64_t bytes) {
+        buffered.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+};
+
+// row group sizes achieved by one file
+struct row_group_summary {
+    std::uint64_t row_groups = 0;
+    std::uint64_t rows = 0;
+    std::int64_t bytes = 0;
+    std::int64_t smallest = std::numeric_limits<std::int64_t>::max();
+    std::int64_t largest = 0;
+    std::uint64_t early = 0; // closed by the memory budget before the target
+    std::uint64_t bloom_bytes = 0;
+
+    void add(const std::uint64_t group_rows, const std::int64_t group_bytes, const bool budgeted) {
+        row_groups += 1;
+        rows += group_rows;
+        bytes += group_bytes;
+        smallest = std::min(smallest, group_bytes);
+        largest = std::max(largest, group_bytes);
+        early += budgeted ? 1 : 0;
+    }
+
+    // row groups of another file
+    void add(const row_group_summary& other) {
+        row_groups += other.row_groups;
+        rows += other.rows;
+        bytes += other.bytes;
+        smallest = std::min(smallest, other.smallest);
+        largest = std::max(largest, other.largest);
+        early += other.early;
+        bloom_bytes += other.bloom_bytes;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& out, const row_group_summary& summary) {
+    if (summary.row_groups == 0) {
+        return out << "no row groups";
+    }
+
+    const auto kib = [](const std::int64_t bytes) { return bytes >> 10; };
+
+    return out << summary.row_groups << " row groups, " << summary.rows << " rows, "
+               << kib(summary.bytes / static_cast<std::int64_t>(summary.row_groups)) << " KiB average, "
+               << kib(summary.smallest) << " to " << kib(summary.largest) << " KiB, "
+               << summary.early << " closed early by the memory budget, "
+               << kib(static_cast<std::int64_t>(summary.bloom_bytes)) << " KiB bloom filters";
+}
+
+// parquet column batch writer, row groups are encoded inline or by a pipeline encoder
+template <typename batch>
+struct batch_writer {
+
+    std::string path;
+    std::unique_ptr<parquet::ParquetFileWriter> file;
+    parquet::RowGroupWriter* row_group = nullptr;
+    row_group_budget* budget = nullptr;
+    std::int64_t buffered = 0; // open row group bytes charged to the budget
+    std::uint64_t group_rows = 0;
+    row_group_summary summary;
+    std::size_t batch_size = 0;
+    std::unique_ptr<batch> rows;
+    projection projected;
+
+    // pipelined only
+    pipeline* pipelined = nullptr;
+    encoder* owner = nullptr;
+    std::vector<std::unique_ptr<batch>> batches;
+    std::unique_ptr<spsc_queue<batch*>> written;
+
+    batch_writer() = default;
+
+    batch_writer(const std::string& path, std::shared_ptr<parquet::WriterProperties> properties, row_group_budget& budget, const std::size_t batch_size, pipeline* pipeline = nullptr, projection projected = {})
+        : path{path}
+        , file{parquet::ParquetFileWriter::Open(open_file(path), batch::schema(projected), std::move(properties))}
+        , budget{&budget}
+        , batch_size{batch_size}
+        , rows{std::make_unique<batch>(batch_size)}
+        , projected{std::move(projected)}
+        , pipelined{pipeline} {
+        if (pipelined != nullptr) {
+            owner = pipelined->assign();
+            written = std::make_unique<spsc_queue<batch*>>(pipelined->queue_depth + 1);
+        }
+    }
+
+    template <typename row>
+    void append(const row& record) {
+        rows->append(record);
+
+        if (rows->size == batch_size) {
+            flush();
+        }
+    }
+
+    // hand buffered rows to the encoder
+    void flush() {
+        if (rows->empty()) {
+            return;
+        }
+
+        if (pipelined == nullptr) {
+            write(*rows);
+            rows->clear();
+            return;
+        }
+
+        pipelined->push(owner, encode_task{&encode, &release, this, rows.get()});
+        batches.push_back(std::move(rows));
+        rows = refill();
+    }
+
+    // next empty batch, allocated until queue depth batches are in flight
+    std::unique_ptr<batch> refill() {
+        batch* next = nullptr;
+
+        if (!written->try_pop(next)) {
+            if (batches.size() <= pipelined->queue_depth) {
+                return std::make_unique<batch>(batch_size);
+            }
+            // batches stop coming back written once the encoder fails
+            wait_until([&] { return written->try_pop(next) || owner->failed.load(std::memory_order_acquire); }, pipelined->starved);
+
+            if (next == nullptr) {
+                std::rethrow_exception(owner->error);
+            }
+        }
+
+        const auto found = std::find_if(batches.begin(), batches.end(), [next](const auto& pending) { return pending.get() == next; });
+        auto refilled = std::move(*found);
+        batches.erase(found);
+
+        return refilled;
+    }
+
+    // encoder thread
+    static void encode(void* writer, void* rows) {
+        const auto self = static_cast<batch_writer*>(writer);
+        const auto sealed = static_cast<batch*>(rows);
+
+        try {
+            self->write(*sealed);
+        }
+        catch (...) {
+            release(writer, rows);
+            throw;
+        }
+
+        release(writer, rows);
+    }
+
+    // encoder thread, the batch goes back to the decoder whether it was written or not
+    static void release(void* writer, void* rows) {
+        const auto self = static_cast<batch_writer*>(writer);
+        const auto sealed = static_cast<batch*>(rows);
+
+        sealed->clear();
+
+        // never full, at most queue depth plus one batches exist
+        (void)self->written->try_push(sealed);
+    }
+
+    // append buffered rows to the open row group, in slices of the column writers' write batch size
+    // pages are only cut at the end of a column write, so the size estimate checked after each slice is the one a per row check would see
+    void write(batch& rows) {
+        if (rows.empty()) {
+            return;
+        }
+
+        timed_stage timer{stage::encode};
+        const auto slice = static_cast<std::size_t>(std::max<std::int64_t>(file->properties()->write_batch_size(), 1));
+        typename batch::cursor values{};
+
+        rows.seal();
+        for (std::size_t first = 0; first < rows.size; first += slice) {
+            const auto count = std::min(slice, rows.size - first);
+            rows.write(open_row_group(count), projected, first, count, values);
+            check_row_group();
+        }
+    }
+
+    parquet::RowGroupWriter* open_row_group(const std::size_t count) {
+        if (row_group == nullptr) {
+            row_group = file->AppendBufferedRowGroup();
+        }
+        group_rows += count;
+        return row_group;
+    }
+
+    // same byte estimate as parquet::StreamWriter::SetMaxRowGroupSize, checked wherever it can change so row groups close on the row that reaches the target
+    // closed at the target or early when every file together is over the memory budget
+    void check_row_group() {
+        const auto bytes = row_group->total_bytes_written() + row_group->total_compressed_bytes();
+        const auto over = budget->charge(buffered, bytes);
+        buffered = bytes;
+
+        if (bytes >= budget->target || over) {
+            end_row_group(bytes < budget->target);
+        }
+    }
+
+    void end_row_group(const bool budgeted = false) {
+        if (row_group == nullptr) {
+            return;
+        }
+
+        summary.add(group_rows, buffered, budgeted);
+        {
+            timed_stage timer{stage::encode};
+            row_group->Close();
+        }
+        row_group = nullptr;
+
+        budget->release(buffered);
+        buffered = 0;
+        group_rows = 0;
+    }
+
+    // required to finish parquet file, after the pipeline has drained
+    void close() {
+        end_row_group();
+
+        // filters are sized up front from the writer properties, one per filtered column of every row group
+        const auto* schema = file->schema();
+        for (int column = 0; column < schema->num_columns(); ++column) {
+            if (const auto bloom = file->properties()->bloom_filter_options(schema->Column(column)->path())) {
+                summary.bloom_bytes += summary.row_groups * parquet::BlockSplitBloomFilter::OptimalNumOfBytes(static_cast<std::uint32_t>(bloom->ndv), bloom->fpp);
+            }
+        }
+        statistics::local().bloom_bytes.add(summary.bloom_bytes);
+
+        timed_stage timer{stage::encode};
+        file->Close();
+    }
+
+    void report(std::ostream& out) const {
+        out << path << ": " << summary << std::endl;
+    }
+};
+
+// narrow parquet table for one message type
+template <typename message>
+struct message_table : batch_writer<typename message::batch> {
+
+    message_table(const options& options, const std::shared_ptr<parquet::WriterProperties>& properties, row_group_budget& budget, const std::size_t batch_size, pipeline* pipeline)
+        : batch_writer<typename message::batch>{message_file(options.parquet_file, message::name), properties, budget, batch_size, pipeline} {}
+};
+
+// narrow parquet tables, routed by message type
+template <typename... messages>
+struct message_tables {
+
+    std::tuple<message_table<messages>...> tables;
+
+    message_tables(const options& options, const std::shared_ptr<parquet::WriterProperties>& properties, row_group_budget& budget, const std::size_t batch_size, pipeline* pipeline)
+        : tables{message_table<messages>{options, properties, budget, batch_size, pipeline}...} {}
+
+    template <typename row>
+    void append(const row& record) {
+        const auto type = record.message_type.data;
+        (void)((type == messages::type && (std::get<message_table<messages>>(tables).append(record), true)) || ...);
+    }
+
+    void flush() {
+        (std::get<message_table<messages>>(tables).flush(), ...);
+    }
+
+    void close() {
+        (std::get<message_table<messages>>(tables).close(), ...);
+    }
+
+    void report(std::ostream& out) const {
+        (std::get<message_table<messages>>(tables).report(out), ...);
+    }
+};
+
+// narrow tables of every message type of the feed
+template <typename messages>
+struct message_tables_of;
+
+template <typename... messages>
+struct message_tables_of<feed::message_types<messages...>> {
+    using type = message_tables<messages...>;
+};
+
+using narrow_tables = message_tables_of<feed::all_messages>::type;
+
+///////////////////////////////////////////////////////////////////////
+// arrow ipc
+///////////////////////////////////////////////////////////////////////
+
+// arrow unit of a parquet time unit
+inline arrow::TimeUnit::type time_unit(const parquet::LogicalType::TimeUnit::unit unit) {
+    switch (unit) {
+        case parquet::LogicalType::TimeUnit::MILLIS: return arrow::TimeUnit::MILLI;
+        case parquet::LogicalType::TimeUnit::MICROS: return arrow::TimeUnit::MICRO;
+        default: return arrow::TimeUnit::NANO;
+    }
+}
+
+// arrow type of a wide table column
+inline std::shared_ptr<arrow::DataType> arrow_type(const parquet::ColumnDescriptor& column) {
+    const auto& logical = *column.logical_type();
+
+    if (logical.is_timestamp()) {
+        const auto& timestamp = static_cast<const parquet::TimestampLogicalType&>(logical);
+        return arrow::timestamp(time_unit(timestamp.time_unit()), timestamp.is_adjusted_to_utc() ? "UTC" : "");
+    }
+    if (logical.is_time()) {
+        return arrow::time64(time_unit(static_cast<const parquet::TimeLogicalType&>(logical).time_unit()));
+    }
+    if (logical.is_decimal()) {
+        const auto& decimal = static_cast<const parquet::DecimalLogicalType&>(logical);
+        return arrow::decimal128(decimal.precision(), decimal.scale());
+    }
+
+    switch (column.converted_type()) {
+        case parquet::ConvertedType::UINT_8: return arrow::uint8();
+        case parquet::ConvertedType::UINT_16: return arrow::uint16();
+        case parquet::ConvertedType::UINT_32: return arrow::uint32();
+        case parquet::ConvertedType::UINT_64: return arrow::uint64();
+        case parquet::ConvertedType::TIMESTAMP_MICROS: return arrow::timestamp(arrow::TimeUnit::MICRO);
+        case parquet::ConvertedType::UTF8: return arrow::utf8();
+        default: break;
+    }
+
+    switch (column.physical_type()) {
+        case parquet::Type::INT32: return arrow::int32();
+        case parquet::Type::INT64: return arrow::int64();
+        case parquet::Type::BYTE_ARRAY: return arrow::utf8();
+        default: throw std::invalid_argument("Unsupported column " + column.name());
+    }
+}
+
+// arrow schema of a column batch, the same types a query of its parquet file returns
+template <typename batch>
+std::shared_ptr<arrow::Schema> arrow_schema(const projection& projected = {}) {
+    parquet::SchemaDescriptor descriptor;
+    descriptor.Init(batch::schema(projected));
+
+    arrow::FieldVector fields;
+    for (int index = 0; index < descriptor.num_columns(); ++index) {
+        const auto column = descriptor.Column(index);
+        fields.push_back(arrow::field(column->name(), arrow_type(*column), column->max_definition_level() > 0));
+    }
+    return arrow::schema(std::move(fields));
+}
+
+// arrow array of a padded column, value converts the next defined value
+template <typename builder_type, typename column_type, typename convert>
+std::shared_ptr<arrow::Array> arrow_values(const column_type& column, const std::shared_ptr<arrow::DataType>& type, const std::size_t rows, convert&& value) {
+    builder_type builder{type, arrow::default_memory_pool()};
+    PARQUET_THROW_NOT_OK(builder.Reserve(static_cast<std::int64_t>(rows)));
+    if constexpr (column_type::byte_array) {
+        PARQUET_THROW_NOT_OK(builder.ReserveData(static_cast<std::int64_t>(column.bytes.size())));
+    }
+
+    for (std::size_t row = 0, next = 0; row < rows; ++row) {
+        if constexpr (column_type::optional) {
+            if (column.levels[row] == 0) {
+                builder.UnsafeAppendNull();
+                continue;
+            }
+        }
+        builder.UnsafeAppend(value(next++));
+    }
+
+    std::shared_ptr<arrow::Array> array;
+    PARQUET_THROW_NOT_OK(builder.Finish(&array));
+    return array;
+}
+
+// arrow array of a padded column in the type of its schema field
+template <typename column_type>
+std::shared_ptr<arrow::Array> arrow_array(const column_type& column, const std::shared_ptr<arrow::DataType>& type, const std::size_t rows) {
+    const auto& values = column.values;
+
+    if constexpr (column_type::byte_array) {
+        // byte array values only hold lengths until written, the bytes are packed in row order
+        std::size_t offset = 0;
+        return arrow_values<arrow::StringBuilder>(column, type, rows, [&](const std::size_t index) {
+            const std::string_view value{reinterpret_cast<const char*>(column.bytes.data()) + offset, values[index].len};
+            offset += value.size();
+            return value;
+        });
+    } else {
+        switch (type->id()) {
+            case arrow::Type::UINT8: return arrow_values<arrow::UInt8Builder>(column, type, rows, [&](const std::size_t index) { return static_cast<std::uint8_t>(values[index]); });
+            case arrow::Type::UINT16: return arrow_values<arrow::UInt16Builder>(column, type, rows, [&](const std::size_t index) { return static_cast<std::uint16_t>(values[index]); });
+            case arrow::Type::UINT32: return arrow_values<arrow::UInt32Builder>(column, type, rows, [&](const std::size_t index) { return static_cast<std::uint32_t>(values[index]); });
+            case arrow::Type::UINT64: return arrow_values<arrow::UInt64Builder>(column, type, rows, [&](const std::size_t index) { return static_cast<std::uint64_t>(values[index]); });
+            case arrow::Type::INT32: return arrow_values<arrow::Int32Builder>(column, type, rows, [&](const std::size_t index) { return static_cast<std::int32_t>(values[index]); });
+            case arrow::Type::INT64: return arrow_values<arrow::Int64Builder>(column, type, rows, [&](const std::size_t index) { return static_cast<std::int64_t>(values[index]); });
+            case arrow::Type::TIMESTAMP: return arrow_values<arrow::TimestampBuilder>(column, type, rows, [&](const std::size_t index) { return static_cast<std::int64_t>(values[index]); });
+            case arrow::Type::TIME64: return arrow_values<arrow::Time64Builder>(column, type, rows, [&](const std::size_t index) { return static_cast<std::int64_t>(values[index]); });
+            case arrow::Type::DECIMAL128: return arrow_values<arrow::Decimal128Builder>(column, type, rows, [&](const std::size_t index) { return arrow::Decimal128{static_cast<std::int64_t>(values[index])}; });
+            default: throw std::invalid_argument("Unsupported arrow type " + type->ToString());
+        }
+    }
+}
+
+// arrow record batch of the buffered rows, optional columns are padded first
+template <typename batch, std::size_t... index>
+std::shared_ptr<arrow::RecordBatch> arrow_batch(batch& rows, const std::shared_ptr<arrow::Schema>& schema, const projection& projected, std::index_sequence<index...>) {
+    rows.pad();
+
+    arrow::ArrayVector arrays;
+    ([&] {
+        if (projected.keeps(index)) {
+            arrays.push_back(arrow_array(std::get<index>(rows.data), schema->field(static_cast<int>(arrays.size()))->type(), rows.size));
+        }
+    }(), ...);
+
+    return arrow::RecordBatch::Make(schema, static_cast<std::int64_t>(rows.size), std::move(arrays));
+}
+
+template <typename batch>
+std::shared_ptr<arrow::RecordBatch> arrow_batch(batch& rows, const std::shared_ptr<arrow::Schema>& schema, const projection& projected = {}) {
+    return arrow_batch(rows, schema, projected, std::make_index_sequence<batch::column_count>{});
+}
+
+// ring of ipc encoded record batches in shared memory, readers map /dev/shm/name and decode slots in place
+//   header, then the ipc schema message, then the slots, each 64 byte aligned
+//   batch n is written to slot n % slots, whose sequence is odd while it is written and 2n + 2 once complete
+//   a reader finding any other sequence was lapped by the writer and resumes from published - slots
+struct shm_ring {
+
+    static constexpr std::uint64_t signature = 0x3143504948435449; // ITCHIPC1, the header magic once the schema is in place
+    static constexpr std::size_t alignment = 64;
+
+    struct header {
+        std::atomic<std::uint64_t> magic{0};
+        std::uint64_t slots = 0;
+        std::uint64_t slot_bytes = 0; // ipc message capacity of a slot
+        std::uint64_t schema_offset = 0;
+        std::uint64_t schema_bytes = 0;
+        std::uint64_t slots_offset = 0;
+        std::uint64_t slot_stride = 0;
+        std::atomic<std::uint64_t> published{0}; // complete batches
+        std::atomic<std::uint64_t> closed{0}; // no more batches follow
+    };
+
+    struct alignas(alignment) slot {
+        std::atomic<std::uint64_t> sequence{0};
+        std::uint64_t length = 0; // ipc message bytes after the slot header
+    };
+
+    std::string name;
+    int descriptor = -1;
+    u_char* mapping = nullptr;
+    std::size_t size = 0;
+    header* head = nullptr;
+
+    static std::uint64_t aligned(const std::uint64_t bytes) {
+        return (bytes + alignment - 1) & ~std::uint64_t{alignment - 1};
+    }
+
+    shm_ring(const std::string& name, const arrow::Schema& schema, const std::uint64_t slots, const std::uint64_t slot_bytes)
+        : name{name.starts_with('/') ? name : "/" + name} {
+        std::shared_ptr<arrow::Buffer> encoded;
+        PARQUET_ASSIGN_OR_THROW(encoded, arrow::ipc::SerializeSchema(schema));
+
+        const auto schema_offset = aligned(sizeof(header));
+        const auto slots_offset = schema_offset + aligned(static_cast<std::uint64_t>(encoded->size()));
+        const auto slot_stride = aligned(sizeof(slot)) + aligned(slot_bytes);
+        size = slots_offset + std::max<std::uint64_t>(slots, 1) * slot_stride;
+
+        descriptor = ::shm_open(this->name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+        if (descriptor < 0) {
+            throw std::runtime_error("Unable to open shared memory " + this->name);
+        }
+        if (::ftruncate(descriptor, static_cast<off_t>(size)) != 0) {
+            ::close(descriptor);
+            throw std::runtime_error("Unable to size shared memory " + this->name);
+        }
+
+        auto mapped = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+        if (mapped == MAP_FAILED) {
+            ::close(descriptor);
+            throw std::runtime_error("Unable to map shared memory " + this->name);
+        }
+        mapping = static_cast<u_char*>(mapped);
+
+        head = new (mapping) header{};
+        head->slots = std::max<std::uint64_t>(slots, 1);
+        head->slot_bytes = slot_bytes;
+        head->schema_offset = schema_offset;
+        head->schema_bytes = static_cast<std::uint64_t>(encoded->size());
+        head->slots_offset = slots_offset;
+        head->slot_stride = slot_stride;
+
+        std::memcpy(mapping + schema_offset, encoded->data(), head->schema_bytes);
+        for (std::uint64_t index = 0; index < head->slots; ++index) {
+            new (mapping + slots_offset + index * slot_stride) slot{};
+        }
+
+        head->magic.store(signature, std::memory_order_release);
+    }
+
+    shm_ring(const shm_ring&) = delete;
+    shm_ring& operator=(const shm_ring&) = delete;
+
+    // the ring stays in /dev/shm for late readers until the next run or an unlink
+    ~shm_ring() {
+        ::munmap(mapping, size);
+        ::close(descriptor);
+    }
+
+    // encode one batch into the next slot, overwriting the oldest
+    void publish(const arrow::RecordBatch& batch) {
+        std::int64_t length = 0;
+        PARQUET_THROW_NOT_OK(arrow::ipc::GetRecordBatchSize(batch, &length));
+        if (static_cast<std::uint64_t>(length) > head->slot_bytes) {
+            throw std::runtime_error("Record batch of " + std::to_string(length) + " bytes does not fit a " + std::to_string(head->slot_bytes)
+                + " byte slot of shared memory " + name + ", raise --shm-slot-bytes or lower --batch-size");
+        }
+
+        const auto sequence = head->published.load(std::memory_order_relaxed);
+        const auto position = mapping + head->slots_offset + (sequence % head->slots) * head->slot_stride;
+        auto& current = *reinterpret_cast<slot*>(position);
+
+        current.sequence.store(2 * sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        arrow::io::FixedSizeBufferWriter out{std::make_shared<arrow::MutableBuffer>(position + aligned(sizeof(slot)), static_cast<std::int64_t>(head->slot_bytes))};
+        PARQUET_THROW_NOT_OK(arrow::ipc::SerializeRecordBatch(batch, arrow::ipc::IpcWriteOptions::Defaults(), &out));
+
+        std::int64_t written = 0;
+        PARQUET_ASSIGN_OR_THROW(written, out.Tell());
+        current.length = static_cast<std::uint64_t>(written);
+
+        current.sequence.store(2 * sequence + 2, std::memory_order_release);
+        head->published.store(sequence + 1, std::memory_order_release);
+    }
+
+    void close() {
+        head->closed.store(1, std::memory_order_release);
+    }
+};
+
+// any arrow output requested
+inline bool arrow_outputs(const options& options) {
+    return !options.arrow_file.empty() || !options.feather_file.empty() || !options.shm_name.empty();
+}
+
+// arrow copy of the wide rows from the same decoder, as ipc stream and file outputs or a shared memory ring, never parquet encoded
+template <typename batch>
+struct arrow_sink {
+
+    projection projected;
+    std::shared_ptr<arrow::Schema> schema;
+    batch rows;
+    std::size_t batch_size;
+    std::vector<std::shared_ptr<arrow::io::OutputStream>> files;
+    std::vector<std::shared_ptr<arrow::ipc::RecordBatchWriter>> writers;
+    std::unique_ptr<shm_ring> ring;
+    std::uint64_t batches = 0;
+    std::uint64_t written = 0; // rows
+    std::chrono::steady_clock::duration linger{0}; // live consumers get a partial batch this long after its first row, zero waits for full ones
+    std::chrono::steady_clock::time_point first; // first row of the partial batch
+
+    arrow_sink(const options& options, const std::size_t batch_size)
+        : projected{batch::project(options.write_columns)}
+        , schema{arrow_schema<batch>(projected)}
+        , rows{batch_size}
+        , batch_size{batch_size}
+        , linger{options.interface.empty() ? std::chrono::milliseconds{0} : std::chrono::milliseconds{options.arrow_flush_ms}} {
+        if (!options.arrow_file.empty()) {
+            open(options.arrow_file, false);
+        }
+        if (!options.feather_file.empty()) {
+            open(options.feather_file, true);
+        }
+        if (!options.shm_name.empty()) {
+            ring = std::make_unique<shm_ring>(options.shm_name, *schema, options.shm_slots, options.shm_slot_bytes);
+        }
+    }
+
+    // ipc file format when random access, ie feather v2, otherwise the stream format
+    void open(const std::string& path, const bool random_access) {
+        auto& file = files.emplace_back(open_file(path));
+        std::shared_ptr<arrow::ipc::RecordBatchWriter> writer;
+        if (random_access) {
+            PARQUET_ASSIGN_OR_THROW(writer, arrow::ipc::MakeFileWriter(file, schema));
+        } else {
+            PARQUET_ASSIGN_OR_THROW(writer, arrow::ipc::MakeStreamWriter(file, schema));
+        }
+        writers.push_back(std::move(writer));
+    }
+
+    template <typename row>
+    void append(const row& record) {
+        if (linger.count() > 0 && rows.empty()) {
+            first = std::chrono::steady_clock::now();
+        }
+
+        rows.append(record);
+
+        if (rows.size >= batch_size) {
+            flush();
+        }
+    }
+
+    // a quiet feed still hands its decoded rows on, called between packets and on ring timeouts
+    void tick(const std::chrono::steady_clock::time_point now) {
+        if (linger.count() > 0 && !rows.empty() && now - first >= linger) {
+            flush();
+            for (auto& file : files) {
+                PARQUET_THROW_NOT_OK(file->Flush());
+            }
+        }
+    }
+
+    void flush() {
+        if (rows.empty()) {
+            return;
+        }
+
+        const auto converted = arrow_batch(rows, schema, projected);
+
+        for (auto& writer : writers) {
+            PARQUET_THROW_NOT_OK(writer->WriteRecordBatch(*converted));
+        }
+        if (ring) {
+            ring->publish(*converted);
+        }
+
+        batches += 1;
+        written += rows.size;
+        rows.clear();
+    }
+
+    // end of stream marker and file footer, readers of the ring see it closed
+    void close() {
+        flush();
+
+        for (auto& writer : writers) {
+            PARQUET_THROW_NOT_OK(writer->Close());
+        }
+        for (auto& file : files) {
+            PARQUET_THROW_NOT_OK(file->Close());
+        }
+        if (ring) {
+            ring->close();
+        }
+    }
+
+    void report(std::ostream& out) const {
+        out << "arrow: " << written << " rows in " << batches << " record batches" << std::endl;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////
+// sharded writer
+///////////////////////////////////////////////////////////////////////
+
+// unit of work on the pool, worker is the thread running it
+struct work {
+    void (*run)(void* owner, std::size_t index, std::size_t worker) = nullptr;
+    void* owner = nullptr;
+    std::size_t index = 0;
+};
+
+// worker threads with a deque each, owners pop the back and idle workers steal the front of others
+struct work_pool {
+
+    struct alignas(cache_line_size) queue {
+        std::mutex mutex;
+        std::deque<work> tasks;
+    };
+
+    std::vector<std::unique_ptr<queue>> queues;
+    std::vector<std::thread> threads;
+    std::atomic<std::size_t> pending{0};
+    std::atomic<bool> stopping{false};
+    std::atomic<std::uint64_t> executed{0};
+    std::atomic<std::uint64_t> stolen{0};
+    std::mutex sleeping;
+    std::condition_variable wake;
+    std::mutex failure;
+    std::exception_ptr error;
+    std::atomic<bool> failed{false}; // error is set
+
+    explicit work_pool(const std::size_t workers) {
+        for (std::size_t worker = 0; worker < workers; ++worker) {
+            queues.push_back(std::make_unique<queue>());
+        }
+        for (std::size_t worker = 0; worker < workers; ++worker) {
+            threads.emplace_back([this, worker] { run(worker); });
+        }
+    }
+
+    work_pool(const work_pool&) = delete;
+    work_pool& operator=(const work_pool&) = delete;
+
+    ~work_pool() {
+        stop();
+    }
+
+    // counted before it is queued, so a thief popping it at once never takes pending below zero
+    void push(const std::size_t worker, const work& task) {
+        pending.fetch_add(1, std::memory_order_release);
+        {
+            std::lock_guard lock{queues[worker]->mutex};
+            queues[worker]->tasks.push_back(task);
+        }
+        wake.notify_one();
+    }
+
+    bool pop(const std::size_t worker, work& task) {
+        auto& own = *queues[worker];
+        std::lock_guard lock{own.mutex};
+        if (own.tasks.empty()) {
+            return false;
+        }
+        task = own.tasks.back();
+        own.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(const std::size_t thief, work& task) {
+        for (std::size_t offset = 1; offset < queues.size(); ++offset) {
+            auto& victim = *queues[(thief + offset) % queues.size()];
+            std::lock_guard lock{victim.mutex};
+            if (!victim.tasks.empty()) {
+                task = victim.tasks.front();
+                victim.tasks.pop_front();
+                stolen.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run(const std::size_t worker) {
+        work task;
+
+        while (true) {
+            if (pop(worker, task) || steal(worker, task)) {
+                pending.fetch_sub(1, std::memory_order_acq_rel);
+                execute(task, worker);
+                continue;
+            }
+
+            if (stopping.load(std::memory_order_acquire) && pending.load(std::memory_order_acquire) == 0) {
+                return;
+            }
+
+            std::unique_lock lock{sleeping};
+            wake.wait_for(lock, std::chrono::milliseconds{1}, [&] {
+                return pending.load(std::memory_order_acquire) > 0 || stopping.load(std::memory_order_acquire);
+            });
+        }
+    }
+
+    // remaining tasks still run after a failure so shards drain
+    void execute(const work& task, const std::size_t worker) {
+        try {
+            task.run(task.owner, task.index, worker);
+            executed.fetch_add(1, std::memory_order_relaxed);
+        }
+        catch (...) {
+            std::lock_guard lock{failure};
+            if (!error) {
+                error = std::current_exception();
+            }
+            failed.store(true, std::memory_order_release);
+        }
+    }
+
+    // first task failure, once failed is seen
+    void rethrow() {
+        std::lock_guard lock{failure};
+        std::rethrow_exception(error);
+    }
+
+    void stop() {
+        stopping.store(true, std::memory_order_release);
+        wake.notify_all();
+
+        for (auto& thread : threads) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+    }
+};
+
+// wide rows routed by instrument to one parquet file per shard, columns of a batch are encoded in parallel
+template <typename batch>
+struct sharded_writer {
+
+    // one output file, batches are written in order one at a time
+    struct shard {
+        batch_writer<batch> writer;
+        std::size_t home = 0; // worker that starts its batches
+        std::unique_ptr<batch> rows;
+        std::size_t allocated = 0;
+
+        std::mutex mutex;
+        std::deque<batch*> sealed;
+        std::vector<batch*> free;
+        std::vector<std::unique_ptr<batch>> batches;
+        batch* writing = nullptr;
+
+        std::vector<parquet::ColumnWriter*> columns;
+        std::atomic<std::size_t> remaining{0};
+        sharded_writer* owner = nullptr;
+    };
+
+    std::vector<std::unique_ptr<shard>> shards;
+    std::size_t batch_size;
+    std::size_t queue_depth;
+    stall starved; // decoder waiting for a written batch
+    std::unique_ptr<work_pool> own_pool; // joined before the shards it writes are destroyed
+    work_pool* pool; // own_pool, or one shared by the writers of a run that outlives them
+
+    sharded_writer(const options& options, const std::shared_ptr<parquet::WriterProperties>& properties, row_group_budget& budget, const std::size_t count, const std::size_t batch_size, work_pool* shared = nullptr)
+        : batch_size{batch_size}
+        , queue_depth{std::max<std::size_t>(options.queue_depth, 1)}
+        , own_pool{shared == nullptr ? std::make_unique<work_pool>(count) : nullptr}
+        , pool{shared == nullptr ? own_pool.get() : shared} {
+        for (std::size_t index = 0; index < count; ++index) {
+            auto next = std::make_unique<shard>();
+            next->writer = batch_writer<batch>{shard_file(options.parquet_file, index), properties, budget, batch_size, nullptr, batch::project(options.write_columns)};
+            next->home = index;
+            next->rows = std::make_unique<batch>(batch_size);
+            next->owner = this;
+            shards.push_back(std::move(next));
+        }
+    }
+
+    // feed order is kept within each shard, rows carry pcap index and sequence for a global merge
+    template <typename record>
+    void append(const record& row, const std::uint64_t instrument) {
+        auto& shard = *shards[instrument % shards.size()];
+        shard.rows->append(row);
+
+        if (shard.rows->size == batch_size) {
+            seal(shard);
+        }
+    }
+
+    void seal(shard& shard) {
+        if (shard.rows->empty()) {
+            return;
+        }
+
+        auto sealed = shard.rows.get();
+        {
+            std::lock_guard lock{shard.mutex};
+            shard.batches.push_back(std::move(shard.rows));
+
+            if (shard.writing == nullptr) {
+                shard.writing = sealed;
+                pool->push(shard.home, work{&start, &shard, 0});
+            } else {
+                shard.sealed.push_back(sealed);
+            }
+        }
+
+        shard.rows = refill(shard);
+    }
+
+    // next empty batch, allocated until queue depth batches are in flight
+    std::unique_ptr<batch> refill(shard& shard) {
+        batch* next = nullptr;
+
+        const auto take = [&] {
+            std::lock_guard lock{shard.mutex};
+            if (shard.free.empty()) {
+                return false;
+            }
+            next = shard.free.back();
+            shard.free.pop_back();
+            return true;
+        };
+
+        if (!take()) {
+            if (shard.allocated < queue_depth) {
+                shard.allocated += 1;
+                return std::make_unique<batch>(batch_size);
+            }
+            // a failed pool still hands batches back, but the run is over
+            wait_until([&] { return take() || pool->failed.load(std::memory_order_acquire); }, starved);
+
+            if (next == nullptr) {
+                pool->rethrow();
+            }
+        }
+
+        std::lock_guard lock{shard.mutex};
+        const auto found = std::find_if(shard.batches.begin(), shard.batches.end(), [next](const auto& pending) { return pending.get() == next; });
+        auto refilled = std::move(*found);
+        shard.batches.erase(found);
+
+        return refilled;
+    }
+
+    // open the row group on the home worker and fan out one task per column, after a failure batches are only handed back
+    static void start(void* owner, std::size_t, const std::size_t worker) {
+        auto& shard = *static_cast<sharded_writer::shard*>(owner);
+        auto& rows = *shard.writing;
+
+        if (shard.owner->pool->failed.load(std::memory_order_acquire)) {
+            release(shard, worker);
+            return;
+        }
+
+        std::size_t written = 0;
+        try {
+            rows.pad();
+
+            const auto row_group = shard.writer.open_row_group(rows.size);
+            shard.columns.assign(batch::column_count, nullptr);
+            for (std::size_t index = 0; index < batch::column_count; ++index) {
+                if (shard.writer.projected.keeps(index)) {
+                    shard.columns[index] = row_group->column(static_cast<int>(written++));
+                }
+            }
+        }
+        catch (...) {
+            release(shard, worker);
+            throw;
+        }
+
+        if (written == 0) {
+            finish(shard, worker);
+            return;
+        }
+
+        shard.remaining.store(written, std::memory_order_release);
+        for (std::size_t index = 0; index < batch::column_count; ++index) {
+            if (shard.columns[index] != nullptr) {
+                shard.owner->pool->push(worker, work{&encode, &shard, index});
+            }
+        }
+    }
+
+    // any worker, column writers of a buffered row group are independent
+    static void encode(void* owner, const std::size_t index, const std::size_t worker) {
+        auto& shard = *static_cast<sharded_writer::shard*>(owner);
+
+        // a failed column still counts as done, or the batch would never be handed back
+        try {
+            timed_stage timer{stage::encode};
+            shard.writing->write_column(index, shard.columns[index]);
+        }
+        catch (...) {
+            if (shard.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                release(shard, worker);
+            }
+            throw;
+        }
+
+        if (shard.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            finish(shard, worker);
+        }
+    }
+
+    // last column done, close the row group when full and start the next sealed batch
+    static void finish(shard& shard, const std::size_t worker) {
+        try {
+            if (!shard.owner->pool->failed.load(std::memory_order_acquire)) {
+                shard.writer.check_row_group();
+            }
+        }
+        catch (...) {
+            release(shard, worker);
+            throw;
+        }
+
+        release(shard, worker);
+    }
+
+    // the written or abandoned batch goes back to the decoder
+    static void release(shard& shard, const std::size_t worker) {
+        shard.writing->clear();
+
+        std::lock_guard lock{shard.mutex};
+        shard.free.push_back(shard.writing);
+        shard.writing = nullptr;
+
+        if (!shard.sealed.empty()) {
+            shard.writing = shard.sealed.front();
+            shard.sealed.pop_front();
+            shard.owner->pool->push(worker, work{&start, &shard, 0});
+        }
+    }
+
+    [[nodiscard]] bool idle(shard& shard) {
+        std::lock_guard lock{shard.mutex};
+        return shard.writing == nullptr;
+    }
+
+    // drain every shard, then finish the files
+    void close() {
+        for (auto& shard : shards) {
+            seal(*shard);
+        }
+
+        // failed shards still hand their batches back, so every shard drains
+        stall draining;
+        for (auto& shard : shards) {
+            wait_until([&] { return idle(*shard); }, draining);
+        }
+
+        // a shared pool keeps running for the other writers, idle shards already have no task on it
+        if (own_pool) {
+            own_pool->stop();
+        }
+
+        if (pool->failed.load(std::memory_order_acquire)) {
+            pool->rethrow();
+        }
+
+        for (auto& shard : shards) {
+            shard->writer.close();
+        }
+    }
+
+    void report(std::ostream& out) const {
+        out << "shards: " << shards.size() << " files, " << pool->executed.load() << " tasks, " << pool->stolen.load() << " stolen" << std::endl;
+        out << "  decoder stalls, waiting for batch: " << starved << std::endl;
+
+        for (const auto& shard : shards) {
+            shard->writer.report(out);
+        }
+    }
+};
+
+///////////////////////////////////////////////////////////////////////
+// partitioned dataset
+///////////////////////////////////////////////////////////////////////
+
+// hive partition columns, in directory order
+enum class partition_column { date, message_type, bucket };
+
+// partition columns of a spec, ie date=/message_type=/locate_bucket=, bucket is the instrument bucket column of the feed
+inline std::vector<partition_column> partitioning_named(const std::string_view spec, const std::string_view bucket) {
+    std::vector<partition_column> columns;
+
+    for (std::size_t start = 0; start < spec.size();) {
+        const auto end = std::min(spec.find('/', start), spec.size());
+        auto name = spec.substr(start, end - start);
+        if (name.ends_with('=')) {
+            name.remove_suffix(1);
+        }
+
+        if (name == "date") {
+            columns.push_back(partition_column::date);
+        }
+        else if (name == "message_type") {
+            columns.push_back(partition_column::message_type);
+        }
+        else if (name == bucket) {
+            columns.push_back(partition_column::bucket);
+        }
+        else if (!name.empty()) {
+            throw std::invalid_argument("Unknown partition column " + std::string{name});
+        }
+
+        start = end + 1;
+    }
+
+    return columns;
+}
+
+// partition of one row, columns outside the spec stay zero
+struct partition_key {
+    std::int64_t day = 0; // utc days since the epoch, plus one so zero has no event time
+    char type = 0;
+    std::uint64_t bucket = 0; // under 2^24
+
+    [[nodiscard]] std::uint64_t packed() const {
+        return static_cast<std::uint64_t>(day) << 32 | static_cast<std::uint64_t>(static_cast<std::uint8_t>(type)) << 24 | bucket;
+    }
+};
+
+// wide rows fanned out to hive partitioned parquet files under a dataset root, buffered per partition and written a whole batch at a time
+// the least recently written file closes once too many are open
+//   a partition written to again after its file closed continues in the next numbered file, ie date=2024-01-05/message_type=A/locate_bucket=3/itch.0001.parquet
+//   numbering continues after the files of earlier runs, so runs into the same root accumulate
+//   _metadata at the root summarizes the row groups of every file for engines that plan from it
+template <typename batch>
+struct partitioned_writer {
+
+    static constexpr std::uint64_t max_buckets = 1 << 24;
+
+    struct partition {
+        std::string directory; // relative to the root
+        std::string file; // open file, relative to the root
+        std::size_t files = 0; // numbers the next file
+        std::unique_ptr<batch_writer<batch>> writer;
+        std::unique_ptr<batch> rows; // appended since the last full batch, grown as rows arrive
+        std::int64_t charged = 0; // bytes of rows held against the memory budget
+        std::uint64_t used = 0; // rows appended to the dataset as of the last batch written here
+    };
+
+    std::filesystem::path root;
+    std::string stem; // file name prefix, ie itch of itch.0000.parquet
+    std::string bucket_name;
+    std::vector<partition_column> columns;
+    std::uint64_t buckets;
+    std::size_t max_open;
+    std::shared_ptr<parquet::WriterProperties> properties;
+    row_group_budget* budget;
+    std::size_t batch_size;
+    projection projected;
+
+    std::unordered_map<std::uint64_t, partition> partitions;
+    std::size_t open = 0;
+    std::uint64_t rows = 0;
+    std::uint64_t evictions = 0; // files closed to stay under max_open
+    std::uint64_t early = 0; // buffers written before a full batch to stay under the memory budget
+    std::vector<std::pair<std::string, std::shared_ptr<parquet::FileMetaData>>> written; // closed files of this run
+    row_group_summary summary;
+
+    partitioned_writer(const options& options, std::shared_ptr<parquet::WriterProperties> properties, row_group_budget& budget, const std::size_t batch_size, const std::string_view bucket_name)
+        : root{options.dataset}
+        , stem{std::filesystem::path{options.parquet_file}.stem().string()}
+        , bucket_name{bucket_name}
+        , columns{partitioning_named(options.partitioning, bucket_name)}
+        , buckets{std::clamp<std::uint64_t>(options.partition_buckets, 1, max_buckets)}
+        , max_open{options.partition_files > 0 ? options.partition_files : descriptor_budget()}
+        , properties{std::move(properties)}
+        , budget{&budget}
+        , batch_size{batch_size}
+        , projected{batch::project(options.write_columns)} {
+        if (!remote(options.dataset)) {
+            std::filesystem::create_directories(root);
+        }
+    }
+
+    // half the open file limit, the rest is left to captures, sidecars and the other outputs
+    static std::size_t descriptor_budget() {
+        rlimit limit{};
+        if (getrlimit(RLIMIT_NOFILE, &limit) != 0 || limit.rlim_cur == RLIM_INFINITY) {
+            return 1 << 15;
+        }
+        return std::max<std::size_t>(static_cast<std::size_t>(limit.rlim_cur) / 2, 1);
+    }
+
+    template <typename record>
+    [[nodiscard]] partition_key key_of(const record& row, const std::uint64_t instrument) const {
+        partition_key key;
+
+        for (const auto column : columns) {
+            switch (column) {
+                case partition_column::date:
+                    if (row.event_timestamp.data) {
+                        key.day = std::chrono::floor<std::chrono::days>(*row.event_timestamp.data).count() + 1;
+                    }
+                    break;
+                case partition_column::message_type:
+                    key.type = row.message_type.data;
+                    break;
+                case partition_column::bucket:
+                    key.bucket = instrument % buckets;
+                    break;
+            }
+        }
+
+        return key;
+    }
+
+    // hive directory of a partition, rows without an event time go to the default partition
+    [[nodiscard]] std::string directory_of(const partition_key& key) const {
+        std::filesystem::path directory;
+
+        for (const auto column : columns) {
+            switch (column) {
+                case partition_column::date: {
+                    if (key.day == 0) {
+                        directory /= "date=__HIVE_DEFAULT_PARTITION__";
+                        break;
+                    }
+                    const std::chrono::year_month_day date{std::chrono::sys_days{std::chrono::days{key.day - 1}}};
+                    char text[24];
+                    std::snprintf(text, sizeof(text), "date=%04d-%02u-%02u", static_cast<int>(date.year()), static_cast<unsigned>(date.month()), static_cast<unsigned>(date.day()));
+                    directory /= text;
+                    break;
+                }
+                case partition_column::message_type:
+                    directory /= "message_type=" + std::string(1, key.type);
+                    break;
+                case partition_column::bucket:
+                    directory /= bucket_name + "=" + std::to_string(key.bucket);
+                    break;
+            }
+        }
+
+        return directory.string();
+    }
+
+    // feed order is kept within each partition, interleaved partitions only touch their files once a batch fills
+    template <typename record>
+    void append(const record& row, const std::uint64_t instrument) {
+        const auto key = key_of(row, instrument);
+        const auto [found, added] = partitions.try_emplace(key.packed());
+        auto& target = found->second;
+
+        if (added) {
+            target.directory = directory_of(key);
+            target.files = next_file(target.directory);
+        }
+        if (!target.rows) {
+            target.rows = std::make_unique<batch>();
+        }
+
+        rows += 1;
+        target.rows->append(row);
+
+        if (target.rows->size == batch_size) {
+            spill(target);
+        }
+
+        // column capacities double, so they are measured again when the row count reaches a power of two, or zero once spilled
+        const auto size = target.rows->size;
+        if ((size & (size - 1)) == 0 && charge(target)) {
+            shrink();
+        }
+    }
+
+    // true when the rows held by every partition and the open row groups are over the memory budget
+    [[nodiscard]] bool charge(partition& target) {
+        const auto bytes = target.rows ? static_cast<std::int64_t>(target.rows->allocated_bytes()) : 0;
+        const auto over = budget->charge(target.charged, bytes);
+        target.charged = bytes;
+        return over;
+    }
+
+    // write the largest buffer and free it, a partition that fills again starts small
+    void shrink() {
+        partition* largest = nullptr;
+        for (auto& [key, candidate] : partitions) {
+            if (candidate.rows && !candidate.rows->empty() && (largest == nullptr || candidate.charged > largest->charged)) {
+                largest = &candidate;
+            }
+        }
+        if (largest == nullptr) {
+            return;
+        }
+
+        early += 1;
+        spill(*largest);
+        largest->rows.reset();
+        (void)charge(*largest);
+    }
+
+    // one past the highest stem.NNNN.parquet already in a partition directory
+    [[nodiscard]] std::size_t next_file(const std::string& directory) const {
+        std::size_t next = 0;
+        const auto prefix = stem + ".";
+        constexpr std::string_view suffix = ".parquet";
+
+        for (const auto& name : file_names((root / directory).string())) {
+            if (name.size() <= prefix.size() + suffix.size() || !name.starts_with(prefix) || !name.ends_with(suffix)) {
+                continue;
+            }
+
+            const auto digits = std::string_view{name}.substr(prefix.size(), name.size() - prefix.size() - suffix.size());
+            std::size_t index = 0;
+            const auto [end, error] = std::from_chars(digits.data(), digits.data() + digits.size(), index);
+            if (error == std::errc{} && end == digits.data() + digits.size()) {
+                next = std::max(next, index + 1);
+            }
+        }
+
+        return next;
+    }
+
+    // buffered rows to the partition's file, opened again when it was closed
+    void spill(partition& target) {
+        if (!target.rows || target.rows->empty()) {
+            return;
+        }
+
+        if (!target.writer) {
+            reopen(target);
+        }
+
+        target.used = rows;
+        target.writer->write(*target.rows);
+        target.rows->clear();
+    }
+
+    // the writer's own buffer stays empty, rows arrive as whole batches
+    void reopen(partition& target) {
+        if (open == max_open) {
+            evict();
+        }
+
+        char name[24];
+        std::snprintf(name, sizeof(name), ".%04zu.parquet", target.files++);
+        target.file = (std::filesystem::path{target.directory} / (stem + name)).string();
+
+        if (!remote(root.string())) {
+            std::filesystem::create_directories(root / target.directory);
+        }
+        target.writer = std::make_unique<batch_writer<batch>>((root / target.file).string(), properties, *budget, 1, nullptr, projected);
+        open += 1;
+    }
+
+    // close the least recently written file
+    void evict() {
+        partition* oldest = nullptr;
+        for (auto& [key, candidate] : partitions) {
+            if (candidate.writer && (oldest == nullptr || candidate.used < oldest->used)) {
+                oldest = &candidate;
+            }
+        }
+
+        evictions += 1;
+        finish(*oldest);
+    }
+
+    void finish(partition& target) {
+        target.writer->flush();
+        target.writer->close();
+        summary.add(target.writer->summary);
+
+        auto metadata = target.writer->file->metadata();
+        metadata->set_file_path(target.file);
+        written.emplace_back(target.file, std::move(metadata));
+
+        target.writer.reset();
+        open -= 1;
+    }
+
+    // required to finish every open file and the _metadata summary
+    void close() {
+        for (auto& [key, target] : partitions) {
+            spill(target);
+            target.rows.reset();
+            (void)charge(target);
+        }
+
+        for (auto& [key, target] : partitions) {
+            if (target.writer) {
+                finish(target);
+            }
+        }
+
+        write_metadata();
+    }
+
+    // row groups of earlier runs stay in the summary unless this run rewrote their file or changed the schema, local or object store roots alike
+    void write_metadata() {
+        if (written.empty()) {
+            return;
+        }
+
+        const auto path = root / "_metadata";
+        std::shared_ptr<parquet::FileMetaData> combined;
+
+        if (const auto existing = open_existing(path.string())) {
+            const auto previous = parquet::ReadMetaData(existing);
+
+            if (previous->schema()->Equals(*written.front().second->schema())) {
+                std::vector<int> kept;
+                for (int index = 0; index < previous->num_row_groups(); ++index) {
+                    const auto group = previous->RowGroup(index);
+                    const auto file = group->num_columns() > 0 ? group->ColumnChunk(0)->file_path() : std::string{};
+                    if (std::none_of(written.begin(), written.end(), [&](const auto& rewritten) { return rewritten.first == file; })) {
+                        kept.push_back(index);
+                    }
+                }
+                combined = previous->Subset(kept);
+            }
+        }
+
+        for (const auto& [file, metadata] : written) {
+            if (combined) {
+                combined->AppendRowGroups(*metadata);
+            } else {
+                combined = metadata;
+            }
+        }
+
+        const auto out = open_file(path.string());
+        parquet::WriteMetaDataFile(*combined, out.get());
+        PARQUET_THROW_NOT_OK(out->Close());
+    }
+
+    void report(std::ostream& out) const {
+        out << "dataset " << root.string() << ": " << partitions.size() << " partitions, " << written.size() << " files, "
+            << evictions << " closed early to stay under " << max_open << " open, " << early << " buffers written early to stay under the memory budget, " << summary << std::endl;
+    }
+};
+
+// writer state the converters of one run share, null members are made by each converter for itself
+struct shared_writers {
+    row_group_budget* budget = nullptr;
+    pipeline* encoders = nullptr;
+    work_pool* workers = nullptr; // shard columns
+};
+
+// itch converter
+struct converter {
+
+    std::optional<row_group_budget> own_budget; // outlives every writer charging it
+    row_group_budget* budget; // own_budget, or one the run shares and keeps alive longer
+    feed::record record;
+    batch_writer<feed::record_batch> table;
+    std::shared_ptr<parquet::WriterProperties> properties;
+    std::unique_ptr<narrow_tables> narrow;
+    feed::instrument_directory directory;
+    feed::event_clock clock;
+    std::optional<feed::order_book> orders;
+    std::unique_ptr<sharded_writer<feed::record_batch>> sharded;
+    std::unique_ptr<partitioned_writer<feed::record_batch>> partitioned;
+    std::size_t batch_size;
+    bool wide;
+    input_format input;
+    arbiter lines; // a and b line arbitration and sequence gaps
+    bool carried = false; // lines continue in a later converter, which finalises the open gaps and reports the arbiter
+    bool reports = false; // end of run summaries to stderr, only when --stats asks for statistics
+    std::unique_ptr<parquet::ParquetFileWriter> gap_file;
+    std::vector<arbiter::gap> gap_rows; // written as one row group on close
+    bool gap_table = false;
+    std::unique_ptr<pipeline> own_encoders; // joined before the tables it writes are destroyed
+    pipeline* encoders = nullptr; // own_encoders, or one the run shares and finishes itself
+    std::unique_ptr<arrow_sink<feed::record_batch>> arrow;
+    thread_statistics* counters = &statistics::local(); // of the decoding thread
+    std::array<bool, 256> converts{}; // message types decoded into rows, by type character
+
+    explicit converter(const options& options, const shared_writers& shared = {}) : budget{shared.budget}, record{}, properties{writer_properties(options)}, batch_size{options.batch_size == 0 ? default_batch_size : options.batch_size}, wide{options.wide}, input{input_named(options.format)}, reports{!options.stats_file.empty()} {
+        if (budget == nullptr) {
+            budget = &own_budget.emplace(options);
+        }
+
+        encoders = shared.encoders;
+        if (encoders == nullptr && options.encoder_threads > 0) {
+            own_encoders = std::make_unique<pipeline>(options.queue_depth, options.encoder_threads);
+            encoders = own_encoders.get();
+        }
+
+        if (wide && !options.dataset.empty()) {
+            partitioned = std::make_unique<partitioned_writer<feed::record_batch>>(options, properties, *budget, batch_size, feed::instrument_partition);
+        }
+        else if (wide && options.shards > 0) {
+            sharded = std::make_unique<sharded_writer<feed::record_batch>>(options, properties, *budget, options.shards, batch_size, shared.workers);
+        }
+        else if (wide) {
+            table = batch_writer<feed::record_batch>{options.parquet_file, properties, *budget, batch_size, encoders, feed::record_batch::project(options.write_columns)};
+        }
+
+        if (options.orders) {
+            orders.emplace();
+        }
+
+        converts.fill(options.write_types.empty());
+        for (const auto type : options.write_types) {
+            if (feed::all_messages::name_of(type) == nullptr) {
+                throw std::invalid_argument("Unknown message type " + std::string(1, type));
+            }
+            converts[static_cast<std::uint8_t>(type)] = true;
+        }
+
+        lines.drop_duplicates = options.arbitrate;
+        lines.window = std::chrono::milliseconds{options.gap_window_ms};
+
+        if (options.wide || options.narrow) {
+            gap_table = true;
+            gap_file = parquet::ParquetFileWriter::Open(open_file(message_file(options.parquet_file, "gaps")), arbiter::schema(), properties);
+        }
+
+        if (options.narrow) {
+            narrow = std::make_unique<narrow_tables>(options, properties, *budget, batch_size, encoders);
+        }
+
+        if (arrow_outputs(options)) {
+            arrow = std::make_unique<arrow_sink<feed::record_batch>>(options, batch_size);
+        }
+    }
+
+    // return udp payload and length by skipping headers in a packet, false unless a whole moldudp64 header was captured
+    bool try_get_itch(const u_char *packet, const std::uint32_t caplen, u_char **payload, std::int32_t *length) {
+
+        record.pcap_index.increment();
+
+        datagram datagram;
+        if (read_datagram(packet, caplen, &datagram) && datagram.length >= capture::moldudp64_header_size) {
+            *payload = const_cast<u_char*>(datagram.payload);
+            *length = static_cast<std::int32_t>(datagram.length);
+
+            return true;
+        }
+
+        *length = 0;
+        *payload = nullptr;
+
+        return false;
+    }
+
+    // process libpcap packet
+    void process(const pcap_pkthdr* header, const u_char* packet) {
+        record.pcap_timestamp.set(header);
+        counters->packets.add(1);
+        counters->bytes.add(header->caplen);
+        process(packet, header->caplen);
+    }
+
+    // process memory mapped packet
+    void process(const packet_header& header, const u_char* packet) {
+        record.pcap_timestamp.set(header.timestamp);
+        counters->packets.add(1);
+        counters->bytes.add(header.caplen);
+        process(packet, header.caplen);
+    }
+
+    // moldudp64 payload of a packet in the input framing
+    bool payload(const u_char* packet, const std::uint32_t caplen, u_char** current, std::int32_t* length) {
+        if (input == input_format::moldudp64) {
+            record.pcap_index.increment();
+            *current = const_cast<u_char*>(packet);
+            *length = static_cast<std::int32_t>(caplen);
+            return true;
+        }
+        return try_get_itch(packet, caplen, current, length);
+    }
+
+    // message types the directory, order book or event clock are built from
+    [[nodiscard]] bool primes(const char type) const {
+        return feed::primes(type, orders.has_value());
+    }
+
+    // directory and tracked order messages of a primed packet
+    void prime_message(u_char* message) {
+        record.message_type.set(&message);
+
+        const auto type = record.message_type.data;
+
+        if (primes(type)) {
+            record.reset();
+            process(&message, type);
+
+            if (orders) {
+                orders->apply(record);
+            }
+
+            clock.enrich(record);
+        }
+    }
+
+    // message of a type not converted, converter state still sees it but no row is written
+    void skip_message(u_char** message) {
+        const auto type = record.message_type.data;
+
+        if (primes(type)) {
+            process(message, type);
+
+            if (orders) {
+                orders->apply(record);
+            }
+
+            clock.enrich(record);
+            clear();
+        }
+    }
+
+    // whether a message of length bytes holds its type and every field of that type
+    static bool whole(const u_char* message, const std::uint32_t length) {
+        return length > 0 && length >= feed::all_messages::wire_size(static_cast<char>(*message));
+    }
+
+    // binaryfile message, without a moldudp64 header every message is its own frame and numbered in file order
+    void process_file_message(const u_char* packet, stopwatch& watch) {
+        auto current = const_cast<u_char*>(packet);
+        u_char* message = nullptr;
+
+        // a file holds one message per record so the sequence follows pcap_index, which chunks and checkpoints resume
+        record.pcap_index.increment();
+        record.message_sequence.data = record.pcap_index.data;
+        record.message_index.count = 1;
+        record.message_index.data = 1;
+
+        record.message_length.set(&current, &message);
+
+        // the reader keeps message_length inside the mapping, the type's layout must fit in it too
+        if (!whole(message, record.message_length.data)) {
+            counters->truncated.add(1);
+            return;
+        }
+
+        record.message_type.set(&message);
+        counters->messages[static_cast<std::uint8_t>(record.message_type.data)].add(1);
+        watch.lap(stage::parse);
+
+        if (!converts[static_cast<std::uint8_t>(record.message_type.data)]) {
+            skip_message(&message);
+            return;
+        }
+
+        process(&message, record.message_type.data);
+        watch.lap(stage::decode);
+
+        write();
+        watch.lap(stage::append);
+        clear();
+    }
+
+    // final sequence gaps to the sidecar table
+    void drain() {
+        if (gap_table) {
+            gap_rows.insert(gap_rows.end(), lines.closed.begin(), lines.closed.end());
+        }
+        lines.closed.clear();
+    }
+
+    // directory and tracked order messages only, builds converter state ahead of a parallel chunk
+    void prime(const u_char* packet, const std::uint32_t caplen) {
+
+        std::int32_t length = 0;
+        u_char* current = nullptr;
+        u_char* message = nullptr;
+
+        if (input == input_format::binaryfile) {
+            current = const_cast<u_char*>(packet);
+            record.message_length.set(&current, &message);
+
+            if (!whole(message, record.message_length.data)) {
+                counters->truncated.add(1);
+                return;
+            }
+
+            prime_message(message);
+            return;
+        }
+
+        if (payload(packet, caplen, &current, &length)) {
+
+            const auto end = current + length;
+
+            record.session.set(&current);
+            record.message_sequence.set(&current);
+            record.message_index.set(&current);
+
+            const auto first = record.message_sequence.data;
+            const auto verdict = lines.arbitrate(record.session.data, first, record.message_index.count, record.pcap_timestamp.data);
+            lines.closed.clear();
+
+            if (verdict == arbiter::verdict::none) {
+                return;
+            }
+
+            while (record.message_index.increment()) {
+
+                // the rest of a packet cut short is dropped
+                if (end - current < 2 || capture::read_be16(current) > end - current - 2) {
+                    counters->truncated.add(1);
+                    break;
+                }
+
+                record.message_length.set(&current, &message);
+
+                if (verdict == arbiter::verdict::some && !lines.accepts(first + record.message_index.data - 1)) {
+                    continue;
+                }
+
+                if (!whole(message, record.message_length.data)) {
+                    counters->truncated.add(1);
+                    continue;
+                }
+
+                prime_message(message);
+            }
+        }
+    }
+
+    // process itch packet
+    void process(const u_char* packet, const std::uint32_t caplen) {
+
+        stopwatch watch{counters};
+
+        if (input == input_format::binaryfile) {
+            process_file_message(packet, watch);
+            return;
+        }
+
+        std::int32_t length = 0;
+        u_char* current = nullptr;
+        u_char* message = nullptr;
+
+        if (payload(packet, caplen, &current, &length)) {
+
+            const auto end = current + length;
+
+            record.session.set(&current);
+            record.message_sequence.set(&current);
+            record.message_index.set(&current);
+
+            // duplicates are dropped before any field is decoded
+            const auto first = record.message_sequence.data;
+            const auto verdict = lines.arbitrate(record.session.data, first, record.message_index.count, record.pcap_timestamp.data);
+
+            if (!lines.closed.empty()) {
+                drain();
+            }
+
+            watch.lap(stage::parse);
+
+            if (verdict == arbiter::verdict::none) {
+                return;
+            }
+
+            while (record.message_index.increment()) {
+
+                // the rest of a packet cut short is dropped
+                if (end - current < 2 || capture::read_be16(current) > end - current - 2) {
+                    counters->truncated.add(1);
+                    break;
+                }
+
+                record.message_length.set(&current, &message);
+
+                if (verdict == arbiter::verdict::some && !lines.accepts(first + record.message_index.data - 1)) {
+                    record.message_sequence.increment();
+                    continue;
+                }
+
+                // a message shorter than its type's layout is counted and never decoded
+                if (!whole(message, record.message_length.data)) {
+                    record.message_sequence.increment();
+                    counters->truncated.add(1);
+                    continue;
+                }
+
+                record.message_type.set(&message);
+                record.message_sequence.increment();
+                counters->messages[static_cast<std::uint8_t>(record.message_type.data)].add(1);
+
+                // the next message is found from message_length whatever this one is
+                if (!converts[static_cast<std::uint8_t>(record.message_type.data)]) {
+                    skip_message(&message);
+                    continue;
+                }
+
+                process(&message, record.message_type.data);
+                watch.lap(stage::decode);
+
+                write();
+                watch.lap(stage::append);
+                clear();
+            }
+        }
+        else {
+            counters->non_udp.add(1);
+        }
+    }
+
+    // decode a message through the feed's switch on its type
+    void process(u_char **message, const char message_type) {
+        if (!feed::dispatch(*this, message, message_type)) {
+            counters->unknown.add(1);
+        }
+    }
+
+    // decode one message type from its field list
+    template <typename definition>
+    void process_message(u_char **message) {
+        definition::fields::decode(record, message);
+    }
+
+    void process_directory_message(u_char **message) {
+        process_message<feed::directory_message>(message);
+
+        directory.add(record);
+    }
+
+    // write decoded message record
+    void write() {
+        if (orders) {
+            orders->apply(record);
+        }
+
+        directory.enrich(record);
+        clock.enrich(record);
+
+        if (narrow) {
+            narrow->append(record);
+        }
+
+        if (arrow) {
+            arrow->append(record);
+        }
+
+        if (!wide) {
+            return;
+        }
+
+        if (sharded) {
+            sharded->append(record, feed::instrument(record));
+            return;
+        }
+
+        if (partitioned) {
+            partitioned->append(record, feed::instrument(record));
+            return;
+        }
+
+        table.append(record);
+    }
+
+    // reset only what the message set, every other field is still null
+    void clear() {
+        feed::all_messages::reset(record);
+        feed::enrichment_fields::reset(record);
+    }
+
+    // partial arrow batches of a live session go out once they have waited long enough
+    void tick() {
+        if (arrow) {
+            arrow->tick(std::chrono::steady_clock::now());
+        }
+    }
+
+    // hand the last rows to the writers, a shared pipeline is finished only once every converter using it has flushed
+    void flush() {
+        if (!carried) {
+            lines.finish();
+        }
+        drain();
+
+        if (!carried && reports) {
+            std::cerr << "arbiter: " << lines << std::endl;
+        }
+
+        if (gap_table) {
+            arbiter::write(*gap_file, gap_rows);
+            gap_file->Close();
+        }
+
+        if (arrow) {
+            arrow->close();
+            if (reports) {
+                arrow->report(std::cerr);
+            }
+        }
+
+        if (narrow) {
+            narrow->flush();
+        }
+
+        if (wide && !sharded && !partitioned) {
+            table.flush();
+        }
+    }
+
+    // close the files once the pipeline has written every batch
+    void close_files() {
+        if (narrow) {
+            narrow->close();
+            if (reports) {
+                narrow->report(std::cerr);
+            }
+        }
+
+        if (!wide) {
+            return;
+        }
+
+        if (sharded) {
+            sharded->close();
+            if (reports) {
+                sharded->report(std::cerr);
+            }
+            return;
+        }
+
+        if (partitioned) {
+            partitioned->close();
+            if (reports) {
+                partitioned->report(std::cerr);
+            }
+            return;
+        }
+
+        table.close();
+        if (reports) {
+            table.report(std::cerr);
+        }
+    }
+
+    // required to finish parquet file
+    void close() {
+        flush();
+
+        if (own_encoders) {
+            own_encoders->finish();
+            if (reports) {
+                own_encoders->report(std::cerr);
+            }
+        }
+
+        close_files();
+    }
+};
+
+// byte range of the capture converted by one thread
+struct chunk {
+    capture::cursor start;
+    std::size_t end = 0;
+    std::uint64_t pcap_index = 0; // packets before the chunk
+};
+
+// pre scan packet boundaries and split the capture into count ranges of similar size, packets are counted after the filter as the chunks read them
+inline std::vector<chunk> split(const std::string& pcap_file, const std::size_t count, const input_format input, std::shared_ptr<const packet_filter> filter) {
+    capture capture{pcap_file, input};
+    capture.filter = std::move(filter);
+
+    std::vector<chunk> chunks;
+    chunks.push_back(chunk{capture.position(), 0, 0});
+
+    const auto target = capture.size / count;
+
+    packet_header header;
+    const u_char* packet;
+    std::uint64_t packets = 0;
+
+    while (true) {
+        if (chunks.size() < count && static_cast<std::size_t>(capture.current - capture.begin) >= target * chunks.size()) {
+            chunks.push_back(chunk{capture.position(), 0, packets});
+        }
+
+        if (!capture.next(&header, &packet)) {
+            break;
+        }
+        packets += 1;
+    }
+
+    // short captures leave trailing chunks empty, so part numbering stays fixed
+    while (chunks.size() < count) {
+        chunks.push_back(chunk{capture.position(), 0, packets});
+    }
+
+    for (std::size_t index = 0; index + 1 < chunks.size(); ++index) {
+        chunks[index].end = chunks[index + 1].start.offset;
+    }
+    chunks.back().end = capture.size;
+
+    return chunks;
+}
+
+// converter state carried into a parallel chunk
+struct chunk_state {
+    decltype(converter::directory) directory;
+    decltype(converter::orders) orders;
+    decltype(converter::lines) lines;
+    decltype(converter::clock) clock;
+};
+
+// state as of each chunk start, handed to start as soon as the primer reaches it so chunks convert while later ones are primed
+// each chunk gets its own copy, the last one takes the primer's state
+template <typename started>
+void prime(const options& options, const std::vector<chunk>& chunks, started&& start) {
+    auto primer_options = options;
+    primer_options.wide = false;
+    primer_options.narrow = false;
+    primer_options.encoder_threads = 0;
+    primer_options.arrow_file.clear();
+    primer_options.feather_file.clear();
+    primer_options.shm_name.clear();
+
+    converter primer(primer_options);
+    capture capture{options.pcap_file, input_named(options.format)};
+    capture.filter = packet_filter_of(options);
+
+    packet_header header;
+    const u_char* packet;
+
+    for (std::size_t part = 0; part < chunks.size(); ++part) {
+        while (static_cast<std::size_t>(capture.current - capture.begin) < chunks[part].start.offset && capture.next(&header, &packet)) {
+            primer.record.pcap_timestamp.set(header.timestamp);
+            primer.prime(packet, header.caplen);
+        }
+
+        if (part + 1 == chunks.size()) {
+            start(part, chunk_state{std::move(primer.directory), std::move(primer.orders), std::move(primer.lines), primer.clock});
+        } else {
+            start(part, chunk_state{primer.directory, primer.orders, primer.lines, primer.clock});
+        }
+    }
+}
+
+// convert one chunk into its own part file, pcap index continues from the previous chunk
+// gaps open at the chunk end are primed into the next chunk, only the last one finalises them
+void write_chunk(const options& options, const chunk& chunk, chunk_state state, const bool last) {
+    capture capture{options.pcap_file, input_named(options.format)};
+    capture.filter = packet_filter_of(options);
+    capture.seek(chunk.start, chunk.end);
+
+    converter converter(options);
+    converter.record.pcap_index.set(chunk.pcap_index);
+    converter.directory = std::move(state.directory);
+    converter.orders = std::move(state.orders);
+    converter.lines = std::move(state.lines);
+    converter.clock = state.clock;
+    converter.carried = !last;
+
+    packet_header header;
+    const u_char* packet;
+
+    while (capture.next(&header, &packet)) {
+        converter.process(header, packet);
+    }
+
+    converter.close();
+}
+
+// convert chunks of the capture on separate threads, each starting once its state is primed
+// with --orders priming decodes every order message before the last chunk, so that pass bounds the speedup
+void write_parallel(const options& options) {
+    const auto chunks = split(options.pcap_file, options.threads, input_named(options.format), packet_filter_of(options));
+
+    std::vector<std::exception_ptr> errors(chunks.size());
+    std::vector<std::thread> threads;
+
+    const auto start = [&](const std::size_t part, chunk_state&& state) {
+        threads.emplace_back([&, part, state = std::move(state)]() mutable {
+            try {
+                auto chunk_options = part_options(options, part);
+                chunk_options.memory_budget = options.memory_budget / static_cast<std::int64_t>(chunks.size());
+                write_chunk(chunk_options, chunks[part], std::move(state), part + 1 == chunks.size());
+            }
+            catch (...) {
+                errors[part] = std::current_exception();
+            }
+        });
+    };
+
+    std::exception_ptr primed;
+    try {
+        prime(options, chunks, start);
+    }
+    catch (...) {
+        primed = std::current_exception();
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (primed) {
+        std::rethrow_exception(primed);
+    }
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+// state file of a checkpoint after parts closed part files, the previous one is removed once the checkpoint moves past it
+inline std::string state_file(const std::string& checkpoint_file, const std::size_t parts) {
+    return checkpoint_file + ".state." + std::to_string(parts);
+}
+
+// every type save_state writes raw
+inline constexpr auto state_layout() {
+    using orders = decltype(converter::orders)::value_type;
+    using index = decltype(orders::index);
+    using pool = decltype(orders::pool);
+    using lines = decltype(converter::lines);
+    using line = decltype(lines::lines)::value_type;
+
+    return snapshot::layout<
+        std::size_t,
+        bool,
+        decltype(decltype(converter::directory)::listings)::value_type,
+        decltype(index::slots)::value_type,
+        decltype(index::mask),
+        decltype(index::count),
+        decltype(index::shift),
+        decltype(pool::orders)::value_type,
+        decltype(pool::free)::value_type,
+        decltype(line::session),
+        decltype(line::next),
+        decltype(line::open)::value_type,
+        decltype(lines::packets),
+        decltype(converter::clock)>();
+}
+
+// directory, live orders, lines and event clock, replaced whole by a synced rename like the checkpoint
+inline void save_state(const std::string& path, const converter& converter) {
+    const auto temporary = path + ".tmp";
+    {
+        std::ofstream out{temporary, std::ios::binary | std::ios::trunc};
+
+        snapshot::write(out, snapshot::magic);
+        snapshot::write(out, state_layout());
+        snapshot::write(out, converter.directory.listings);
+
+        snapshot::write(out, converter.orders.has_value());
+        if (converter.orders) {
+            const auto& index = converter.orders->index;
+            snapshot::write(out, index.slots);
+            snapshot::write(out, index.mask);
+            snapshot::write(out, index.count);
+            snapshot::write(out, index.shift);
+            snapshot::write(out, converter.orders->pool.orders);
+            snapshot::write(out, converter.orders->pool.free);
+        }
+
+        // closed gaps are drained after every packet, so only the open ones are kept
+        const auto& lines = converter.lines;
+        snapshot::write(out, lines.lines.size());
+        for (const auto& line : lines.lines) {
+            snapshot::write(out, line.session);
+            snapshot::write(out, line.next);
+            snapshot::write(out, line.open);
+        }
+        snapshot::write(out, lines.packets);
+        snapshot::write(out, lines.duplicate_packets);
+        snapshot::write(out, lines.duplicate_messages);
+        snapshot::write(out, lines.gaps);
+        snapshot::write(out, lines.missing);
+
+        snapshot::write(out, converter.clock);
+
+        if (!out.flush()) {
+            throw std::runtime_error("Unable to write converter state " + temporary);
+        }
+    }
+    durable_rename(temporary, path);
+}
+
+// restores what save_state wrote, arbitration settings stay those of the converter
+inline void load_state(const std::string& path, converter& converter) {
+    std::ifstream in{path, std::ios::binary};
+    if (!in) {
+        throw std::runtime_error("Missing converter state " + path);
+    }
+
+    auto magic = snapshot::magic;
+    snapshot::read(in, magic);
+    if (!in || magic != snapshot::magic) {
+        throw std::runtime_error("Corrupt converter state " + path);
+    }
+
+    auto layout = state_layout();
+    snapshot::read(in, layout);
+    if (!in || layout != state_layout()) {
+        throw std::runtime_error("Converter state " + path + " was written by a build with a different state layout, convert again without resuming");
+    }
+
+    snapshot::read(in, converter.directory.listings);
+
+    bool tracked = false;
+    snapshot::read(in, tracked);
+    if (in && tracked != converter.orders.has_value()) {
+        throw std::invalid_argument("Converter state " + path + (tracked ? " tracks" : " does not track") + " live orders, resume with the same --orders");
+    }
+    if (converter.orders) {
+        auto& index = converter.orders->index;
+        snapshot::read(in, index.slots);
+        snapshot::read(in, index.mask);
+        snapshot::read(in, index.count);
+        snapshot::read(in, index.shift);
+        snapshot::read(in, converter.orders->pool.orders);
+        snapshot::read(in, converter.orders->pool.free);
+    }
+
+    auto& lines = converter.lines;
+    std::size_t count = 0;
+    snapshot::read(in, count);
+    if (in && count > snapshot::remaining(in)) {
+        in.setstate(std::ios::failbit);
+    }
+    lines.lines.resize(in ? count : 0);
+    for (auto& line : lines.lines) {
+        snapshot::read(in, line.session);
+        snapshot::read(in, line.next);
+        snapshot::read(in, line.open);
+    }
+    snapshot::read(in, lines.packets);
+    snapshot::read(in, lines.duplicate_packets);
+    snapshot::read(in, lines.duplicate_messages);
+    snapshot::read(in, lines.gaps);
+    snapshot::read(in, lines.missing);
+
+    snapshot::read(in, converter.clock);
+
+    if (!in || in.peek() != std::ifstream::traits_type::eof()) {
+        throw std::runtime_error("Corrupt converter state " + path);
+    }
+}
+
+// closed part files synced with their directory before the checkpoint moves past them, object store uploads are durable once closed
+inline void sync_part(const options& numbered) {
+    for (const auto& output : {numbered.parquet_file, numbered.arrow_file, numbered.feather_file}) {
+        if (output.empty() || remote(output)) {
+            continue;
+        }
+
+        // the parquet file and its sidecars, ie itch.part0003.parquet and itch.part0003.gaps.parquet
+        const std::filesystem::path path{output};
+        const auto stem = path.stem().string();
+        const auto directory = parent_of(path);
+
+        for (const auto& entry : std::filesystem::directory_iterator{directory}) {
+            const auto name = entry.path().filename().string();
+            if (entry.is_regular_file() && (name == path.filename().string() || name.starts_with(stem + "."))) {
+                sync_path(entry.path());
+            }
+        }
+        sync_path(directory);
+    }
+}
+
+// convert into part files closed every checkpoint_bytes of capture, the checkpoint is saved after each so a restart resumes after the last closed part
+void write_checkpointed(const options& options) {
+    auto saved = checkpoint::load(options.checkpoint_file);
+    const checkpoint::source source{options.pcap_file, std::filesystem::file_size(options.pcap_file), modified_time(options.pcap_file)};
+
+    if (saved.done(source)) {
+        std::cerr << "checkpoint: " << options.pcap_file << " already converted into parts before " << saved.parts << std::endl;
+        return;
+    }
+
+    if (decompressor::codec_of(options.pcap_file)) {
+        throw std::invalid_argument("Checkpoints need a capture that seeks, " + options.pcap_file + " is compressed");
+    }
+
+    // starting over would overwrite the open part of another capture, or resume one changed since
+    if (saved.open && !saved.resumes(source)) {
+        throw std::invalid_argument("Checkpoint " + options.checkpoint_file + " has part " + std::to_string(saved.parts) + " of " + saved.open->path
+            + " open, " + options.pcap_file + " is a different capture or changed since");
+    }
+
+    const auto input = input_named(options.format);
+    capture capture{options.pcap_file, input};
+    capture.filter = packet_filter_of(options);
+
+    // a part left open by a crash is written again from its start
+    auto current = std::make_unique<converter>(part_options(options, saved.parts));
+
+    if (saved.resumes(source)) {
+        // directory, live orders, lines and event clock as of the checkpoint, restored from its state file rather than read again from the capture
+        load_state(state_file(options.checkpoint_file, saved.parts), *current);
+
+        current->record.pcap_index.set(saved.pcap_index);
+
+        capture.seek(saved.position, capture.size);
+        std::cerr << "checkpoint: resuming " << options.pcap_file << " at byte " << saved.position.offset << " into part " << saved.parts << std::endl;
+    } else {
+        saved.open = source;
+        saved.position = capture.position();
+        saved.pcap_index = 0;
+    }
+
+    packet_header header;
+    const u_char* packet;
+    std::uint64_t bytes = 0;
+
+    while (capture.next(&header, &packet)) {
+        current->process(header, packet);
+        bytes += header.caplen;
+
+        if (options.checkpoint_bytes == 0 || bytes < options.checkpoint_bytes) {
+            continue;
+        }
+
+        // instruments, live orders and feed position continue into the next part
+        auto next = std::make_unique<converter>(part_options(options, saved.parts + 1));
+        next->record.pcap_index = current->record.pcap_index;
+        next->directory = std::move(current->directory);
+        next->orders = std::move(current->orders);
+        next->lines = std::move(current->lines);
+        next->clock = current->clock;
+
+        current->carried = true;
+        current->close();
+        sync_part(part_options(options, saved.parts));
+
+        saved.parts += 1;
+        saved.position = capture.position();
+        saved.pcap_index = next->record.pcap_index.data;
+        save_state(state_file(options.checkpoint_file, saved.parts), *next);
+        saved.save(options.checkpoint_file);
+        std::filesystem::remove(state_file(options.checkpoint_file, saved.parts - 1));
+
+        current = std::move(next);
+        bytes = 0;
+    }
+
+    current->close();
+    sync_part(part_options(options, saved.parts));
+
+    saved.parts += 1;
+    saved.converted.push_back(source);
+    saved.open.reset();
+    saved.save(options.checkpoint_file);
+    std::filesystem::remove(state_file(options.checkpoint_file, saved.parts - 1));
+}
+
+// rolled live file named by its first packet, ie itch.20240105T143000.0002.parquet
+inline std::string live_file(const std::string& parquet_file, const std::chrono::nanoseconds timestamp, const std::size_t file) {
+    const std::filesystem::path path{parquet_file};
+    const auto seconds = static_cast<std::time_t>(std::chrono::duration_cast<std::chrono::seconds>(timestamp).count());
+
+    std::tm time{};
+    gmtime_r(&seconds, &time);
+
+    char suffix[40];
+    const auto length = std::strftime(suffix, sizeof(suffix), ".%Y%m%dT%H%M%S", &time);
+    std::snprintf(suffix + length, sizeof(suffix) - length, ".%04zu", file);
+
+    return (path.parent_path() / (path.stem().string() + suffix + path.extension().string())).string();
+}
+
+// record a multicast group to parquet files rolled by time or captured bytes, closed files are finished on a background thread
+void write_live(const options& options) {
+    ring ring{options.interface, endpoint{options.group}, options.ring_block_size, options.ring_blocks};
+    if (!options.filter.empty()) {
+        ring.attach(packet_filter{options.filter});
+    }
+
+    stop_requested = 0;
+    std::signal(SIGINT, request_stop);
+    std::signal(SIGTERM, request_stop);
+
+    std::unique_ptr<converter> current;
+    std::chrono::nanoseconds opened{0};
+    std::uint64_t bytes = 0;
+    std::size_t files = 0;
+    std::uint64_t missing = 0;
+
+    std::thread closing;
+    std::exception_ptr closing_error;
+
+    const auto finish = [&] {
+        if (closing.joinable()) {
+            closing.join();
+        }
+        if (closing_error) {
+            std::rethrow_exception(closing_error);
+        }
+    };
+
+    // previous file is complete once its footer is written, capture carries on meanwhile
+    const auto retire = [&] {
+        finish();
+        closing = std::thread([&closing_error, done = std::move(current)] {
+            try {
+                done->close();
+            }
+            catch (...) {
+                closing_error = std::current_exception();
+            }
+        });
+    };
+
+    const auto open = [&](const packet_header& header) {
+        auto file_options = options;
+        file_options.parquet_file = live_file(options.parquet_file, header.timestamp, files++);
+
+        // arrow outputs run for the whole session, they move to the next file with the converter state
+        if (current) {
+            file_options.arrow_file.clear();
+            file_options.feather_file.clear();
+            file_options.shm_name.clear();
+        }
+
+        auto next = std::make_unique<converter>(file_options);
+
+        // instruments, live orders and feed position continue into the next file
+        if (current) {
+            next->record.pcap_index = current->record.pcap_index;
+            next->directory = std::move(current->directory);
+            next->orders = std::move(current->orders);
+            next->lines = std::move(current->lines);
+            next->clock = current->clock;
+            next->arrow = std::move(current->arrow);
+            current->carried = true;
+            retire();
+        }
+
+        current = std::move(next);
+        opened = header.timestamp;
+        bytes = 0;
+    };
+
+    const auto roll = [&](const packet_header& header) {
+        return !current
+            || (options.roll_seconds > 0 && header.timestamp - opened >= std::chrono::seconds{options.roll_seconds})
+            || (options.roll_bytes > 0 && bytes >= options.roll_bytes);
+    };
+
+    while (stop_requested == 0) {
+        const auto consumed = ring.next([&](const packet_header& header, const u_char* packet) {
+            if (roll(header)) {
+                open(header);
+            }
+            bytes += header.caplen;
+            current->process(header, packet);
+        }, 100);
+
+        if (current) {
+            current->tick();
+        }
+
+        if (consumed) {
+            if (const auto dropped = ring.statistics(); dropped > 0) {
+                std::cerr << "live: " << dropped << " packets dropped by the kernel, " << ring.drops << " total" << std::endl;
+            }
+        }
+    }
+
+    if (current) {
+        missing = current->lines.missing;
+        retire();
+    }
+    finish();
+
+    ring.statistics();
+    if (!options.stats_file.empty()) {
+        std::cerr << "live: " << files << " files, " << ring.accepted << " of " << ring.packets << " packets, "
+                  << ring.drops << " dropped by the kernel, " << ring.freezes << " ring freezes, " << missing << " messages missing from sequence gaps" << std::endl;
+    }
+}
+
+// what separates channels of a demuxed capture, session alone keeps the a and b lines of a session together for arbitration
+enum class demux_by { channel, session };
+
+inline demux_by demux_named(const std::string_view name) {
+    if (name == "channel") return demux_by::channel;
+    if (name == "session") return demux_by::session;
+    throw std::invalid_argument("Unknown demux " + std::string{name});
+}
+
+// destination group, port and moldudp64 session of a packet, group and port stay zero demuxed by session
+struct channel_key {
+    std::uint32_t address = 0; // network order
+    std::uint16_t port = 0;
+    std::array<char, feed::session::size> session{};
+
+    bool operator==(const channel_key&) const = default;
+};
+
+struct channel_hash {
+    std::size_t operator()(const channel_key& key) const {
+        const auto session = std::hash<std::string_view>{}(std::string_view{key.session.data(), key.session.size()});
+        return session ^ (static_cast<std::size_t>(key.address) << 16 | key.port) * 0x9e3779b97f4a7c15;
+    }
+};
+
+// file name part of a channel, ie 233.54.12.111_26477_000008458
+inline std::string channel_name(const channel_key& key, const demux_by by) {
+    std::string_view session{key.session.data(), key.session.size()};
+    while (!session.empty() && (session.back() == ' ' || session.back() == '\0')) {
+        session.remove_suffix(1);
+    }
+
+    if (by == demux_by::session) {
+        return std::string{session};
+    }
+
+    char address[INET_ADDRSTRLEN];
+    ::inet_ntop(AF_INET, &key.address, address, sizeof(address));
+
+    return std::string{address} + "_" + std::to_string(key.port) + "_" + std::string{session};
+}
+
+// options of one channel, its wide, narrow, arrow and dataset outputs are named after the channel
+inline options channel_options(const options& options, const std::string& channel) {
+    auto named = options;
+    named.parquet_file = message_file(options.parquet_file, channel);
+    if (!options.arrow_file.empty()) {
+        named.arrow_file = message_file(options.arrow_file, channel);
+    }
+    if (!options.feather_file.empty()) {
+        named.feather_file = message_file(options.feather_file, channel);
+    }
+    if (!options.shm_name.empty()) {
+        named.shm_name = options.shm_name + "." + channel;
+    }
+    if (!options.dataset.empty()) {
+        named.dataset = (std::filesystem::path{options.dataset} / channel).string();
+    }
+    return named;
+}
+
+// one pass over a capture of many groups, each channel is converted by a converter of its own into files named after the channel
+//   itch.233.54.12.111_26477_000008458.parquet
+// the channels share one memory budget, encoder pipeline and shard pool, so a run holds what a single converter would
+void write_demuxed(const options& options) {
+    const auto by = demux_named(options.demux);
+
+    if (input_named(options.format) != input_format::pcap) {
+        throw std::invalid_argument("Demux needs pcap or pcapng framing, not " + options.format);
+    }
+
+    capture capture{options.pcap_file, input_format::pcap, options.decompression_threads};
+    capture.filter = packet_filter_of(options);
+
+    row_group_budget budget{options}; // outlives every channel charging it
+    std::unordered_map<channel_key, std::unique_ptr<converter>, channel_hash> channels;
+    std::uint64_t unrouted = 0; // packets without a moldudp64 header
+
+    // joined before the channels they write are destroyed
+    std::unique_ptr<pipeline> encoders;
+    if (options.encoder_threads > 0) {
+        encoders = std::make_unique<pipeline>(options.queue_depth, options.encoder_threads);
+    }
+    std::unique_ptr<work_pool> workers;
+    if (options.wide && options.shards > 0 && options.dataset.empty()) {
+        workers = std::make_unique<work_pool>(options.shards);
+    }
+    const shared_writers shared{&budget, encoders.get(), workers.get()};
+
+    // packets of a channel mostly come in runs, the last route skips the lookup
+    channel_key last;
+    converter* routed = nullptr;
+
+    packet_header header;
+    const u_char* packet;
+
+    while (capture.next(&header, &packet)) {
+        datagram datagram;
+        if (!read_datagram(packet, header.caplen, &datagram) || datagram.length < capture::moldudp64_header_size) {
+            unrouted += 1;
+            continue;
+        }
+
+        channel_key key;
+        if (by == demux_by::channel) {
+            key.address = datagram.header->ip_dst.s_addr;
+            key.port = ntohs(datagram.udp->uh_dport);
+        }
+        std::memcpy(key.session.data(), datagram.payload, key.session.size());
+
+        if (routed == nullptr || !(key == last)) {
+            auto& target = channels[key];
+            if (!target) {
+                target = std::make_unique<converter>(channel_options(options, channel_name(key, by)), shared);
+            }
+            routed = target.get();
+            last = key;
+        }
+
+        routed->process(header, packet);
+    }
+
+    for (auto& [key, channel] : channels) {
+        channel->flush();
+    }
+
+    if (encoders) {
+        encoders->finish();
+        if (!options.stats_file.empty()) {
+            encoders->report(std::cerr);
+        }
+    }
+
+    for (auto& [key, channel] : channels) {
+        channel->close_files();
+    }
+
+    if (!options.stats_file.empty()) {
+        std::cerr << "demux: " << channels.size() << " channels, " << unrouted << " packets without a moldudp64 header, " << capture.filtered << " filtered" << std::endl;
+    }
+}
+
+void write_parquet(const options& options) {
+    if (!options.demux.empty()) {
+        if (!options.interface.empty() || !options.checkpoint_file.empty()) {
+            throw std::invalid_argument("Demux reads a capture file, without --live or --checkpoint");
+        }
+        if (options.threads > 1) {
+            std::cerr << "demuxed capture " << options.pcap_file << " converts on one thread" << std::endl;
+        }
+        write_demuxed(options);
+        return;
+    }
+
+    if (!options.interface.empty()) {
+        write_live(options);
+        return;
+    }
+
+    if (!options.checkpoint_file.empty()) {
+        // a part written again after a crash would leave its evicted and torn files in the dataset and add its rows a second time
+        if (!options.dataset.empty()) {
+            throw std::invalid_argument("Checkpoints resume numbered part files, without --dataset");
+        }
+        if (options.threads > 1) {
+            std::cerr << "checkpointed capture " << options.pcap_file << " converts on one thread" << std::endl;
+        }
+        write_checkpointed(options);
+        return;
+    }
+
+    const auto compressed = decompressor::codec_of(options.pcap_file).has_value();
+
+    // chunks seek into the capture, compressed captures are read front to back and a dataset has one writer
+    if (options.threads > 1 && !compressed && options.dataset.empty()) {
+        write_parallel(options);
+        return;
+    }
+
+    if (options.threads > 1 && compressed) {
+        std::cerr << "compressed capture " << options.pcap_file << " converts on one thread" << std::endl;
+    }
+    else if (options.threads > 1) {
+        std::cerr << "partitioned dataset " << options.dataset << " converts on one thread" << std::endl;
+    }
+
+    // libpcap only reads plain pcap framing
+    if (options.mmap || compressed || input_named(options.format) != input_format::pcap) {
+        capture capture{options.pcap_file, input_named(options.format), options.decompression_threads};
+        capture.filter = packet_filter_of(options);
+
+        converter converter(options);
+
+        packet_header header;
+        const u_char* packet;
+
+        while (capture.next(&header, &packet)) {
+            converter.process(header, packet);
+        }
+
+        converter.close();
+        return;
+    }
+
+    // open capture file
+    char buffer[PCAP_ERRBUF_SIZE];
+    const auto pcap = pcap_open_offline_with_tstamp_precision(options.pcap_file.c_str(), PCAP_TSTAMP_PRECISION_NANO, buffer);
+    if (pcap == nullptr)
+    {
+        throw std::runtime_error("Unable to open file "); // need to add buffer
+    }
+
+    const auto filter = packet_filter_of(options);
+    if (filter && pcap_setfilter(pcap, const_cast<bpf_program*>(&filter->program)) != 0) {
+        const std::string error = pcap_geterr(pcap);
+        pcap_close(pcap);
+        throw std::runtime_error("Unable to set packet filter " + options.filter + ": " + error);
+    }
+
+    converter converter(options);
+
+    // loop through packets
+    pcap_pkthdr* header;
+    const u_char* packet;
+
+    while (true) {
+        switch (pcap_next_ex(pcap, &header, &packet)) {
+        case 1:
+            converter.process(header, packet);
+            break;
+        case 0:
+            // timeout
+        case -1:
+            //     std::cerr << "Error: " << pcap_geterr(p) << std::endl;
+        case -2:
+            // end-of-file
+        default:
+            converter.close();
+            pcap_close(pcap);
+            return;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+// parquet query
+///////////////////////////////////////////////////////////////////////
+
+// column statistic bound, integers are unsigned and byte arrays compare as bytes
+struct bound {
+    std::uint64_t integer = 0;
+    std::string text;
+};
+
+// plain encoded minimum or maximum, as kept in chunk statistics and the column index
+inline bound decode_bound(const parquet::Type::type type, const std::string& encoded) {
+    bound value;
+
+    if (type == parquet::Type::INT32 && encoded.size() == sizeof(std::uint32_t)) {
+        std::uint32_t integer;
+        std::memcpy(&integer, encoded.data(), sizeof(integer));
+        value.integer = integer;
+    }
+    else if (type == parquet::Type::INT64 && encoded.size() == sizeof(std::uint64_t)) {
+        std::memcpy(&value.integer, encoded.data(), sizeof(value.integer));
+    }
+    else {
+        value.text = encoded;
+    }
+
+    return value;
+}
+
+// row filter on one column, null values never match
+struct predicate {
+    int column = 0;
+    std::uint64_t low = 0;
+    std::uint64_t high = std::numeric_limits<std::uint64_t>::max();
+    std::vector<std::uint64_t> values; // any of, empty matches the whole range
+    std::optional<std::string> text; // byte array columns equal to
+
+    [[nodiscard]] bool matches(const std::uint64_t value) const {
+        return low <= value && value <= high && (values.empty() || std::find(values.begin(), values.end(), value) != values.end());
+    }
+
+    [[nodiscard]] bool matches(const std::string_view value) const {
+        return !text || value == *text;
+    }
+
+    // single values a bloom filter can rule out
+    [[nodiscard]] bool point() const {
+        return text || low == high || !values.empty();
+    }
+
+    // could a value between min and max match
+    [[nodiscard]] bool overlaps(const bound& min, const bound& max) const {
+        if (text) {
+            return min.text <= *text && *text <= max.text;
+        }
+
+        if (max.integer < low || high < min.integer) {
+            return false;
+        }
+
+        return values.empty() || std::any_of(values.begin(), values.end(), [&](const auto value) {
+            return min.integer <= value && value <= max.integer && matches(value);
+        });
+    }
+};
+
+// integer column between low and high
+inline predicate between(const int column, const std::uint64_t low, const std::uint64_t high) {
+    predicate range;
+    range.column = column;
+    range.low = low;
+    range.high = high;
+    return range;
+}
+
+// projected wide table read, rows match every predicate
+struct query {
+    std::vector<std::string> columns; // by name, empty reads every column
+    std::vector<predicate> predicates;
+};
+
+// sorted disjoint [first, last) rows of a row group
+using row_ranges = std::vector<std::pair<std::int64_t, std::int64_t>>;
+
+inline void add_range(row_ranges& ranges, const std::int64_t first, const std::int64_t last) {
+    if (!ranges.empty() && ranges.back().second == first) {
+        ranges.back().second = last;
+    } else {
+        ranges.emplace_back(first, last);
+    }
+}
+
+inline row_ranges intersect(const row_ranges& left, const row_ranges& right) {
+    row_ranges ranges;
+
+    for (std::size_t l = 0, r = 0; l < left.size() && r < right.size();) {
+        const auto first = std::max(left[l].first, right[r].first);
+        const auto last = std::min(left[l].second, right[r].second);
+
+        if (first < last) {
+            add_range(ranges, first, last);
+        }
+
+        if (left[l].second < right[r].second) {
+            ++l;
+        } else {
+            ++r;
+        }
+    }
+
+    return ranges;
+}
+
+inline bool overlaps(const row_ranges& ranges, const std::int64_t first, const std::int64_t last) {
+    return std::any_of(ranges.begin(), ranges.end(), [&](const auto& range) { return range.first < last && first < range.second; });
+}
+
+// how much of the file a query touched
+struct query_stats {
+    std::uint64_t row_groups = 0;
+    std::uint64_t row_groups_read = 0;
+    std::uint64_t row_groups_bloomed = 0; // ruled out by a bloom filter after the statistics passed
+    std::uint64_t pages = 0; // of read columns in read row groups, known from the offset index
+    std::uint64_t pages_read = 0;
+    std::uint64_t rows = 0;
+    std::uint64_t rows_scanned = 0;
+    std::uint64_t rows_matched = 0;
+
+    void add(const query_stats& other) {
+        row_groups += other.row_groups;
+        row_groups_read += other.row_groups_read;
+        row_groups_bloomed += other.row_groups_bloomed;
+        pages += other.pages;
+        pages_read += other.pages_read;
+        rows += other.rows;
+        rows_scanned += other.rows_scanned;
+        rows_matched += other.rows_matched;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& out, const query_stats& stats) {
+    out << stats.row_groups_read << " of " << stats.row_groups << " row groups, ";
+    if (stats.row_groups_bloomed > 0) {
+        out << stats.row_groups_bloomed << " bloom filtered, ";
+    }
+    if (stats.pages > 0) {
+        out << stats.pages_read << " of " << stats.pages << " pages, ";
+    }
+    return out << stats.rows_scanned << " of " << stats.rows << " rows scanned, " << stats.rows_matched << " matched";
+}
+
+// one column of a row group, pages outside the selected rows are never read
+struct column_cursor {
+    const parquet::ColumnDescriptor* descriptor = nullptr;
+    std::shared_ptr<parquet::ColumnReader> reader;
+    row_ranges kept; // first row of each kept page and the rows of skipped pages before it
+    std::int64_t position = 0; // rows consumed from kept pages
+
+    // current slice
+    std::vector<std::int16_t> levels;
+    std::vector<std::uint8_t> valid;
+    std::vector<std::uint64_t> integers;
+    std::vector<std::string> texts;
+
+    // row of the column reader, which only sees kept pages
+    [[nodiscard]] std::int64_t local(const std::int64_t row) const {
+        const auto page = std::upper_bound(kept.begin(), kept.end(), row, [](const auto value, const auto& range) { return value < range.first; });
+        return row - std::prev(page)->second;
+    }
+
+    // rows [row, row + count) of the row group
+    void read(const std::int64_t row, const std::int64_t count) {
+        const auto start = local(row);
+        for (auto skip = start - position; skip > 0;) {
+            const auto skipped = skip_values(skip);
+            if (skipped == 0) {
+                throw std::runtime_error("Column " + descriptor->name() + " ended early");
+            }
+            skip -= skipped;
+        }
+        position = start + count;
+
+        levels.resize(count);
+        valid.resize(count);
+        integers.resize(count);
+        texts.resize(count);
+
+        switch (descriptor->physical_type()) {
+            case parquet::Type::INT32:
+                read_values<parquet::Int32Reader>(count, [&](const std::size_t index, const std::int32_t value) { integers[index] = static_cast<std::uint32_t>(value); });
+                break;
+            case parquet::Type::INT64:
+                read_values<parquet::Int64Reader>(count, [&](const std::size_t index, const std::int64_t value) { integers[index] = static_cast<std::uint64_t>(value); });
+                break;
+            case parquet::Type::BYTE_ARRAY:
+                read_values<parquet::ByteArrayReader>(count, [&](const std::size_t index, const parquet::ByteArray& value) { texts[index].assign(reinterpret_cast<const char*>(value.ptr), value.len); });
+                break;
+            default:
+                throw std::invalid_argument("Unsupported column " + descriptor->name());
+        }
+    }
+
+    std::int64_t skip_values(const std::int64_t count) {
+        switch (descriptor->physical_type()) {
+            case parquet::Type::INT32: return static_cast<parquet::Int32Reader*>(reader.get())->Skip(count);
+            case parquet::Type::INT64: return static_cast<parquet::Int64Reader*>(reader.get())->Skip(count);
+            case parquet::Type::BYTE_ARRAY: return static_cast<parquet::ByteArrayReader*>(reader.get())->Skip(count);
+            default: throw std::invalid_argument("Unsupported column " + descriptor->name());
+        }
+    }
+
+    // byte array values point into the page, so each slice is stored before the next read
+    template <typename typed_reader, typename store>
+    void read_values(const std::int64_t count, store&& set) {
+        const auto typed = static_cast<typed_reader*>(reader.get());
+        const auto defined = descriptor->max_definition_level();
+        std::vector<typename typed_reader::T> values(count);
+
+        for (std::int64_t done = 0; done < count;) {
+            std::int64_t values_read = 0;
+            const auto read = typed->ReadBatch(count - done, levels.data() + done, nullptr, values.data(), &values_read);
+            if (read == 0) {
+                throw std::runtime_error("Column " + descriptor->name() + " ended early");
+            }
+
+            for (std::int64_t index = done, value = 0; index < done + read; ++index) {
+                valid[index] = defined == 0 || levels[index] == defined;
+                if (valid[index]) {
+                    set(static_cast<std::size_t>(index), values[value++]);
+                }
+            }
+            done += read;
+        }
+    }
+
+    [[nodiscard]] bool matches(const predicate& predicate, const std::size_t index) const {
+        if (!valid[index]) {
+            return false;
+        }
+        return predicate.text ? predicate.matches(std::string_view{texts[index]}) : predicate.matches(integers[index]);
+    }
+
+    void append(arrow::ArrayBuilder& builder, const std::size_t index) const {
+        if (!valid[index]) {
+            PARQUET_THROW_NOT_OK(builder.AppendNull());
+            return;
+        }
+
+        const auto value = integers[index];
+
+        switch (builder.type()->id()) {
+            case arrow::Type::UINT8: PARQUET_THROW_NOT_OK(static_cast<arrow::UInt8Builder&>(builder).Append(static_cast<std::uint8_t>(value))); break;
+            case arrow::Type::UINT16: PARQUET_THROW_NOT_OK(static_cast<arrow::UInt16Builder&>(builder).Append(static_cast<std::uint16_t>(value))); break;
+            case arrow::Type::UINT32: PARQUET_THROW_NOT_OK(static_cast<arrow::UInt32Builder&>(builder).Append(static_cast<std::uint32_t>(value))); break;
+            case arrow::Type::UINT64: PARQUET_THROW_NOT_OK(static_cast<arrow::UInt64Builder&>(builder).Append(value)); break;
+            case arrow::Type::INT32: PARQUET_THROW_NOT_OK(static_cast<arrow::Int32Builder&>(builder).Append(static_cast<std::int32_t>(value))); break;
+            case arrow::Type::INT64: PARQUET_THROW_NOT_OK(static_cast<arrow::Int64Builder&>(builder).Append(static_cast<std::int64_t>(value))); break;
+            case arrow::Type::TIMESTAMP: PARQUET_THROW_NOT_OK(static_cast<arrow::TimestampBuilder&>(builder).Append(static_cast<std::int64_t>(value))); break;
+            case arrow::Type::TIME64: PARQUET_THROW_NOT_OK(static_cast<arrow::Time64Builder&>(builder).Append(static_cast<std::int64_t>(value))); break;
+            case arrow::Type::DECIMAL128: PARQUET_THROW_NOT_OK(static_cast<arrow::Decimal128Builder&>(builder).Append(arrow::Decimal128{static_cast<std::int64_t>(value)})); break;
+            case arrow::Type::STRING: PARQUET_THROW_NOT_OK(static_cast<arrow::StringBuilder&>(builder).Append(texts[index])); break;
+            default: throw std::invalid_argument("Unsupported column " + descriptor->name());
+        }
+    }
+};
+
+// projected read of a wide parquet file, row groups are skipped on chunk statistics and pages on the page index
+struct query_reader {
+
+    std::unique_ptr<parquet::ParquetFileReader> file;
+    std::shared_ptr<parquet::FileMetaData> metadata;
+    std::shared_ptr<parquet::PageIndexReader> page_index;
+    std::vector<int> projection; // schema order
+    std::vector<int> columns; // projected and predicate columns, read together
+    std::vector<predicate> predicates;
+    std::shared_ptr<arrow::Schema> schema;
+    std::int64_t batch_rows;
+    query_stats stats;
+
+    // rows read per column before predicates are evaluated
+    static constexpr std::int64_t slice_rows = 4096;
+
+    query_reader(const std::string& parquet_file, const query& query, const std::int64_t batch_rows = 65536)
+        : file{parquet::ParquetFileReader::OpenFile(parquet_file)}
+        , metadata{file->metadata()}
+        , page_index{file->GetPageIndexReader()}
+        , predicates{query.predicates}
+        , batch_rows{batch_rows} {
+        const auto descriptors = metadata->schema();
+
+        for (const auto& name : query.columns) {
+            const auto found = projection.size();
+            for (int column = 0; column < descriptors->num_columns(); ++column) {
+                if (descriptors->Column(column)->name() == name) {
+                    projection.push_back(column);
+                }
+            }
+            if (projection.size() == found) {
+                throw std::invalid_argument("Unknown column " + name);
+            }
+        }
+        if (query.columns.empty()) {
+            for (int column = 0; column < descriptors->num_columns(); ++column) {
+                projection.push_back(column);
+            }
+        }
+        std::sort(projection.begin(), projection.end());
+        projection.erase(std::unique(projection.begin(), projection.end()), projection.end());
+
+        // predicates name wide record columns, found by name so projected files and files from earlier schemas resolve too
+        const auto wide = feed::record::schema();
+        for (auto& predicate : predicates) {
+            const auto& name = wide->field(predicate.column)->name();
+            int found = -1;
+            // a name held twice resolves to the later column, ie the itch timestamp of nasdaq files written before pcap_timestamp was renamed
+            for (int column = 0; column < descriptors->num_columns(); ++column) {
+                if (descriptors->Column(column)->name() == name) {
+                    found = column;
+                }
+            }
+            if (found < 0) {
+                throw std::invalid_argument("Unknown column " + name);
+            }
+            predicate.column = found;
+        }
+
+        columns = projection;
+        for (const auto& predicate : predicates) {
+            columns.push_back(predicate.column);
+        }
+        std::sort(columns.begin(), columns.end());
+        columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+
+        arrow::FieldVector fields;
+        for (const auto column : projection) {
+            const auto descriptor = descriptors->Column(column);
+            fields.push_back(arrow::field(descriptor->name(), arrow_type(*descriptor), descriptor->max_definition_level() > 0));
+        }
+        schema = arrow::schema(std::move(fields));
+    }
+
+    // chunk statistics could match every predicate
+    [[nodiscard]] bool keep(const parquet::RowGroupMetaData& row_group) const {
+        for (const auto& predicate : predicates) {
+            const auto chunk = row_group.ColumnChunk(predicate.column);
+            const auto statistics = chunk->is_stats_set() ? chunk->statistics() : nullptr;
+
+            if (statistics == nullptr) {
+                continue;
+            }
+
+            // only nulls
+            if (!statistics->HasMinMax()) {
+                if (statistics->num_values() == 0) {
+                    return false;
+                }
+                continue;
+            }
+
+            const auto type = statistics->physical_type();
+            if (!predicate.overlaps(decode_bound(type, statistics->EncodeMin()), decode_bound(type, statistics->EncodeMax()))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // bloom filters could hold every point predicate, true for columns written without one
+    [[nodiscard]] bool contains(const int index) {
+        if (std::none_of(predicates.begin(), predicates.end(), [](const auto& predicate) { return predicate.point(); })) {
+            return true;
+        }
+
+        const auto filters = file->GetBloomFilterReader().RowGroup(index);
+        if (filters == nullptr) {
+            return true;
+        }
+
+        for (const auto& predicate : predicates) {
+            if (!predicate.point()) {
+                continue;
+            }
+
+            const auto filter = filters->GetColumnBloomFilter(predicate.column);
+            if (filter == nullptr) {
+                continue;
+            }
+
+            const auto type = metadata->schema()->Column(predicate.column)->physical_type();
+            const auto found = [&](const std::uint64_t value) {
+                return type == parquet::Type::INT32
+                    ? filter->FindHash(filter->Hash(static_cast<std::int32_t>(value)))
+                    : filter->FindHash(filter->Hash(static_cast<std::int64_t>(value)));
+            };
+
+            if (predicate.text) {
+                const parquet::ByteArray value{static_cast<std::uint32_t>(predicate.text->size()), reinterpret_cast<const std::uint8_t*>(predicate.text->data())};
+                if (!filter->FindHash(filter->Hash(&value))) {
+                    return false;
+                }
+            }
+            else if (predicate.values.empty() ? !found(predicate.low) : std::none_of(predicate.values.begin(), predicate.values.end(), found)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // rows of pages that could match every predicate, the whole row group without a page index
+    [[nodiscard]] row_ranges select(const int index, const std::int64_t rows) const {
+        row_ranges selected{{0, rows}};
+
+        const auto row_group = page_index ? page_index->RowGroup(index) : nullptr;
+        if (row_group == nullptr) {
+            return selected;
+        }
+
+        for (const auto& predicate : predicates) {
+            const auto column_index = row_group->GetColumnIndex(predicate.column);
+            const auto offset_index = row_group->GetOffsetIndex(predicate.column);
+            if (column_index == nullptr || offset_index == nullptr) {
+                continue;
+            }
+
+            const auto type = metadata->schema()->Column(predicate.column)->physical_type();
+            const auto& locations = offset_index->page_locations();
+            const auto& null_pages = column_index->null_pages();
+            const auto& minimums = column_index->encoded_min_values();
+            const auto& maximums = column_index->encoded_max_values();
+
+            row_ranges pages;
+            for (std::size_t page = 0; page < locations.size(); ++page) {
+                const auto first = locations[page].first_row_index;
+                const auto last = page + 1 < locations.size() ? locations[page + 1].first_row_index : rows;
+
+                if (!null_pages[page] && predicate.overlaps(decode_bound(type, minimums[page]), decode_bound(type, maximums[page]))) {
+                    add_range(pages, first, last);
+                }
+            }
+
+            selected = intersect(selected, pages);
+        }
+
+        return selected;
+    }
+
+    // page reader that drops pages outside the selected rows before they are decompressed
+    column_cursor open(parquet::RowGroupReader& row_group, const int index, const int column, const row_ranges& selected, const std::int64_t rows) {
+        column_cursor cursor;
+        cursor.descriptor = metadata->schema()->Column(column);
+        cursor.kept = {{0, 0}};
+
+        auto pages = row_group.GetColumnPageReader(column);
+
+        const auto indexed = page_index ? page_index->RowGroup(index) : nullptr;
+        const auto offset_index = indexed ? indexed->GetOffsetIndex(column) : nullptr;
+
+        if (offset_index != nullptr) {
+            const auto& locations = offset_index->page_locations();
+            std::vector<bool> keep(locations.size());
+            std::int64_t skipped = 0;
+
+            cursor.kept.clear();
+            for (std::size_t page = 0; page < locations.size(); ++page) {
+                const auto first = locations[page].first_row_index;
+                const auto last = page + 1 < locations.size() ? locations[page + 1].first_row_index : rows;
+
+                keep[page] = overlaps(selected, first, last);
+                stats.pages += 1;
+
+                if (keep[page]) {
+                    cursor.kept.emplace_back(first, skipped);
+                    stats.pages_read += 1;
+                } else {
+                    skipped += last - first;
+                }
+            }
+
+            // data pages arrive in offset index order, dictionary pages are not filtered
+            pages->set_data_page_filter([keep = std::move(keep), page = std::size_t{0}](const parquet::DataPageStats&) mutable {
+                const auto skip = page < keep.size() && !keep[page];
+                ++page;
+                return skip;
+            });
+        }
+
+        cursor.reader = parquet::ColumnReader::Make(cursor.descriptor, std::move(pages));
+        return cursor;
+    }
+
+    // matching rows of one row group, consume is handed the cursors of the projection and the slot of each row in their current slice
+    template <typename consumer>
+    void scan_row_group(const int index, consumer&& consume) {
+        const auto row_group_metadata = metadata->RowGroup(index);
+        const auto rows = row_group_metadata->num_rows();
+
+        stats.row_groups += 1;
+        stats.rows += static_cast<std::uint64_t>(rows);
+
+        if (!keep(*row_group_metadata)) {
+            return;
+        }
+
+        if (!contains(index)) {
+            stats.row_groups_bloomed += 1;
+            return;
+        }
+
+        const auto selected = select(index, rows);
+        if (selected.empty()) {
+            return;
+        }
+
+        stats.row_groups_read += 1;
+
+        const auto row_group = file->RowGroup(index);
+        std::vector<column_cursor> cursors;
+        for (const auto column : columns) {
+            cursors.push_back(open(*row_group, index, column, selected, rows));
+        }
+
+        const auto cursor_of = [&](const int column) -> const column_cursor& {
+            return cursors[static_cast<std::size_t>(std::lower_bound(columns.begin(), columns.end(), column) - columns.begin())];
+        };
+
+        std::vector<const column_cursor*> projected;
+        for (const auto column : projection) {
+            projected.push_back(&cursor_of(column));
+        }
+
+        for (const auto& [first, last] : selected) {
+            for (auto row = first; row < last; row += slice_rows) {
+                const auto count = std::min(slice_rows, last - row);
+
+                for (auto& cursor : cursors) {
+                    cursor.read(row, count);
+                }
+                stats.rows_scanned += static_cast<std::uint64_t>(count);
+
+                for (std::size_t slot = 0; slot < static_cast<std::size_t>(count); ++slot) {
+                    const auto matched = std::all_of(predicates.begin(), predicates.end(), [&](const auto& predicate) {
+                        return cursor_of(predicate.column).matches(predicate, slot);
+                    });
+                    if (!matched) {
+                        continue;
+                    }
+
+                    consume(projected, slot);
+                    stats.rows_matched += 1;
+                }
+            }
+        }
+    }
+
+    // matching rows as record batches of at most batch rows
+    template <typename consumer>
+    void scan(consumer&& consume) {
+        std::vector<std::unique_ptr<arrow::ArrayBuilder>> builders(projection.size());
+        for (std::size_t index = 0; index < projection.size(); ++index) {
+            PARQUET_THROW_NOT_OK(arrow::MakeBuilder(arrow::default_memory_pool(), schema->field(static_cast<int>(index))->type(), &builders[index]));
+        }
+
+        std::int64_t buffered = 0;
+        const auto emit = [&] {
+            if (buffered == 0) {
+                return;
+            }
+            std::vector<std::shared_ptr<arrow::Array>> arrays(builders.size());
+            for (std::size_t index = 0; index < builders.size(); ++index) {
+                PARQUET_THROW_NOT_OK(builders[index]->Finish(&arrays[index]));
+            }
+            consume(arrow::RecordBatch::Make(schema, buffered, std::move(arrays)));
+            buffered = 0;
+        };
+
+        for (int index = 0; index < metadata->num_row_groups(); ++index) {
+            scan_row_group(index, [&](const std::vector<const column_cursor*>& projected, const std::size_t slot) {
+                for (std::size_t column = 0; column < projected.size(); ++column) {
+                    projected[column]->append(*builders[column], slot);
+                }
+
+                if (++buffered == batch_rows) {
+                    emit();
+                }
+            });
+        }
+
+        emit();
+    }
+
+    // every matching row as one table
+    std::shared_ptr<arrow::Table> read() {
+        std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+        scan([&](std::shared_ptr<arrow::RecordBatch> batch) { batches.push_back(std::move(batch)); });
+
+        std::shared_ptr<arrow::Table> table;
+        PARQUET_ASSIGN_OR_THROW(table, arrow::Table::FromRecordBatches(schema, batches));
+        return table;
+    }
+};
+
+// wide table query from the command line
+inline query query_of(const options& options) {
+    using record = feed::record;
+    query query;
+    query.columns = options.select;
+
+    if (!options.message_types.empty()) {
+        predicate types;
+        types.column = record::column<feed::message_type>();
+        for (const auto type : options.message_types) {
+            types.values.push_back(static_cast<std::uint8_t>(type));
+        }
+        query.predicates.push_back(std::move(types));
+    }
+
+    if (!options.symbol.empty()) {
+        predicate listed;
+        listed.column = record::column<feed::symbol>();
+        listed.text = options.symbol;
+        query.predicates.push_back(std::move(listed));
+    }
+
+    if (options.instrument) {
+        query.predicates.push_back(between(record::column<feed::instrument_field>(), *options.instrument, *options.instrument));
+    }
+
+    if (options.from > 0 || options.to < std::numeric_limits<std::uint64_t>::max()) {
+        query.predicates.push_back(between(record::column<feed::time_field>(), options.from, options.to));
+    }
+
+    if (options.first_order > 0 || options.last_order < std::numeric_limits<std::uint64_t>::max()) {
+        query.predicates.push_back(between(record::column<feed::order_field>(), options.first_order, options.last_order));
+    }
+
+    if (options.match_number) {
+        query.predicates.push_back(between(record::column<feed::match_number>(), *options.match_number, *options.match_number));
+    }
+
+    return query;
+}
+
+// print wide table rows matching the query
+void read_parquet(const std::string& parquet_file, const query& query) {
+    query_reader reader{parquet_file, query};
+
+    reader.scan([](const std::shared_ptr<arrow::RecordBatch>& batch) {
+        std::cout << batch->ToString();
+    });
+
+    std::cerr << parquet_file << ": " << reader.stats << std::endl;
+}
+
+///////////////////////////////////////////////////////////////////////
+// text export
+///////////////////////////////////////////////////////////////////////
+
+// export layouts, text is the comma terminated field list of a record
+enum class export_format { csv, json, text };
+
+inline export_format export_named(const std::string_view name) {
+    if (name == "csv") return export_format::csv;
+    if (name == "json") return export_format::json;
+    if (name == "text") return export_format::text;
+    throw std::invalid_argument("Unknown export format " + std::string{name});
+}
+
+// how a wide table column is written, from its parquet types
+struct export_column {
+
+    enum class kind { unsigned_integer, signed_integer, character, decimal, timestamp, time, text };
+
+    std::string key; // json object key with its colon, ie "price":
+    kind type = kind::unsigned_integer;
+    bool narrow = false; // int32, sign extended from the low half
+    std::int32_t scale = 0; // decimal digits
+    std::uint64_t per_second = 1'000'000'000; // timestamp and time units
+    std::int32_t digits = 9; // of a second fraction
+
+    explicit export_column(const parquet::ColumnDescriptor& column) : key{"\"" + column.name() + "\":"} {
+        const auto& logical = *column.logical_type();
+
+        const auto unit = [&](const parquet::LogicalType::TimeUnit::unit unit) {
+            switch (unit) {
+                case parquet::LogicalType::TimeUnit::MILLIS: per_second = 1'000; digits = 3; break;
+                case parquet::LogicalType::TimeUnit::MICROS: per_second = 1'000'000; digits = 6; break;
+                default: break;
+            }
+        };
+
+        if (logical.is_timestamp()) {
+            type = kind::timestamp;
+            unit(static_cast<const parquet::TimestampLogicalType&>(logical).time_unit());
+        }
+        else if (logical.is_time()) {
+            type = kind::time;
+            unit(static_cast<const parquet::TimeLogicalType&>(logical).time_unit());
+        }
+        else if (logical.is_decimal()) {
+            type = kind::decimal;
+            scale = static_cast<const parquet::DecimalLogicalType&>(logical).scale();
+            narrow = column.physical_type() == parquet::Type::INT32;
+        }
+        else if (column.converted_type() == parquet::ConvertedType::UINT_8) {
+            type = kind::character; // itch alpha fields
+        }
+        else if (column.converted_type() == parquet::ConvertedType::TIMESTAMP_MICROS) {
+            type = kind::timestamp;
+            unit(parquet::LogicalType::TimeUnit::MICROS);
+        }
+        else if (column.physical_type() == parquet::Type::BYTE_ARRAY) {
+            type = kind::text;
+        }
+        else if (column.converted_type() == parquet::ConvertedType::NONE) {
+            type = kind::signed_integer;
+            narrow = column.physical_type() == parquet::Type::INT32;
+        }
+    }
+};
+
+// rows formatted into a text block, values go through to_chars and each second of a timestamp is formatted once
+struct row_formatter {
+
+    export_format format;
+    const std::vector<export_column>* columns;
+    std::string out;
+
+    // date and time of the last timestamp second
+    std::int64_t second = std::numeric_limits<std::int64_t>::min();
+    char date[24]{};
+    std::size_t date_length = 0;
+
+    row_formatter(const export_format format, const std::vector<export_column>& columns) : format{format}, columns{&columns} {}
+
+    void row(const std::vector<const column_cursor*>& projected, const std::size_t slot) {
+        if (format == export_format::json) {
+            out += '{';
+        }
+
+        for (std::size_t index = 0; index < projected.size(); ++index) {
+            const auto& column = (*columns)[index];
+
+            if (format == export_format::json) {
+                if (index > 0) {
+                    out += ',';
+                }
+                out += column.key;
+            }
+            else if (format == export_format::csv && index > 0) {
+                out += ',';
+            }
+
+            value(column, *projected[index], slot);
+
+            if (format == export_format::text) {
+                out += ',';
+            }
+        }
+
+        out += format == export_format::json ? "}\n" : "\n";
+    }
+
+    void value(const export_column& column, const column_cursor& cursor, const std::size_t slot) {
+        if (!cursor.valid[slot]) {
+            if (format == export_format::json) {
+                out += "null";
+            }
+            return;
+        }
+
+        const auto raw = cursor.integers[slot];
+        const auto quoted = format == export_format::json;
+
+        switch (column.type) {
+            case export_column::kind::unsigned_integer:
+                integer(raw);
+                break;
+            case export_column::kind::signed_integer:
+                integer(signed_value(column, raw));
+                break;
+            case export_column::kind::character:
+                character(static_cast<char>(raw));
+                break;
+            case export_column::kind::decimal:
+                decimal(signed_value(column, raw), column.scale);
+                break;
+            case export_column::kind::timestamp:
+                if (quoted) out += '"';
+                timestamp(static_cast<std::int64_t>(raw), column);
+                if (quoted) out += '"';
+                break;
+            case export_column::kind::time:
+                if (quoted) out += '"';
+                time_of_day(raw, column);
+                if (quoted) out += '"';
+                break;
+            case export_column::kind::text:
+                text(cursor.texts[slot]);
+                break;
+        }
+    }
+
+    [[nodiscard]] static std::int64_t signed_value(const export_column& column, const std::uint64_t raw) {
+        return column.narrow ? static_cast<std::int32_t>(static_cast<std::uint32_t>(raw)) : static_cast<std::int64_t>(raw);
+    }
+
+    template <typename integral>
+    void integer(const integral value) {
+        char buffer[24];
+        const auto end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+        out.append(buffer, end);
+    }
+
+    // zero padded to width digits
+    void padded(const std::uint64_t value, const std::int32_t width) {
+        char buffer[24];
+        const auto end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+        out.append(static_cast<std::size_t>(std::max<std::int64_t>(width - (end - buffer), 0)), '0');
+        out.append(buffer, end);
+    }
+
+    void decimal(const std::int64_t value, const std::int32_t scale) {
+        if (value < 0) {
+            out += '-';
+        }
+        const auto magnitude = value < 0 ? 0 - static_cast<std::uint64_t>(value) : static_cast<std::uint64_t>(value);
+
+        std::uint64_t unit = 1;
+        for (std::int32_t digit = 0; digit < scale; ++digit) {
+            unit *= 10;
+        }
+
+        integer(magnitude / unit);
+        if (scale > 0) {
+            out += '.';
+            padded(magnitude % unit, scale);
+        }
+    }
+
+    // utc, 2024-01-05T14:30:00.123456789Z, the text layout keeps whole seconds as records print them
+    void timestamp(const std::int64_t value, const export_column& column) {
+        const auto units = static_cast<std::int64_t>(column.per_second);
+        const auto seconds = value >= 0 ? value / units : -((-value - 1) / units) - 1;
+
+        if (seconds != second) {
+            const auto time = static_cast<std::time_t>(seconds);
+            std::tm parts{};
+            gmtime_r(&time, &parts);
+            date_length = std::strftime(date, sizeof(date), format == export_format::text ? "%Y-%m-%d %H:%M:%S" : "%Y-%m-%dT%H:%M:%S", &parts);
+            second = seconds;
+        }
+
+        out.append(date, date_length);
+        if (format != export_format::text) {
+            out += '.';
+            padded(static_cast<std::uint64_t>(value - seconds * units), column.digits);
+            out += 'Z';
+        }
+    }
+
+    // 14:30:00.123456789
+    void time_of_day(const std::uint64_t value, const export_column& column) {
+        const auto seconds = value / column.per_second;
+        padded(seconds / 3600, 2);
+        out += ':';
+        padded(seconds / 60 % 60, 2);
+        out += ':';
+        padded(seconds % 60, 2);
+        out += '.';
+        padded(value % column.per_second, column.digits);
+    }
+
+    void character(const char value) {
+        text(std::string_view{&value, 1});
+    }
+
+    // csv quotes a value holding a separator, json escapes quotes and control characters
+    void text(const std::string_view value) {
+        switch (format) {
+            case export_format::text:
+                out += value;
+                break;
+
+            case export_format::csv:
+                if (value.find_first_of(",\"\r\n") == std::string_view::npos) {
+                    out += value;
+                    break;
+                }
+                out += '"';
+                for (const auto character : value) {
+                    out += character;
+                    if (character == '"') {
+                        out += '"';
+                    }
+                }
+                out += '"';
+                break;
+
+            case export_format::json:
+                out += '"';
+                for (const auto character : value) {
+                    if (character == '"' || character == '\\') {
+                        out += '\\';
+                        out += character;
+                    }
+                    else if (static_cast<unsigned char>(character) < 0x20) {
+                        char escaped[8];
+                        std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(character));
+                        out += escaped;
+                    }
+                    else {
+                        out += character;
+                    }
+                }
+                out += '"';
+                break;
+        }
+    }
+};
+
+// formatted blocks of one row group, written once every earlier row group is
+struct export_job {
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<std::string> blocks;
+    bool done = false;
+};
+
+// export matching rows of a wide parquet file, row groups are formatted on threads of their own and written in file order through large blocks
+//   a row group buffers at most max_blocks ahead of the writer, so memory stays bounded however far behind the output is
+void export_parquet(const std::string& parquet_file, const query& query, const export_format format, const int descriptor, const std::size_t threads, const bool header) {
+    static constexpr std::size_t block_bytes = 1 << 20;
+    static constexpr std::size_t max_blocks = 16;
+
+    query_reader layout{parquet_file, query};
+
+    std::vector<export_column> columns;
+    for (const auto column : layout.projection) {
+        columns.emplace_back(*layout.metadata->schema()->Column(column));
+    }
+
+    const auto write = [&](const std::string& block) {
+        for (std::size_t written = 0; written < block.size();) {
+            const auto result = ::write(descriptor, block.data() + written, block.size() - written);
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error("Unable to write export: " + std::string{std::strerror(errno)});
+            }
+            written += static_cast<std::size_t>(result);
+        }
+    };
+
+    if (header && format == export_format::csv) {
+        std::string names;
+        for (std::size_t index = 0; index < layout.projection.size(); ++index) {
+            names += (index > 0 ? "," : "") + layout.metadata->schema()->Column(layout.projection[index])->name();
+        }
+        write(names + "\n");
+    }
+
+    const auto count = layout.metadata->num_row_groups();
+    std::vector<std::unique_ptr<export_job>> jobs;
+    for (int index = 0; index < count; ++index) {
+        jobs.push_back(std::make_unique<export_job>());
+    }
+
+    std::atomic<int> next{0};
+    std::atomic<bool> cancelled{false}; // a worker or the writer failed
+    std::vector<query_stats> stats(std::max<std::size_t>(threads, 1));
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    // every waiting worker and the writer let through
+    const auto cancel = [&] {
+        cancelled = true;
+        for (auto& job : jobs) {
+            std::lock_guard lock{job->mutex};
+            job->changed.notify_all();
+        }
+    };
+
+    const auto work = [&](const std::size_t worker) {
+        try {
+            query_reader reader{parquet_file, query};
+            row_formatter formatter{format, columns};
+
+            for (auto index = next++; index < count && !cancelled; index = next++) {
+                auto& job = *jobs[static_cast<std::size_t>(index)];
+
+                const auto hand_off = [&] {
+                    std::unique_lock lock{job.mutex};
+                    job.changed.wait(lock, [&] { return job.blocks.size() < max_blocks || cancelled; });
+                    if (!cancelled) {
+                        job.blocks.push_back(std::move(formatter.out));
+                        job.changed.notify_all();
+                    }
+                    formatter.out.clear();
+                };
+
+                reader.scan_row_group(index, [&](const std::vector<const column_cursor*>& projected, const std::size_t slot) {
+                    formatter.row(projected, slot);
+                    if (formatter.out.size() >= block_bytes) {
+                        hand_off();
+                    }
+                });
+
+                if (!formatter.out.empty()) {
+                    hand_off();
+                }
+
+                std::lock_guard lock{job.mutex};
+                job.done = true;
+                job.changed.notify_all();
+            }
+
+            stats[worker] = reader.stats;
+        }
+        catch (...) {
+            {
+                std::lock_guard lock{error_mutex};
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+            cancel();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (std::size_t worker = 0; worker < stats.size(); ++worker) {
+        workers.emplace_back(work, worker);
+    }
+
+    try {
+        for (auto& job : jobs) {
+            while (true) {
+                std::string block;
+                {
+                    std::unique_lock lock{job->mutex};
+                    job->changed.wait(lock, [&] { return !job->blocks.empty() || job->done || cancelled; });
+                    if (job->blocks.empty() || cancelled) {
+                        break;
+                    }
+                    block = std::move(job->blocks.front());
+                    job->blocks.pop_front();
+                    job->changed.notify_all();
+                }
+                write(block);
+            }
+
+            if (cancelled) {
+                break;
+            }
+        }
+    }
+    catch (...) {
+        cancel();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        throw;
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    query_stats total;
+    for (const auto& worker : stats) {
+        total.add(worker);
+    }
+
+    std::cerr << parquet_file << ": " << total << std::endl;
+}
+
+// every wide file of the options into one export, a csv header only before the first
+void export_files(const options& options, const query& query) {
+    const auto format = export_named(options.export_format);
+    const auto to_stdout = options.export_file.empty() || options.export_file == "-";
+
+    const auto descriptor = to_stdout ? STDOUT_FILENO : ::open(options.export_file.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (descriptor < 0) {
+        throw std::runtime_error("Unable to open " + options.export_file + ": " + std::strerror(errno));
+    }
+
+    auto header = true;
+    for (const auto& parquet_file : parquet_files(options)) {
+        export_parquet(parquet_file, query, format, descriptor, options.export_threads, header);
+        header = false;
+    }
+
+    if (!to_stdout && ::close(descriptor) != 0) {
+        throw std::runtime_error("Unable to close " + options.export_file + ": " + std::strerror(errno));
+    }
+}
+
+// command line of a feed converter, called from its main
+inline int run(const int argc, char** argv) {
+
+    // parse arguments
+    options options;
+
+    std::vector<std::string> files;
+
+    for (int index = 1; index < argc; ++index) {
+        const std::string_view argument = argv[index];
+
+        if (argument == "--batch-size" && index + 1 < argc) {
+            options.batch_size = std::stoul(argv[++index]);
+        }
+        else if (argument == "--format" && index + 1 < argc) {
+            options.format = argv[++index];
+        }
+        else if (argument == "--mmap") {
+            options.mmap = true;
+        }
+        else if (argument == "--filter" && index + 1 < argc) {
+            options.filter = argv[++index];
+        }
+        else if (argument == "--demux" && index + 1 < argc) {
+            options.demux = argv[++index];
+        }
+        else if (argument == "--write-buffer" && index + 1 < argc) {
+            options.write_buffer_bytes = std::stoull(argv[++index]);
+        }
+        else if (argument == "--write-buffers" && index + 1 < argc) {
+            options.write_buffers = std::stoul(argv[++index]);
+        }
+        else if (argument == "--direct-io") {
+            options.direct_io = true;
+        }
+        else if (argument == "--writer-threads" && index + 1 < argc) {
+            options.writer_threads = std::stoul(argv[++index]);
+        }
+        else if (argument == "--stats" && index + 1 < argc) {
+            options.stats_file = argv[++index];
+        }
+        else if (argument == "--progress" && index + 1 < argc) {
+            options.progress_seconds = static_cast<std::uint32_t>(std::stoul(argv[++index]));
+        }
+        else if (argument == "--arrow" && index + 1 < argc) {
+            options.arrow_file = argv[++index];
+        }
+        else if (argument == "--feather" && index + 1 < argc) {
+            options.feather_file = argv[++index];
+        }
+        else if (argument == "--shm" && index + 1 < argc) {
+            options.shm_name = argv[++index];
+        }
+        else if (argument == "--shm-slots" && index + 1 < argc) {
+            options.shm_slots = std::max<std::uint64_t>(std::stoull(argv[++index]), 1);
+        }
+        else if (argument == "--shm-slot-bytes" && index + 1 < argc) {
+            options.shm_slot_bytes = std::stoull(argv[++index]);
+        }
+        else if (argument == "--arrow-flush" && index + 1 < argc) {
+            options.arrow_flush_ms = std::stoul(argv[++index]);
+        }
+        else if (argument == "--dataset" && index + 1 < argc) {
+            options.dataset = argv[++index];
+        }
+        else if (argument == "--partitioning" && index + 1 < argc) {
+            options.partitioning = argv[++index];
+        }
+        else if (argument == "--partition-buckets" && index + 1 < argc) {
+            options.partition_buckets = std::stoull(argv[++index]);
+        }
+        else if (argument == "--partition-files" && index + 1 < argc) {
+            options.partition_files = std::stoul(argv[++index]);
+        }
+        else if (argument == "--checkpoint" && index + 1 < argc) {
+            options.checkpoint_file = argv[++index];
+        }
+        else if (argument == "--checkpoint-bytes" && index + 1 < argc) {
+            options.checkpoint_bytes = std::stoull(argv[++index]);
+        }
+        else if (argument == "--write-types" && index + 1 < argc) {
+            options.write_types = argv[++index];
+        }
+        else if (argument == "--write-columns" && index + 1 < argc) {
+            std::string_view remaining{argv[++index]};
+            while (!remaining.empty()) {
+                const auto comma = remaining.find(',');
+                options.write_columns.emplace_back(remaining.substr(0, comma));
+                remaining = comma == std::string_view::npos ? std::string_view{} : remaining.substr(comma + 1);
+            }
+        }
+        else if (argument == "--decompression-threads" && index + 1 < argc) {
+            options.decompression_threads = std::max<std::size_t>(std::stoul(argv[++index]), 1);
+        }
+        else if (argument == "--narrow") {
+            options.narrow = true;
+        }
+        else if (argument == "--orders") {
+            options.orders = true;
+        }
+        else if (argument == "--no-arbitration") {
+            options.arbitrate = false;
+        }
+        else if (argument == "--gap-window" && index + 1 < argc) {
+            options.gap_window_ms = std::stoll(argv[++index]);
+        }
+        else if (argument == "--no-wide") {
+            options.wide = false;
+        }
+        else if (argument == "--encoders" && index + 1 < argc) {
+            options.encoder_threads = std::stoul(argv[++index]);
+        }
+        else if (argument == "--queue-depth" && index + 1 < argc) {
+            options.queue_depth = std::stoul(argv[++index]);
+        }
+        else if (argument == "--row-group-bytes" && index + 1 < argc) {
+            options.row_group_bytes = std::stoll(argv[++index]);
+        }
+        else if (argument == "--memory-budget" && index + 1 < argc) {
+            options.memory_budget = std::stoll(argv[++index]);
+        }
+        else if (argument == "--page-bytes" && index + 1 < argc) {
+            options.page_bytes = std::stoll(argv[++index]);
+        }
+        else if (argument == "--live" && index + 2 < argc) {
+            options.interface = argv[++index];
+            options.group = argv[++index];
+        }
+        else if (argument == "--roll-seconds" && index + 1 < argc) {
+            options.roll_seconds = std::stoll(argv[++index]);
+        }
+        else if (argument == "--roll-bytes" && index + 1 < argc) {
+            options.roll_bytes = std::stoull(argv[++index]);
+        }
+        else if (argument == "--ring-blocks" && index + 1 < argc) {
+            options.ring_blocks = static_cast<std::uint32_t>(std::stoul(argv[++index]));
+        }
+        else if (argument == "--query") {
+            options.read_only = true;
+        }
+        else if (argument == "--export" && index + 1 < argc) {
+            options.export_format = argv[++index];
+            options.read_only = true;
+        }
+        else if (argument == "--export-file" && index + 1 < argc) {
+            options.export_file = argv[++index];
+        }
+        else if (argument == "--export-threads" && index + 1 < argc) {
+            options.export_threads = std::max<std::size_t>(std::stoul(argv[++index]), 1);
+        }
+        else if (argument == "--select" && index + 1 < argc) {
+            std::string_view remaining{argv[++index]};
+            while (!remaining.empty()) {
+                const auto comma = remaining.find(',');
+                options.select.emplace_back(remaining.substr(0, comma));
+                remaining = comma == std::string_view::npos ? std::string_view{} : remaining.substr(comma + 1);
+            }
+        }
+        else if (argument == "--types" && index + 1 < argc) {
+            options.message_types = argv[++index];
+        }
+        else if (argument == feed::symbol_option && index + 1 < argc) {
+            options.symbol = argv[++index];
+        }
+        else if (argument == feed::instrument_option && index + 1 < argc) {
+            options.instrument = std::stoull(argv[++index]);
+        }
+        else if (argument == "--from" && index + 1 < argc) {
+            options.from = feed::time_filter(argv[++index]);
+        }
+        else if (argument == "--to" && index + 1 < argc) {
+            options.to = feed::time_filter(argv[++index]);
+        }
+        else if (argument == "--order" && index + 1 < argc) {
+            options.first_order = options.last_order = std::stoull(argv[++index]);
+        }
+        else if (argument == "--match" && index + 1 < argc) {
+            options.match_number = std::stoull(argv[++index]);
+        }
+        else if (argument == "--first-order" && index + 1 < argc) {
+            options.first_order = std::stoull(argv[++index]);
+        }
+        else if (argument == "--last-order" && index + 1 < argc) {
+            options.last_order = std::stoull(argv[++index]);
+        }
+        else if (argument == "--no-page-index") {
+            options.page_index = false;
+        }
+        else if (argument == "--no-lookups") {
+            options.default_lookups = false;
+        }
+        else if (argument == "--lookup" && index + 1 < argc) {
+            options.lookups.emplace_back(argv[++index]);
+        }
+        else if (argument == "--bloom-ndv" && index + 1 < argc) {
+            options.bloom_ndv = std::stoi(argv[++index]);
+        }
+        else if (argument == "--bloom-fpp" && index + 1 < argc) {
+            options.bloom_fpp = std::stod(argv[++index]);
+        }
+        else if (argument == "--profile" && index + 1 < argc) {
+            options.profile = argv[++index];
+        }
+        else if (argument == "--column" && index + 1 < argc) {
+            const std::string_view column = argv[++index];
+            const auto equals = column.find('=');
+            if (equals == std::string_view::npos) {
+                files.clear();
+                break;
+            }
+            options.columns.emplace_back(column.substr(0, equals), column.substr(equals + 1));
+        }
+        else if (argument == "--shards" && index + 1 < argc) {
+            options.shards = std::stoul(argv[++index]);
+        }
+        else if (argument == "--threads" && index + 1 < argc) {
+            options.threads = std::max<std::size_t>(std::stoul(argv[++index]), 1);
+        }
+        else if (argument.starts_with("--")) {
+            files.clear();
+            break;
+        }
+        else {
+            files.emplace_back(argument);
+        }
+    }
+
+    if (files.size() == 2)
+    {
+        options.pcap_file = files[0];
+        options.parquet_file = files[1];
+    }
+    else if (files.size() == 1 && (options.read_only || !options.interface.empty()))
+    {
+        options.parquet_file = files[0];
+    }
+    else if (files.size() == 1)
+    {
+        options.pcap_file = files[0];
+    }
+    else
+    {
+        std::cout << "usage: " << argv[0] << " [--batch-size rows] [--write-types message_types] [--write-columns columns] [--format auto|pcap|moldudp64|binaryfile] [--mmap] [--filter expression] [--demux channel|session] [--write-buffer bytes] [--write-buffers buffers] [--direct-io] [--writer-threads threads] [--decompression-threads threads] [--stats file] [--progress seconds] [--arrow file] [--feather file] [--shm name] [--shm-slots batches] [--shm-slot-bytes bytes] [--arrow-flush milliseconds] [--narrow] [--no-wide] [--orders] [--no-arbitration] [--gap-window milliseconds] [--encoders threads] [--queue-depth batches] [--threads chunks] [--checkpoint file] [--checkpoint-bytes bytes] [--shards files] [--dataset root] [--partitioning " << feed::default_partitioning << "] [--partition-buckets buckets] [--partition-files files] [--row-group-bytes bytes] [--memory-budget bytes] [--page-bytes bytes] [--profile name] [--column name=settings] [--live interface group:port] [--roll-seconds seconds] [--roll-bytes bytes] [--ring-blocks blocks] [--query] [--export csv|json|text] [--export-file file] [--export-threads threads] [--select columns] [--types message_types] " << feed::filter_usage << " [--order number] [--first-order number] [--last-order number] [--match number] [--no-page-index] [--no-lookups] [--lookup column] [--bloom-ndv values] [--bloom-fpp probability] pcap_file parquet_file" << std::endl;
+        return -1;
+    }
+
+    // rows are only read back from local wide files, demuxed channel files are queried one at a time
+    if (options.read_only && (!options.wide || !options.interface.empty() || !options.demux.empty() || remote(options.parquet_file) || remote(options.dataset))) {
+        std::cerr << "--query and --export read local wide parquet files, without --no-wide, --live, --demux or an object store uri" << std::endl;
+        return -1;
+    }
+
+    // outputs are all closed when it goes
+    const object_stores_guard stores;
+
+    if (!options.read_only) {
+        file_output.buffer_bytes = options.direct_io && options.write_buffer_bytes == 0 ? std::size_t{8} << 20 : options.write_buffer_bytes;
+        file_output.buffers = options.write_buffers;
+        file_output.direct = options.direct_io;
+        file_output.threads = options.writer_threads;
+
+        const auto start = std::chrono::steady_clock::now();
+        {
+            progress progress{options.progress_seconds};
+            write_parquet(options);
+        }
+
+        if (!options.stats_file.empty()) {
+            write_statistics(options.stats_file, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+    }
+
+    // rows are only read back for --query and --export
+    if (options.read_only) {
+        const auto query = query_of(options);
+        if (!options.export_format.empty()) {
+            export_files(options, query);
+            return 0;
+        }
+        for (const auto& parquet_file : parquet_files(options)) {
+            read_parquet(parquet_file, query);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,566 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <endian.h>
+#include <sys/types.h>
+
+#include "parquet/column_writer.h"
+#include "parquet/file_writer.h"
+#include "parquet/schema.h"
+
+// feed independent parts of an itch record, wire decoding, column batches and order storage, included ahead of the feed types
+
+///////////////////////////////////////////////////////////////////////
+// wire decoding
+///////////////////////////////////////////////////////////////////////
+
+// big endian integer at any alignment, a single load and byte swap
+template <typename integer>
+inline integer load_big_endian(const u_char* position) {
+    integer value;
+    std::memcpy(&value, position, sizeof(value));
+
+    if constexpr (sizeof(value) == 8) {
+        return be64toh(value);
+    }
+    else if constexpr (sizeof(value) == 4) {
+        return be32toh(value);
+    }
+    else if constexpr (sizeof(value) == 2) {
+        return be16toh(value);
+    }
+    else {
+        return value;
+    }
+}
+
+// length of a space padded alpha, the first space found a word at a time without branches
+template <std::size_t capacity>
+inline std::size_t padded_length(const u_char* value) {
+    if constexpr (capacity <= 8) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, value, capacity);
+
+        // spaces become zero bytes, the lowest marked byte is the first zero, bytes past the field are never zero
+        word = le64toh(word) ^ 0x2020202020202020;
+        const auto zeros = (word - 0x0101010101010101) & ~word & 0x8080808080808080;
+        return std::min<std::size_t>(static_cast<std::size_t>(std::countr_zero(zeros)) / 8, capacity);
+    }
+    else {
+        const auto head = padded_length<8>(value);
+        return head < 8 ? head : 8 + padded_length<capacity - 8>(value + 8);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+// fixed width strings
+///////////////////////////////////////////////////////////////////////
+
+// inline alpha field, decoding never allocates
+template <std::size_t capacity>
+struct fixed_string {
+
+    fixed_string() = default;
+
+    // left justified alpha, padding starts at the first space
+    explicit fixed_string(const u_char* value) {
+        assign(value, padded_length<capacity>(value));
+    }
+
+    explicit fixed_string(const std::string_view value) {
+        assign(reinterpret_cast<const u_char*>(value.data()), std::min(value.size(), capacity));
+    }
+
+    void assign(const u_char* value, const std::size_t count) {
+        std::memcpy(bytes.data(), value, count);
+        length = static_cast<std::uint8_t>(count);
+    }
+
+    [[nodiscard]] std::string_view view() const {
+        return {bytes.data(), length};
+    }
+
+    operator std::string_view() const {
+        return view();
+    }
+
+    std::array<char, capacity> bytes{};
+    std::uint8_t length = 0;
+};
+
+template <std::size_t capacity>
+std::ostream& operator<<(std::ostream& stream, const fixed_string<capacity>& value) {
+    return stream << value.view();
+}
+
+///////////////////////////////////////////////////////////////////////
+// parquet column batch
+///////////////////////////////////////////////////////////////////////
+
+// parquet physical values, matching the conversions made by parquet::StreamWriter
+inline std::int32_t parquet_value(const char value) {
+    return static_cast<std::uint8_t>(value);
+}
+
+inline std::int32_t parquet_value(const std::uint8_t value) {
+    return value;
+}
+
+inline std::int32_t parquet_value(const std::uint16_t value) {
+    return value;
+}
+
+inline std::int32_t parquet_value(const std::uint32_t value) {
+    return static_cast<std::int32_t>(value);
+}
+
+inline std::int64_t parquet_value(const std::uint64_t value) {
+    return static_cast<std::int64_t>(value);
+}
+
+// timestamp columns are stored in nanoseconds
+inline std::int64_t parquet_value(const std::chrono::nanoseconds value) {
+    return value.count();
+}
+
+// buffered parquet column, values plus definition levels for optional fields
+template <typename field, parquet::Repetition::type repetition = field::repetition>
+struct column {
+
+    using field_type = field;
+    using physical_type = parquet::PhysicalType<field::parquet_type>;
+    using value_type = typename physical_type::c_type;
+
+    static constexpr auto optional = repetition == parquet::Repetition::OPTIONAL;
+    static constexpr auto byte_array = std::is_same_v<value_type, parquet::ByteArray>;
+
+    column() = default;
+
+    void reserve(const std::size_t capacity) {
+        if constexpr (optional) {
+            levels.reserve(capacity);
+        }
+        if constexpr (byte_array) {
+            bytes.reserve(capacity * field::size);
+        }
+        values.reserve(capacity);
+    }
+
+    void append(const field& value) {
+        if constexpr (requires { value.data.has_value(); }) {
+            if constexpr (optional) {
+                levels.push_back(value.data.has_value());
+                if (value.data) {
+                    push(*value.data);
+                }
+            } else {
+                push(*value.data);
+            }
+        } else {
+            push(value.data);
+        }
+    }
+
+    // sparse append, optional rows skipped here are null once padded
+    void append(const field& value, const std::size_t row) {
+        if constexpr (optional) {
+            if (!value.data || levels.size() > row) {
+                return;
+            }
+            levels.resize(row, 0);
+            levels.push_back(1);
+            push(*value.data);
+        }
+    }
+
+    void pad(const std::size_t rows) {
+        if constexpr (optional) {
+            levels.resize(rows, 0);
+        }
+    }
+
+    void push(const auto& value) {
+        if constexpr (byte_array) {
+            const std::string_view view{value};
+            bytes.insert(bytes.end(), view.begin(), view.end());
+            values.emplace_back(static_cast<std::uint32_t>(view.size()), nullptr);
+        } else if constexpr (std::is_same_v<value_type, std::int64_t> && std::is_same_v<std::remove_cvref_t<decltype(value)>, std::uint32_t>) {
+            // decimal prices widen the unsigned wire value
+            values.push_back(value);
+        } else {
+            values.push_back(parquet_value(value));
+        }
+    }
+
+    // write buffered rows with the typed column writer
+    void write(parquet::ColumnWriter* writer) {
+        prepare();
+        write(writer, 0, rows(), 0);
+    }
+
+    // point byte array values into the buffered bytes, once before the rows are written
+    void prepare() {
+        if constexpr (byte_array) {
+            static constexpr std::uint8_t empty = 0;
+            auto pointer = bytes.empty() ? &empty : bytes.data();
+            for (auto& value : values) {
+                value.ptr = pointer;
+                pointer += value.len;
+            }
+        }
+    }
+
+    // count rows from first, value is the first of their values, returns the value after them
+    std::size_t write(parquet::ColumnWriter* writer, const std::size_t first, const std::size_t count, const std::size_t value) {
+        auto next = value + count;
+        if constexpr (optional) {
+            next = value + static_cast<std::size_t>(std::count(levels.begin() + first, levels.begin() + first + count, 1));
+        }
+
+        static_cast<parquet::TypedColumnWriter<physical_type>*>(writer)->WriteBatch(
+            static_cast<std::int64_t>(count), optional ? levels.data() + first : nullptr, nullptr, values.data() + value);
+        return next;
+    }
+
+    [[nodiscard]] std::size_t rows() const {
+        return optional ? levels.size() : values.size();
+    }
+
+    // heap held by the buffers, cleared rows keep their capacity
+    [[nodiscard]] std::size_t allocated_bytes() const {
+        return levels.capacity() * sizeof(std::int16_t) + values.capacity() * sizeof(value_type) + bytes.capacity();
+    }
+
+    void clear() {
+        levels.clear();
+        values.clear();
+        bytes.clear();
+    }
+
+    static auto node() {
+        if constexpr (requires { field::logical_type(); }) {
+            return parquet::schema::PrimitiveNode::Make(field::name, repetition, field::logical_type(), field::parquet_type);
+        } else {
+            return parquet::schema::PrimitiveNode::Make(field::name, repetition, field::parquet_type, field::converted_type);
+        }
+    }
+
+    std::vector<std::int16_t> levels;
+    std::vector<value_type> values;
+    std::vector<std::uint8_t> bytes;
+};
+
+// batch columns written to a file, every column unless projected
+struct projection {
+    std::vector<std::uint8_t> dropped; // by batch column
+
+    [[nodiscard]] bool keeps(const std::size_t column) const {
+        return column >= dropped.size() || dropped[column] == 0;
+    }
+};
+
+// buffered parquet row batch, one column buffer per schema node
+template <typename... columns>
+struct batch {
+
+    batch() = default;
+
+    explicit batch(const std::size_t capacity) {
+        reserve(capacity);
+    }
+
+    void reserve(const std::size_t capacity) {
+        (std::get<columns>(data).reserve(capacity), ...);
+    }
+
+    template <typename row>
+    void append(const row& record) {
+        (std::get<columns>(data).append(record.template get<typename columns::field_type>()), ...);
+        ++size;
+    }
+
+    // required columns on every row, optional columns only for the listed fields
+    template <typename row, typename... lists>
+    void append_sparse(const row& record, const lists&... touched) {
+        ([&] {
+            if constexpr (!columns::optional) {
+                std::get<columns>(data).append(record.template get<typename columns::field_type>());
+            }
+        }(), ...);
+
+        (append_fields(record, touched), ...);
+        ++size;
+    }
+
+    template <typename row, template <typename...> typename list, typename... fields>
+    void append_fields(const row& record, const list<fields...>&) {
+        (std::get<column<fields>>(data).append(record.template get<fields>(), size), ...);
+    }
+
+    static constexpr std::size_t column_count = sizeof...(columns);
+
+    // null levels for optional rows skipped by sparse appends
+    void pad() {
+        (std::get<columns>(data).pad(size), ...);
+    }
+
+    // write buffered columns into an open row group, projected out columns are left unwritten
+    void write(parquet::RowGroupWriter* row_group, const projection& projected = {}) {
+        pad();
+        write(row_group, projected, std::index_sequence_for<columns...>{});
+    }
+
+    // write one padded column, different columns can be written from different threads
+    void write_column(const std::size_t column, parquet::ColumnWriter* writer) {
+        write_column(column, writer, std::index_sequence_for<columns...>{});
+    }
+
+    template <std::size_t... index>
+    void write_column(const std::size_t column, parquet::ColumnWriter* writer, std::index_sequence<index...>) {
+        (void)((index == column && (std::get<index>(data).write(writer), true)) || ...);
+    }
+
+    template <std::size_t... index>
+    void write(parquet::RowGroupWriter* row_group, const projection& projected, std::index_sequence<index...>) {
+        int written = 0;
+        ([&] {
+            if (projected.keeps(index)) {
+                std::get<index>(data).write(row_group->column(written++));
+            }
+        }(), ...);
+    }
+
+    // first value of every column in the rows not yet written
+    using cursor = std::array<std::size_t, sizeof...(columns)>;
+
+    // padded rows ready to be written in slices
+    void seal() {
+        pad();
+        (std::get<columns>(data).prepare(), ...);
+    }
+
+    // count rows from first, after seal, the cursor moves past their values
+    void write(parquet::RowGroupWriter* row_group, const projection& projected, const std::size_t first, const std::size_t count, cursor& values) {
+        write(row_group, projected, first, count, values, std::index_sequence_for<columns...>{});
+    }
+
+    template <std::size_t... index>
+    void write(parquet::RowGroupWriter* row_group, const projection& projected, const std::size_t first, const std::size_t count, cursor& values, std::index_sequence<index...>) {
+        int written = 0;
+        ([&] {
+            if (projected.keeps(index)) {
+                values[index] = std::get<index>(data).write(row_group->column(written++), first, count, values[index]);
+            }
+        }(), ...);
+    }
+
+    void clear() {
+        (std::get<columns>(data).clear(), ...);
+        size = 0;
+    }
+
+    [[nodiscard]] bool empty() const {
+        return size == 0;
+    }
+
+    [[nodiscard]] std::size_t allocated_bytes() const {
+        return (std::size_t{0} + ... + std::get<columns>(data).allocated_bytes());
+    }
+
+    // parquet schema nodes
+    static auto nodes() {
+        return parquet::schema::NodeVector { columns::node()... };
+    }
+
+    static auto nodes(const projection& projected) {
+        parquet::schema::NodeVector kept;
+        auto all = nodes();
+        for (std::size_t index = 0; index < all.size(); ++index) {
+            if (projected.keeps(index)) {
+                kept.push_back(std::move(all[index]));
+            }
+        }
+        return kept;
+    }
+
+    // parquet schema
+    static auto schema(const projection& projected = {}) {
+        return std::static_pointer_cast<parquet::schema::GroupNode>(parquet::schema::GroupNode::Make("schema", parquet::Repetition::REQUIRED, nodes(projected)));
+    }
+
+    // columns named, every column when none are
+    static projection project(const std::vector<std::string>& names) {
+        projection projected;
+        if (names.empty()) {
+            return projected;
+        }
+
+        const auto all = nodes();
+        projected.dropped.assign(all.size(), 1);
+
+        for (const auto& name : names) {
+            const auto found = std::find_if(all.begin(), all.end(), [&](const auto& node) { return node->name() == name; });
+            if (found == all.end()) {
+                throw std::invalid_argument("Unknown column " + name);
+            }
+            projected.dropped[static_cast<std::size_t>(found - all.begin())] = 0;
+        }
+
+        return projected;
+    }
+
+    std::tuple<columns...> data;
+    std::size_t size = 0;
+};
+
+// column batch matching a record field list
+template <typename fields>
+struct batch_of;
+
+template <typename... fields>
+struct batch_of<std::tuple<const fields&...>> {
+    using type = batch<column<fields>...>;
+};
+
+///////////////////////////////////////////////////////////////////////
+// order storage
+///////////////////////////////////////////////////////////////////////
+
+// open addressing map from order number to pool index, linear probing with backward shift deletes
+struct order_index {
+
+    static constexpr std::uint32_t empty = std::numeric_limits<std::uint32_t>::max();
+
+    struct slot {
+        std::uint64_t key = 0;
+        std::uint32_t index = empty;
+    };
+
+    explicit order_index(const std::size_t capacity = std::size_t{1} << 20) {
+        resize(std::bit_ceil(capacity));
+    }
+
+    [[nodiscard]] std::size_t home(const std::uint64_t key) const {
+        return static_cast<std::size_t>((key * 0x9e3779b97f4a7c15ull) >> shift);
+    }
+
+    [[nodiscard]] std::uint32_t find(const std::uint64_t key) const {
+        for (auto position = home(key);; position = (position + 1) & mask) {
+            const auto& slot = slots[position];
+            if (slot.index == empty || slot.key == key) {
+                return slot.index;
+            }
+        }
+    }
+
+    // returns the index previously stored under key, or empty
+    std::uint32_t insert(const std::uint64_t key, const std::uint32_t index) {
+        if ((count + 1) * 4 > slots.size() * 3) {
+            resize(slots.size() * 2);
+        }
+
+        for (auto position = home(key);; position = (position + 1) & mask) {
+            auto& slot = slots[position];
+            if (slot.index == empty) {
+                slot = {key, index};
+                count += 1;
+                return empty;
+            }
+            if (slot.key == key) {
+                return std::exchange(slot.index, index);
+            }
+        }
+    }
+
+    // returns the removed index, or empty
+    std::uint32_t erase(const std::uint64_t key) {
+        auto position = home(key);
+        for (;; position = (position + 1) & mask) {
+            if (slots[position].index == empty) {
+                return empty;
+            }
+            if (slots[position].key == key) {
+                break;
+            }
+        }
+
+        const auto removed = slots[position].index;
+
+        // pull later entries of the probe run back over the hole, no tombstones
+        for (auto next = (position + 1) & mask; slots[next].index != empty; next = (next + 1) & mask) {
+            if (((next - home(slots[next].key)) & mask) >= ((next - position) & mask)) {
+                slots[position] = slots[next];
+                position = next;
+            }
+        }
+
+        slots[position] = slot{};
+        count -= 1;
+
+        return removed;
+    }
+
+    void resize(const std::size_t capacity) {
+        auto previous = std::move(slots);
+
+        slots.assign(capacity, slot{});
+        mask = capacity - 1;
+        shift = 64 - std::countr_zero(capacity);
+        count = 0;
+
+        for (const auto& slot : previous) {
+            if (slot.index != empty) {
+                insert(slot.key, slot.index);
+            }
+        }
+    }
+
+    std::vector<slot> slots;
+    std::size_t mask = 0;
+    std::size_t count = 0;
+    int shift = 64;
+};
+
+// order storage recycled through a free list, the index only stores positions
+template <typename order>
+struct order_pool {
+
+    std::uint32_t allocate() {
+        if (!free.empty()) {
+            const auto index = free.back();
+            free.pop_back();
+            return index;
+        }
+
+        orders.emplace_back();
+        return static_cast<std::uint32_t>(orders.size() - 1);
+    }
+
+    void release(const std::uint32_t index) {
+        orders[index] = order{};
+        free.push_back(index);
+    }
+
+    order& operator[](const std::uint32_t index) {
+        return orders[index];
+    }
+
+    std::vector<order> orders;
+    std::vector<std::uint32_t> free;
+};
@@ -1,17 +1,26 @@
+#include <algorithm>
+#include <array>
 #include <chrono>
-#include <cstring>
+#include <cstdio>
 #include <ctime>
+#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "pcap.h"
-#include "netinet/if_ether.h"
-#include "netinet/ip.h"
-#include "netinet/udp.h"
-#include "arrow/io/file.h"
-#include "parquet/exception.h"
-#include "parquet/stream_reader.h"
-#include "parquet/stream_writer.h"
+#include "parquet/file_writer.h"
+#include "parquet/schema.h"
+
+#include "itch_types.h"
 
 namespace jnx::itch {
 
@@ -26,6 +35,7 @@ struct pcap_index {
     static constexpr auto repetition = parquet::Repetition::REQUIRED;
     static constexpr auto parquet_type = parquet::Type::INT64;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_64;
+    static constexpr auto encoding = parquet::Encoding::DELTA_BINARY_PACKED;
 
     pcap_index() = default;
 
@@ -48,38 +58,34 @@ inline auto& operator<<(std::ostream& stream, const pcap_index& field) {
     return stream << field.data;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const pcap_index& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, pcap_index& field) {
-    return stream >> field.data;
-}
-
 // pcap timestamp
 struct pcap_timestamp {
 
-    static constexpr auto name = "timestamp";
+    static constexpr auto name = "pcap_timestamp";
     static constexpr auto repetition = parquet::Repetition::REQUIRED;
     static constexpr auto parquet_type = parquet::Type::INT64;
-    static constexpr auto converted_type = parquet::ConvertedType::TIMESTAMP_MICROS;
+    static constexpr auto encoding = parquet::Encoding::DELTA_BINARY_PACKED;
 
     pcap_timestamp() = default;
 
-    void set(const std::chrono::microseconds value) {
+    void set(const std::chrono::nanoseconds value) {
         data = value;
     }
 
+    // captures are opened with nanosecond precision, so tv_usec holds nanoseconds
     void set(const pcap_pkthdr *pkthdr) {
-        const auto duration = std::chrono::seconds{pkthdr->ts.tv_sec} + std::chrono::microseconds{pkthdr->ts.tv_usec};
-        data = duration_cast<std::chrono::microseconds>(duration);
+        data = std::chrono::seconds{pkthdr->ts.tv_sec} + std::chrono::nanoseconds{pkthdr->ts.tv_usec};
+    }
+
+    static auto logical_type() {
+        return parquet::LogicalType::Timestamp(true, parquet::LogicalType::TimeUnit::NANOS);
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, logical_type(), parquet_type);
     }
 
-    std::chrono::microseconds data;
+    std::chrono::nanoseconds data;
 };
 
 inline auto& operator<<(std::ostream& stream, const pcap_timestamp& field) {
@@ -87,18 +93,6 @@ inline auto& operator<<(std::ostream& stream, const pcap_timestamp& field) {
     return stream << std::put_time(std::gmtime(&timestamp), "%Y-%m-%d %X");
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const pcap_timestamp& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, pcap_timestamp& field) {
-    std::chrono::microseconds microseconds;
-    stream >> microseconds;
-    field.set(microseconds);
-
-    return stream;
-}
-
 ///////////////////////////////////////////////////////////////////////
 // itch header types
 ///////////////////////////////////////////////////////////////////////
@@ -115,7 +109,7 @@ struct session {
     session() = default;
 
     void set(u_char** current) {
-        data.assign(reinterpret_cast<char *>(*current), size);
+        data.assign(*current, size);
         *current += size;
     }
 
@@ -123,21 +117,13 @@ struct session {
         return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
-    std::string data;
+    fixed_string<size> data;
 };
 
 inline auto& operator<<(std::ostream& stream, const session& field) {
     return stream << field.data;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const session& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, session& field) {
-    return stream >> field.data;
-}
-
 // message sequence
 struct message_sequence {
 
@@ -145,12 +131,13 @@ struct message_sequence {
     static constexpr auto repetition = parquet::Repetition::REQUIRED;
     static constexpr auto parquet_type = parquet::Type::INT64;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_64;
+    static constexpr auto encoding = parquet::Encoding::DELTA_BINARY_PACKED;
     static constexpr std::uint32_t size = 8;
 
     message_sequence() = default;
 
     void set(u_char** current) {
-        data = htobe64(*reinterpret_cast<std::uint64_t*>(*current));
+        data = load_big_endian<std::uint64_t>(*current);
         *current += size;
     }
 
@@ -169,14 +156,6 @@ inline auto& operator<<(std::ostream& stream, const message_sequence& field) {
     return stream << field.data;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const message_sequence& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, message_sequence& field) {
-    return stream >> field.data;
-}
-
 // message index (count)
 struct message_index {
 
@@ -189,7 +168,7 @@ struct message_index {
     message_index() = default;
 
     void set(u_char** current) {
-        count = htobe16(*reinterpret_cast<uint16_t*>(*current));
+        count = load_big_endian<std::uint16_t>(*current);
         data = 0;
         *current += size;
     }
@@ -211,14 +190,6 @@ inline auto& operator<<(std::ostream& stream, const message_index& field) {
     return stream << field.data;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const message_index& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, message_index& field) {
-    return stream >> field.data;
-}
-
 // message length
 struct message_length {
 
@@ -228,7 +199,7 @@ struct message_length {
     message_length() = default;
 
     void set(u_char** current, u_char** message) {
-        data = htobe16(*reinterpret_cast<std::uint16_t*>(*current));
+        data = load_big_endian<std::uint16_t>(*current);
         *current += size;
         *message = *current;
         *current += data;
@@ -264,17 +235,6 @@ inline auto& operator<<(std::ostream& stream, const message_type& field) {
     return stream << field.data;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const message_type& field) {
-    return stream << static_cast<uint8_t>(field.data);
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, message_type& field) {
-    uint8_t data = 0;
-    stream >> data;
-    field.data = static_cast<char>(data);
-    return stream;
-}
-
 ///////////////////////////////////////////////////////////////////////
 // itch message types
 ///////////////////////////////////////////////////////////////////////
@@ -295,11 +255,7 @@ struct attribution {
     }
 
     void set(u_char** current) {
-        std::uint32_t index = 0;
-        for (; index < size; ++index) {
-            if (*(*current + index) == ' ') { break; }
-        }
-        data = std::string_view(reinterpret_cast<char *>(*current), index);
+        data.emplace(*current);
         *current += size;
     }
 
@@ -307,7 +263,7 @@ struct attribution {
         return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
-    std::optional<std::string> data;
+    std::optional<fixed_string<size>> data;
 };
 
 inline auto& operator<<(std::ostream& stream, const attribution& field) {
@@ -318,14 +274,6 @@ inline auto& operator<<(std::ostream& stream, const attribution& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const attribution& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, attribution& field) {
-    return stream >> field.data;
-}
-
 // Side of the order.
 struct buy_sell_indicator {
 
@@ -361,27 +309,19 @@ inline auto& operator<<(std::ostream& stream, const buy_sell_indicator& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const buy_sell_indicator& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, buy_sell_indicator& field) {
-    return stream >> field.data;
-}
-
 // Number of shares executed.
 struct executed_quantity {
 
     static constexpr auto name = "executed_quantity";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
+    static constexpr auto parquet_type = parquet::Type::INT32;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
     static constexpr std::uint32_t size = 4;
 
     executed_quantity() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -390,7 +330,7 @@ struct executed_quantity {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -404,14 +344,6 @@ inline auto& operator<<(std::ostream& stream, const executed_quantity& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const executed_quantity& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, executed_quantity& field) {
-    return stream >> field.data;
-}
-
 // Orderbook group identifier.
 struct group {
 
@@ -428,11 +360,7 @@ struct group {
     }
 
     void set(u_char** current) {
-        std::uint32_t index = 0;
-        for (; index < size; ++index) {
-            if (*(*current + index) == ' ') { break; }
-        }
-        data = std::string_view(reinterpret_cast<char *>(*current), index);
+        data.emplace(*current);
         *current += size;
     }
 
@@ -440,7 +368,7 @@ struct group {
         return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
-    std::optional<std::string> data;
+    std::optional<fixed_string<size>> data;
 };
 
 inline auto& operator<<(std::ostream& stream, const group& field) {
@@ -451,27 +379,19 @@ inline auto& operator<<(std::ostream& stream, const group& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const group& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, group& field) {
-    return stream >> field.data;
-}
-
 // Minimum tradable price.
 struct lower_price_limit {
 
     static constexpr auto name = "lower_price_limit";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
+    static constexpr auto parquet_type = parquet::Type::INT32;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
     static constexpr std::uint32_t size = 4;
 
     lower_price_limit() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -480,7 +400,7 @@ struct lower_price_limit {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -494,27 +414,21 @@ inline auto& operator<<(std::ostream& stream, const lower_price_limit& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const lower_price_limit& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, lower_price_limit& field) {
-    return stream >> field.data;
-}
-
 // Reference number of the match.
 struct match_number {
 
     static constexpr auto name = "match_number";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT64;
+    static constexpr auto parquet_type = parquet::Type::INT64;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_64;
+    static constexpr auto encoding = parquet::Encoding::DELTA_BINARY_PACKED;
+    static constexpr bool lookup = true; // point lookups, bloom filtered
     static constexpr std::uint32_t size = 8;
 
     match_number() = default;
 
     void set(u_char** current) {
-        data = htobe64(*reinterpret_cast<std::uint64_t*>(*current));
+        data = load_big_endian<std::uint64_t>(*current);
         *current += size;
     }
 
@@ -523,7 +437,7 @@ struct match_number {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint64_t> data;
@@ -537,27 +451,21 @@ inline auto& operator<<(std::ostream& stream, const match_number& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const match_number& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, match_number& field) {
-    return stream >> field.data;
-}
-
 // Reference number of the replaced order.
 struct new_order_number {
 
     static constexpr auto name = "new_order_number";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT64;
+    static constexpr auto parquet_type = parquet::Type::INT64;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_64;
+    static constexpr auto encoding = parquet::Encoding::DELTA_BINARY_PACKED;
+    static constexpr bool lookup = true; // point lookups, bloom filtered
     static constexpr std::uint32_t size = 8;
 
     new_order_number() = default;
 
     void set(u_char** current) {
-        data = htobe64(*reinterpret_cast<std::uint64_t*>(*current));
+        data = load_big_endian<std::uint64_t>(*current);
         *current += size;
     }
 
@@ -566,7 +474,7 @@ struct new_order_number {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint64_t> data;
@@ -580,27 +488,21 @@ inline auto& operator<<(std::ostream& stream, const new_order_number& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const new_order_number& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, new_order_number& field) {
-    return stream >> field.data;
-}
-
 // Reference number of the accepted order.
 struct order_number {
 
     static constexpr auto name = "order_number";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT64;
+    static constexpr auto parquet_type = parquet::Type::INT64;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_64;
+    static constexpr auto encoding = parquet::Encoding::DELTA_BINARY_PACKED;
+    static constexpr bool lookup = true; // point lookups, bloom filtered
     static constexpr std::uint32_t size = 8;
 
     order_number() = default;
 
     void set(u_char** current) {
-        data = htobe64(*reinterpret_cast<std::uint64_t*>(*current));
+        data = load_big_endian<std::uint64_t>(*current);
         *current += size;
     }
 
@@ -609,7 +511,7 @@ struct order_number {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint64_t> data;
@@ -623,14 +525,6 @@ inline auto& operator<<(std::ostream& stream, const order_number& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const order_number& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, order_number& field) {
-    return stream >> field.data;
-}
-
 // Type of the order.
 struct order_type {
 
@@ -666,14 +560,6 @@ inline auto& operator<<(std::ostream& stream, const order_type& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const order_type& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, order_type& field) {
-    return stream >> field.data;
-}
-
 // International Securities Identification Number (ISIN).
 struct orderbook_code {
 
@@ -690,11 +576,7 @@ struct orderbook_code {
     }
 
     void set(u_char** current) {
-        std::uint32_t index = 0;
-        for (; index < size; ++index) {
-            if (*(*current + index) == ' ') { break; }
-        }
-        data = std::string_view(reinterpret_cast<char *>(*current), index);
+        data.emplace(*current);
         *current += size;
     }
 
@@ -702,7 +584,7 @@ struct orderbook_code {
         return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
-    std::optional<std::string> data;
+    std::optional<fixed_string<size>> data;
 };
 
 inline auto& operator<<(std::ostream& stream, const orderbook_code& field) {
@@ -713,27 +595,19 @@ inline auto& operator<<(std::ostream& stream, const orderbook_code& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const orderbook_code& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, orderbook_code& field) {
-    return stream >> field.data;
-}
-
 // 4 digit Quick code.
 struct orderbook_id {
 
     static constexpr auto name = "orderbook_id";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
+    static constexpr auto parquet_type = parquet::Type::INT32;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
     static constexpr std::uint32_t size = 4;
 
     orderbook_id() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -742,7 +616,7 @@ struct orderbook_id {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -756,27 +630,21 @@ inline auto& operator<<(std::ostream& stream, const orderbook_id& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const orderbook_id& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, orderbook_id& field) {
-    return stream >> field.data;
-}
-
 // Reference number of the original order.
 struct original_order_number {
 
     static constexpr auto name = "original_order_number";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT64;
+    static constexpr auto parquet_type = parquet::Type::INT64;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_64;
+    static constexpr auto encoding = parquet::Encoding::DELTA_BINARY_PACKED;
+    static constexpr bool lookup = true; // point lookups, bloom filtered
     static constexpr std::uint32_t size = 8;
 
     original_order_number() = default;
 
     void set(u_char** current) {
-        data = htobe64(*reinterpret_cast<std::uint64_t*>(*current));
+        data = load_big_endian<std::uint64_t>(*current);
         *current += size;
     }
 
@@ -785,7 +653,7 @@ struct original_order_number {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint64_t> data;
@@ -799,27 +667,20 @@ inline auto& operator<<(std::ostream& stream, const original_order_number& field
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const original_order_number& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, original_order_number& field) {
-    return stream >> field.data;
-}
-
 // Price of the order.
 struct price {
 
     static constexpr auto name = "price";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
+    static constexpr auto parquet_type = parquet::Type::INT32;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
+    static constexpr auto encoding = parquet::Encoding::RLE_DICTIONARY;
     static constexpr std::uint32_t size = 4;
 
     price() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -828,7 +689,7 @@ struct price {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -842,27 +703,19 @@ inline auto& operator<<(std::ostream& stream, const price& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const price& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, price& field) {
-    return stream >> field.data;
-}
-
 // Number of decimal places in price fields.
 struct price_decimals {
 
     static constexpr auto name = "price_decimals";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
+    static constexpr auto parquet_type = parquet::Type::INT32;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
     static constexpr std::uint32_t size = 4;
 
     price_decimals() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -871,7 +724,7 @@ struct price_decimals {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -885,27 +738,19 @@ inline auto& operator<<(std::ostream& stream, const price_decimals& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const price_decimals& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, price_decimals& field) {
-    return stream >> field.data;
-}
-
 // Start of price range for this price tick size.
 struct price_start {
 
     static constexpr auto name = "price_start";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
+    static constexpr auto parquet_type = parquet::Type::INT32;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
     static constexpr std::uint32_t size = 4;
 
     price_start() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -914,7 +759,7 @@ struct price_start {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -928,27 +773,19 @@ inline auto& operator<<(std::ostream& stream, const price_start& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const price_start& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, price_start& field) {
-    return stream >> field.data;
-}
-
 // Price tick size.
 struct price_tick_size {
 
     static constexpr auto name = "price_tick_size";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
+    static constexpr auto parquet_type = parquet::Type::INT32;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
     static constexpr std::uint32_t size = 4;
 
     price_tick_size() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -957,7 +794,7 @@ struct price_tick_size {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -971,27 +808,19 @@ inline auto& operator<<(std::ostream& stream, const price_tick_size& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const price_tick_size& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, price_tick_size& field) {
-    return stream >> field.data;
-}
-
 // Price tick size table identifier.
 struct price_tick_size_table_id {
 
     static constexpr auto name = "price_tick_size_table_id";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
+    static constexpr auto parquet_type = parquet::Type::INT32;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
     static constexpr std::uint32_t size = 4;
 
     price_tick_size_table_id() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -1000,7 +829,7 @@ struct price_tick_size_table_id {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -1014,27 +843,20 @@ inline auto& operator<<(std::ostream& stream, const price_tick_size_table_id& fi
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const price_tick_size_table_id& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, price_tick_size_table_id& field) {
-    return stream >> field.data;
-}
-
 // Total number of shares added to the book.
 struct quantity {
 
     static constexpr auto name = "quantity";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
+    static constexpr auto parquet_type = parquet::Type::INT32;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
+    static constexpr auto encoding = parquet::Encoding::RLE_DICTIONARY;
     static constexpr std::uint32_t size = 4;
 
     quantity() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -1043,7 +865,7 @@ struct quantity {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -1057,27 +879,19 @@ inline auto& operator<<(std::ostream& stream, const quantity& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const quantity& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, quantity& field) {
-    return stream >> field.data;
-}
-
 // Number of shares that represent a round lot.
 struct round_lot_size {
 
     static constexpr auto name = "round_lot_size";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
+    static constexpr auto parquet_type = parquet::Type::INT32;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
     static constexpr std::uint32_t size = 4;
 
     round_lot_size() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -1086,7 +900,7 @@ struct round_lot_size {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -1100,14 +914,6 @@ inline auto& operator<<(std::ostream& stream, const round_lot_size& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const round_lot_size& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, round_lot_size& field) {
-    return stream >> field.data;
-}
-
 // Current short selling price restriction state.
 struct short_selling_state {
 
@@ -1143,14 +949,6 @@ inline auto& operator<<(std::ostream& stream, const short_selling_state& field)
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const short_selling_state& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, short_selling_state& field) {
-    return stream >> field.data;
-}
-
 // Refer to the System Events table below.
 struct system_event {
 
@@ -1186,27 +984,19 @@ inline auto& operator<<(std::ostream& stream, const system_event& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const system_event& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, system_event& field) {
-    return stream >> field.data;
-}
-
 // Number of nanoseconds since last Timestamp – Seconds Message.
 struct timestamp_nanoseconds {
 
     static constexpr auto name = "timestamp_nanoseconds";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
+    static constexpr auto parquet_type = parquet::Type::INT32;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
     static constexpr std::uint32_t size = 4;
 
     timestamp_nanoseconds() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -1215,7 +1005,7 @@ struct timestamp_nanoseconds {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -1229,27 +1019,20 @@ inline auto& operator<<(std::ostream& stream, const timestamp_nanoseconds& field
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const timestamp_nanoseconds& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, timestamp_nanoseconds& field) {
-    return stream >> field.data;
-}
-
 // Number of seconds since midnight of the day that the trading session started.
 struct timestamp_seconds {
 
     static constexpr auto name = "timestamp_seconds";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
+    static constexpr auto parquet_type = parquet::Type::INT32;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
+    static constexpr auto encoding = parquet::Encoding::DELTA_BINARY_PACKED;
     static constexpr std::uint32_t size = 4;
 
     timestamp_seconds() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -1258,7 +1041,7 @@ struct timestamp_seconds {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -1272,14 +1055,6 @@ inline auto& operator<<(std::ostream& stream, const timestamp_seconds& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const timestamp_seconds& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, timestamp_seconds& field) {
-    return stream >> field.data;
-}
-
 // Current trading state.
 struct trading_state {
 
@@ -1315,27 +1090,19 @@ inline auto& operator<<(std::ostream& stream, const trading_state& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const trading_state& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, trading_state& field) {
-    return stream >> field.data;
-}
-
 // Maximum tradable price.
 struct upper_price_limit {
 
     static constexpr auto name = "upper_price_limit";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
+    static constexpr auto parquet_type = parquet::Type::INT32;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
     static constexpr std::uint32_t size = 4;
 
     upper_price_limit() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -1344,7 +1111,7 @@ struct upper_price_limit {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -1358,12 +1125,110 @@ inline auto& operator<<(std::ostream& stream, const upper_price_limit& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const upper_price_limit& field) {
-    return stream << field.data;
+///////////////////////////////////////////////////////////////////////
+// enrichment types
+///////////////////////////////////////////////////////////////////////
+
+// symbol of the orderbook id, from the orderbook directory
+struct symbol {
+
+    static constexpr auto name = "symbol";
+    static constexpr auto repetition = parquet::Repetition::OPTIONAL;
+    static constexpr auto parquet_type = parquet::Type::BYTE_ARRAY;
+    static constexpr auto converted_type = parquet::ConvertedType::UTF8;
+    static constexpr std::uint32_t size = 12;
+
+    symbol() = default;
+
+    void reset() {
+        data.reset();
+    }
+
+    void set(const std::optional<fixed_string<size>>& value) {
+        data = value;
+    }
+
+    static auto node() {
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
+    }
+
+    std::optional<fixed_string<size>> data;
+};
+
+inline auto& operator<<(std::ostream& stream, const symbol& field) {
+    if (field.data) {
+        return stream << field.data.value();
+    }
+
+    return stream;
+}
+
+// quantity left on the order after the message, from the order book
+struct remaining_quantity {
+
+    static constexpr auto name = "remaining_quantity";
+    static constexpr auto repetition = parquet::Repetition::OPTIONAL;
+    static constexpr auto parquet_type = parquet::Type::INT32;
+    static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
+    static constexpr std::uint32_t size = 4;
+
+    remaining_quantity() = default;
+
+    void reset() {
+        data.reset();
+    }
+
+    static auto node() {
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
+    }
+
+    std::optional<std::uint32_t> data;
+};
+
+inline auto& operator<<(std::ostream& stream, const remaining_quantity& field) {
+    if (field.data) {
+        return stream << field.data.value();
+    }
+
+    return stream;
 }
 
-inline auto& operator>>(parquet::StreamReader& stream, upper_price_limit& field) {
-    return stream >> field.data;
+// exchange event time, utc nanoseconds since the epoch from the last seconds message, the nanoseconds of the message and the capture date
+struct event_timestamp {
+
+    static constexpr auto name = "event_timestamp";
+    static constexpr auto repetition = parquet::Repetition::OPTIONAL;
+    static constexpr auto parquet_type = parquet::Type::INT64;
+    static constexpr auto encoding = parquet::Encoding::DELTA_BINARY_PACKED;
+    static constexpr std::uint32_t size = 8;
+
+    event_timestamp() = default;
+
+    void reset() {
+        data.reset();
+    }
+
+    void set(const std::chrono::nanoseconds value) {
+        data = value;
+    }
+
+    static auto logical_type() {
+        return parquet::LogicalType::Timestamp(true, parquet::LogicalType::TimeUnit::NANOS);
+    }
+
+    static auto node() {
+        return parquet::schema::PrimitiveNode::Make(name, repetition, logical_type(), parquet_type);
+    }
+
+    std::optional<std::chrono::nanoseconds> data;
+};
+
+inline auto& operator<<(std::ostream& stream, const event_timestamp& field) {
+    if (field.data) {
+        return stream << field.data->count();
+    }
+
+    return stream;
 }
 
 ///////////////////////////////////////////////////////////////////////
@@ -1411,72 +1276,103 @@ struct record {
     jnx::itch::trading_state trading_state;
     jnx::itch::upper_price_limit upper_price_limit;
 
+    // enrichment fields
+    jnx::itch::symbol symbol;
+    jnx::itch::remaining_quantity remaining_quantity;
+    jnx::itch::event_timestamp event_timestamp;
+
     record() = default;
 
-    // reset composite message record
+    // pcap and header columns, first in the schema
+    static constexpr std::size_t header_columns = 6;
+
+    // reset composite message record, header fields carry over to the next message of the packet
     void reset() {
-        attribution.reset();
-        buy_sell_indicator.reset();
-        executed_quantity.reset();
-        group.reset();
-        lower_price_limit.reset();
-        match_number.reset();
-        new_order_number.reset();
-        order_number.reset();
-        order_type.reset();
-        orderbook_code.reset();
-        orderbook_id.reset();
-        original_order_number.reset();
-        price.reset();
-        price_decimals.reset();
-        price_start.reset();
-        price_tick_size.reset();
-        price_tick_size_table_id.reset();
-        quantity.reset();
-        round_lot_size.reset();
-        short_selling_state.reset();
-        system_event.reset();
-        timestamp_nanoseconds.reset();
-        timestamp_seconds.reset();
-        trading_state.reset();
-        upper_price_limit.reset();
+        for_each_field<header_columns>([](auto& field) { field.reset(); });
+    }
+
+    // parquet column fields
+    auto fields() const {
+        return std::tie(
+            pcap_index,
+            pcap_timestamp,
+            session,
+            message_sequence,
+            message_index,
+            message_type,
+            attribution,
+            buy_sell_indicator,
+            executed_quantity,
+            group,
+            lower_price_limit,
+            match_number,
+            new_order_number,
+            order_number,
+            order_type,
+            orderbook_code,
+            orderbook_id,
+            original_order_number,
+            price,
+            price_decimals,
+            price_start,
+            price_tick_size,
+            price_tick_size_table_id,
+            quantity,
+            round_lot_size,
+            short_selling_state,
+            system_event,
+            timestamp_nanoseconds,
+            timestamp_seconds,
+            trading_state,
+            upper_price_limit,
+            symbol,
+            remaining_quantity,
+            event_timestamp
+        );
+    }
+
+    // apply to every column field from first on, in schema order
+    template <std::size_t first = 0, typename function>
+    void for_each_field(function&& apply) const {
+        const auto all = fields();
+        [&]<std::size_t... index>(std::index_sequence<index...>) {
+            (apply(std::get<first + index>(all)), ...);
+        }(std::make_index_sequence<std::tuple_size_v<decltype(all)> - first>{});
+    }
+
+    template <std::size_t first = 0, typename function>
+    void for_each_field(function&& apply) {
+        std::as_const(*this).template for_each_field<first>([&](const auto& field) {
+            apply(const_cast<std::remove_cvref_t<decltype(field)>&>(field));
+        });
     }
 
     // parquet schema nodes
     static auto nodes() {
-        return parquet::schema::NodeVector {
-            jnx::itch::pcap_index::node(),
-            jnx::itch::pcap_timestamp::node(),
-            jnx::itch::session::node(),
-            jnx::itch::message_sequence::node(),
-            jnx::itch::message_index::node(),
-            jnx::itch::message_type::node(),
-            jnx::itch::attribution::node(),
-            jnx::itch::buy_sell_indicator::node(),
-            jnx::itch::executed_quantity::node(),
-            jnx::itch::group::node(),
-            jnx::itch::lower_price_limit::node(),
-            jnx::itch::match_number::node(),
-            jnx::itch::new_order_number::node(),
-            jnx::itch::order_number::node(),
-            jnx::itch::order_type::node(),
-            jnx::itch::orderbook_code::node(),
-            jnx::itch::orderbook_id::node(),
-            jnx::itch::original_order_number::node(),
-            jnx::itch::price::node(),
-            jnx::itch::price_decimals::node(),
-            jnx::itch::price_start::node(),
-            jnx::itch::price_tick_size::node(),
-            jnx::itch::price_tick_size_table_id::node(),
-            jnx::itch::quantity::node(),
-            jnx::itch::round_lot_size::node(),
-            jnx::itch::short_selling_state::node(),
-            jnx::itch::system_event::node(),
-            jnx::itch::timestamp_nanoseconds::node(),
-            jnx::itch::timestamp_seconds::node(),
-            jnx::itch::trading_state::node(),
-            jnx::itch::upper_price_limit::node()
-        };
+        return []<typename... fields>(std::type_identity<std::tuple<fields...>>) {
+            return parquet::schema::NodeVector { std::remove_cvref_t<fields>::node()... };
+        }(std::type_identity<decltype(std::declval<const record&>().fields())>{});
+    }
+
+    // parquet column field by type
+    template <typename field>
+    const auto& get() const {
+        return std::get<const field&>(fields());
+    }
+
+    template <typename field>
+    auto& get() {
+        return const_cast<field&>(std::as_const(*this).template get<field>());
+    }
+
+    // schema column of a field
+    template <typename field>
+    static constexpr int column() {
+        return []<typename... fields>(std::type_identity<std::tuple<fields...>>) {
+            int index = 0;
+            (void)((std::is_same_v<const field&, fields> || (++index, false)) || ...);
+            return index;
+        }(std::type_identity<decltype(std::declval<const record&>().fields())>{});
     }
 
     // parquet schema
@@ -1485,252 +1381,460 @@ struct record {
     }
 };
 
-inline auto& operator<<(parquet::StreamWriter& stream, const record& row) {
-    return stream
-        << row.pcap_index
-        << row.pcap_timestamp
-        << row.session
-        << row.message_sequence
-        << row.message_index
-        << row.message_type
-        << row.attribution
-        << row.buy_sell_indicator
-        << row.executed_quantity
-        << row.group
-        << row.lower_price_limit
-        << row.match_number
-        << row.new_order_number
-        << row.order_number
-        << row.order_type
-        << row.orderbook_code
-        << row.orderbook_id
-        << row.original_order_number
-        << row.price
-        << row.price_decimals
-        << row.price_start
-        << row.price_tick_size
-        << row.price_tick_size_table_id
-        << row.quantity
-        << row.round_lot_size
-        << row.short_selling_state
-        << row.system_event
-        << row.timestamp_nanoseconds
-        << row.timestamp_seconds
-        << row.trading_state
-        << row.upper_price_limit
-        << parquet::EndRow;
+inline auto& operator<<(std::ostream& stream, const record& row) {
+    row.for_each_field([&](const auto& field) { stream << field << ","; });
+    return stream << std::endl;
 }
 
-inline auto& operator>>(parquet::StreamReader& stream, record& row) {
-    return stream
-        >> row.pcap_index
-        >> row.pcap_timestamp
-        >> row.session
-        >> row.message_sequence
-        >> row.message_index
-        >> row.message_type
-        >> row.attribution
-        >> row.buy_sell_indicator
-        >> row.executed_quantity
-        >> row.group
-        >> row.lower_price_limit
-        >> row.match_number
-        >> row.new_order_number
-        >> row.order_number
-        >> row.order_type
-        >> row.orderbook_code
-        >> row.orderbook_id
-        >> row.original_order_number
-        >> row.price
-        >> row.price_decimals
-        >> row.price_start
-        >> row.price_tick_size
-        >> row.price_tick_size_table_id
-        >> row.quantity
-        >> row.round_lot_size
-        >> row.short_selling_state
-        >> row.system_event
-        >> row.timestamp_nanoseconds
-        >> row.timestamp_seconds
-        >> row.trading_state
-        >> row.upper_price_limit
-        >> parquet::EndRow;
-}
+///////////////////////////////////////////////////////////////////////
+// orderbook directory
+///////////////////////////////////////////////////////////////////////
 
-inline auto& operator<<(std::ostream& stream, const record& row) {
-    return stream
-        << row.pcap_index <<","
-        << row.pcap_timestamp <<","
-        << row.session <<","
-        << row.message_sequence <<","
-        << row.message_index <<","
-        << row.message_type <<","
-        << row.attribution <<","
-        << row.buy_sell_indicator <<","
-        << row.executed_quantity <<","
-        << row.group <<","
-        << row.lower_price_limit <<","
-        << row.match_number <<","
-        << row.new_order_number <<","
-        << row.order_number <<","
-        << row.order_type <<","
-        << row.orderbook_code <<","
-        << row.orderbook_id <<","
-        << row.original_order_number <<","
-        << row.price <<","
-        << row.price_decimals <<","
-        << row.price_start <<","
-        << row.price_tick_size <<","
-        << row.price_tick_size_table_id <<","
-        << row.quantity <<","
-        << row.round_lot_size <<","
-        << row.short_selling_state <<","
-        << row.system_event <<","
-        << row.timestamp_nanoseconds <<","
-        << row.timestamp_seconds <<","
-        << row.trading_state <<","
-        << row.upper_price_limit <<","
-        << std::endl;
-}
+// orderbook id to symbol and listing metadata, filled from orderbook directory messages
+struct orderbook_directory {
+
+    struct listing {
+        decltype(jnx::itch::orderbook_code::data) orderbook_code;
+        decltype(jnx::itch::group::data) group;
+        decltype(jnx::itch::round_lot_size::data) round_lot_size;
+        decltype(jnx::itch::price_decimals::data) price_decimals;
+    };
+
+    // ids are dense security codes, the table grows to the largest id seen
+    static constexpr std::uint32_t max_orderbook_id = 1 << 22;
+
+    void add(const record& record) {
+        if (!record.orderbook_id.data || *record.orderbook_id.data >= max_orderbook_id) {
+            return;
+        }
+
+        const auto id = *record.orderbook_id.data;
+        if (id >= listings.size()) {
+            listings.resize(std::max<std::size_t>(std::size_t{id} + 1, listings.size() * 2));
+        }
+
+        auto& listing = listings[id];
+        listing.orderbook_code = record.orderbook_code.data;
+        listing.group = record.group.data;
+        listing.round_lot_size = record.round_lot_size.data;
+        listing.price_decimals = record.price_decimals.data;
+    }
+
+    void enrich(record& record) const {
+        if (record.orderbook_id.data && *record.orderbook_id.data < listings.size()) {
+            const auto& listing = listings[*record.orderbook_id.data];
+            record.symbol.set(listing.orderbook_code);
+            record.price_decimals.data = listing.price_decimals;
+        }
+    }
+
+    std::vector<listing> listings;
+};
+
+// shard key, rows without an instrument go to the first shard
+inline std::uint64_t instrument(const record& record) {
+    return record.orderbook_id.data.value_or(0);
 }
 
+// dataset partition column of the instrument buckets, ie orderbook_bucket=3
+inline constexpr std::string_view instrument_partition = "orderbook_bucket";
+
 ///////////////////////////////////////////////////////////////////////
-// itch converter
+// event time
 ///////////////////////////////////////////////////////////////////////
 
-// parquet options
-struct options {
-    std::string pcap_file = "itch.pcap";
-    std::string parquet_file = "itch.parquet";
-    std::int64_t max_row_group_size = 1000;
+// itch seconds and nanoseconds to utc, the seconds of the last T message carry over and the session midnight is found from the capture clock
+struct event_clock {
+
+    // utc offsets are whole quarter hours
+    using quarter_hours = std::chrono::duration<std::int64_t, std::ratio<900>>;
+
+    std::chrono::nanoseconds midnight{0}; // utc time of the session midnight, zero until a capture time is seen
+    std::optional<std::uint32_t> seconds; // since midnight, from the last timestamp seconds message
+
+    void enrich(record& record) {
+        if (record.timestamp_seconds.data) {
+            seconds = record.timestamp_seconds.data;
+        }
+
+        // raw dumps carry no capture clock
+        if (!seconds || record.pcap_timestamp.data.count() == 0) {
+            return;
+        }
+
+        const auto time = std::chrono::seconds{*seconds} + std::chrono::nanoseconds{record.timestamp_nanoseconds.data.value_or(0)};
+        const auto captured = record.pcap_timestamp.data;
+
+        // kept while the capture clock stays on the same day, so clock jitter never moves it
+        if (midnight.count() == 0 || std::chrono::abs(captured - time - midnight) > std::chrono::hours{1}) {
+            midnight = std::chrono::round<quarter_hours>(captured - time);
+        }
+
+        record.event_timestamp.set(midnight + time);
+    }
 };
 
-// itch converter
-struct converter {
+///////////////////////////////////////////////////////////////////////
+// itch message tables
+///////////////////////////////////////////////////////////////////////
+
+// fields set by one message type
+template <typename... fields>
+struct field_list {
 
-    jnx::itch::record record;
-    parquet::StreamWriter writer;
-    std::shared_ptr<arrow::io::FileOutputStream> outfile;
-    std::shared_ptr<parquet::schema::GroupNode> schema;
-    parquet::WriterProperties::Builder builder;
+    // bytes the fields take on the wire after the message type
+    static constexpr std::uint32_t size = (fields::size + ... + 0);
 
-    explicit converter(const options& options) : record{} {
-        PARQUET_ASSIGN_OR_THROW(outfile, arrow::io::FileOutputStream::Open(options.parquet_file));
-        schema = jnx::itch::record::schema();
-        writer = parquet::StreamWriter{parquet::ParquetFileWriter::Open(outfile, schema, builder.build())};
-        writer.SetMaxRowGroupSize(options.max_row_group_size);
+    // narrow message batch, header columns plus the fields, the symbol and the event time
+    using message_batch = batch<
+        column<pcap_index>,
+        column<pcap_timestamp>,
+        column<session>,
+        column<message_sequence>,
+        column<message_index>,
+        column<message_type>,
+        column<fields, parquet::Repetition::REQUIRED>...,
+        column<symbol>,
+        column<event_timestamp>>;
+
+    static void reset(record& record) {
+        (record.template get<fields>().reset(), ...);
     }
 
-    // return udp payload and length by skipping headers in a packet
-    bool try_get_jnx_itch(const u_char *packet, u_char **payload, std::int32_t *length) {
+    // decode the fields in wire order, unrolled per message type
+    static void decode(record& record, u_char** message) {
+        (record.template get<fields>().set(message), ...);
+    }
+};
+
+// fields set after decoding by the directory and order book
+using enrichment_fields = field_list<event_timestamp, symbol, remaining_quantity, price, buy_sell_indicator, orderbook_id, group, price_decimals>;
+
+// Order Added With Attributes Message
+struct order_added_with_attributes_message {
+    static constexpr auto name = "order_added_with_attributes_message";
+    static constexpr auto type = 'F';
+
+    using fields = field_list<
+        timestamp_nanoseconds,
+        order_number,
+        buy_sell_indicator,
+        quantity,
+        orderbook_id,
+        group,
+        price,
+        attribution,
+        order_type>;
+
+    using batch = fields::message_batch;
+};
+
+// Order Added Without Attributes Message
+struct order_added_without_attributes_message {
+    static constexpr auto name = "order_added_without_attributes_message";
+    static constexpr auto type = 'A';
+
+    using fields = field_list<
+        timestamp_nanoseconds,
+        order_number,
+        buy_sell_indicator,
+        quantity,
+        orderbook_id,
+        group,
+        price>;
+
+    using batch = fields::message_batch;
+};
 
-        record.pcap_index.increment();
+// Order Deleted Message
+struct order_deleted_message {
+    static constexpr auto name = "order_deleted_message";
+    static constexpr auto type = 'D';
 
-        *payload = const_cast<u_char*>(packet);
+    using fields = field_list<
+        timestamp_nanoseconds,
+        order_number>;
 
-        // ethernet header
-        *payload += 12;
+    using batch = fields::message_batch;
+};
 
-        while (ntohs(*reinterpret_cast<const u_short*>(*payload)) != ETHERTYPE_IP) {
-            *payload += 4;
-        }
-        *payload += 2;
+// Order Executed Message
+struct order_executed_message {
+    static constexpr auto name = "order_executed_message";
+    static constexpr auto type = 'E';
 
-        // internet protocol header
-        auto ipheader = reinterpret_cast<const ip*>(*payload);
-        u_int ip_length = ipheader->ip_hl * 4;
-        *payload += ip_length;
+    using fields = field_list<
+        timestamp_nanoseconds,
+        order_number,
+        executed_quantity,
+        match_number>;
 
-        // found upd
-        if (ipheader->ip_p == IPPROTO_UDP) {
-            auto udp = reinterpret_cast<const udphdr*>(*payload);
-            auto udphdr_length = sizeof(udphdr);
-            *length = ntohs(udp->uh_ulen) - udphdr_length;
-            *payload += udphdr_length;
+    using batch = fields::message_batch;
+};
 
-            return true;
-        }
+// Order Replaced Message
+struct order_replaced_message {
+    static constexpr auto name = "order_replaced_message";
+    static constexpr auto type = 'U';
+
+    using fields = field_list<
+        timestamp_nanoseconds,
+        original_order_number,
+        new_order_number,
+        quantity,
+        price>;
 
-        *length = 0;
-        *payload = nullptr;
+    using batch = fields::message_batch;
+};
+
+// Orderbook Directory Message
+struct orderbook_directory_message {
+    static constexpr auto name = "orderbook_directory_message";
+    static constexpr auto type = 'R';
+
+    using fields = field_list<
+        timestamp_nanoseconds,
+        orderbook_id,
+        orderbook_code,
+        group,
+        round_lot_size,
+        price_tick_size_table_id,
+        price_decimals,
+        upper_price_limit,
+        lower_price_limit>;
+
+    using batch = fields::message_batch;
+};
+
+// Price Tick Size Message
+struct price_tick_size_message {
+    static constexpr auto name = "price_tick_size_message";
+    static constexpr auto type = 'L';
+
+    using fields = field_list<
+        timestamp_nanoseconds,
+        price_tick_size_table_id,
+        price_tick_size,
+        price_start>;
+
+    using batch = fields::message_batch;
+};
 
-        return false;
+// Short Selling Price Restriction State Message
+struct short_selling_price_restriction_state_message {
+    static constexpr auto name = "short_selling_price_restriction_state_message";
+    static constexpr auto type = 'Y';
+
+    using fields = field_list<
+        timestamp_nanoseconds,
+        orderbook_id,
+        group,
+        short_selling_state>;
+
+    using batch = fields::message_batch;
+};
+
+// System Event Message
+struct system_event_message {
+    static constexpr auto name = "system_event_message";
+    static constexpr auto type = 'S';
+
+    using fields = field_list<
+        timestamp_nanoseconds,
+        group,
+        system_event>;
+
+    using batch = fields::message_batch;
+};
+
+// Timestamp Seconds Message
+struct timestamp_seconds_message {
+    static constexpr auto name = "timestamp_seconds_message";
+    static constexpr auto type = 'T';
+
+    using fields = field_list<
+        timestamp_seconds>;
+
+    using batch = fields::message_batch;
+};
+
+// Trading State Message
+struct trading_state_message {
+    static constexpr auto name = "trading_state_message";
+    static constexpr auto type = 'H';
+
+    using fields = field_list<
+        timestamp_nanoseconds,
+        orderbook_id,
+        group,
+        trading_state>;
+
+    using batch = fields::message_batch;
+};
+
+// message type dispatch through tables indexed by the type character
+template <typename... messages>
+struct message_types {
+
+    // bytes of the shortest message in the feed
+    static constexpr std::uint32_t smallest_wire_size = std::min({(message_type::size + messages::fields::size)...});
+
+    // message name by type, null for types outside the feed
+    static const char* name_of(const char type) {
+        const char* name = nullptr;
+        (void)((type == messages::type && (name = messages::name, true)) || ...);
+        return name;
     }
 
-    // process itch packet
-    void process(const pcap_pkthdr* header, const u_char* packet) {
+    // bytes a message of this type needs on the wire, the type included, zero for types outside the feed
+    static std::uint32_t wire_size(const char type) {
+        static constexpr auto table = [] {
+            std::array<std::uint32_t, 256> table{};
+            ((table[static_cast<std::uint8_t>(messages::type)] = message_type::size + messages::fields::size), ...);
+            return table;
+        }();
 
-        std::int32_t length = 0;
-        u_char* current = nullptr;
-        u_char* message = nullptr;
+        return table[static_cast<std::uint8_t>(type)];
+    }
+
+    // clear the fields a message of this type set
+    static void reset(record& record) {
+        static constexpr auto table = [] {
+            std::array<void (*)(jnx::itch::record&), 256> table{};
+            table.fill([](jnx::itch::record&) {});
+            ((table[static_cast<std::uint8_t>(messages::type)] = &messages::fields::reset), ...);
+            return table;
+        }();
 
-        if (try_get_jnx_itch(packet, &current, &length)) {
+        table[static_cast<std::uint8_t>(record.message_type.data)](record);
+    }
 
-            record.pcap_timestamp.set(header);
+    // append a wide row touching only the columns a message of this type can set
+    template <typename batch>
+    static void append(batch& rows, const record& record) {
+        static constexpr auto table = [] {
+            std::array<void (*)(batch&, const jnx::itch::record&), 256> table{};
+            table.fill([](batch& rows, const jnx::itch::record& record) { rows.append_sparse(record, enrichment_fields{}); });
+            ((table[static_cast<std::uint8_t>(messages::type)] = [](batch& rows, const jnx::itch::record& record) {
+                rows.append_sparse(record, typename messages::fields{}, enrichment_fields{});
+            }), ...);
+            return table;
+        }();
 
-            record.session.set(&current);
-            record.message_sequence.set(&current);
-            record.message_index.set(&current);
+        table[static_cast<std::uint8_t>(record.message_type.data)](rows, record);
+    }
+};
 
-            while (record.message_index.increment()) {
+using all_messages = message_types<
+    order_added_with_attributes_message,
+    order_added_without_attributes_message,
+    order_deleted_message,
+    order_executed_message,
+    order_replaced_message,
+    orderbook_directory_message,
+    price_tick_size_message,
+    short_selling_price_restriction_state_message,
+    system_event_message,
+    timestamp_seconds_message,
+    trading_state_message>;
 
-                record.reset();
+using wide_batch = batch_of<decltype(std::declval<const record&>().fields())>::type;
 
-                record.message_length.set(&current, &message);
-                record.message_type.set(&message);
-                record.message_sequence.increment();
+// wide record column batch
+struct record_batch : wide_batch {
 
-                process(&message, record.message_type.data);
+    using wide_batch::wide_batch;
 
-                writer << record;
-            }
-        }
+    void append(const record& record) {
+        all_messages::append(*this, record);
     }
+};
 
-    void process(u_char **message, const char message_type) {
-        switch (message_type) {
-            case 'T':
-                process_timestamp_seconds_message(message);
-                break;
+// column encodings declared by the field types, dictionary columns fall back to plain
+template <typename... fields>
+void prefer_encodings(parquet::WriterProperties::Builder& builder, const std::tuple<const fields&...>*) {
+    ([&] {
+        if constexpr (requires { fields::encoding; }) {
+            if constexpr (fields::encoding == parquet::Encoding::RLE_DICTIONARY) {
+                builder.enable_dictionary(fields::name);
+            } else {
+                builder.disable_dictionary(fields::name);
+                builder.encoding(fields::name, fields::encoding);
+            }
+        }
+    }(), ...);
+}
 
-            case 'S':
-                process_system_event_message(message);
-                break;
+inline void prefer_encodings(parquet::WriterProperties::Builder& builder) {
+    prefer_encodings(builder, static_cast<const decltype(std::declval<const record&>().fields())*>(nullptr));
+}
 
-            case 'L':
-                process_price_tick_size_message(message);
-                break;
+// point lookup columns declared by the field types
+template <typename... fields>
+std::vector<std::string> lookup_columns(const std::tuple<const fields&...>*) {
+    std::vector<std::string> columns;
+    ([&] {
+        if constexpr (requires { fields::lookup; }) {
+            columns.emplace_back(fields::name);
+        }
+    }(), ...);
+    return columns;
+}
 
-            case 'R':
-                process_orderbook_directory_message(message);
-                break;
+inline std::vector<std::string> lookup_columns() {
+    return lookup_columns(static_cast<const decltype(std::declval<const record&>().fields())*>(nullptr));
+}
 
-            case 'H':
-                process_trading_state_message(message);
-                break;
+///////////////////////////////////////////////////////////////////////
+// order book
+///////////////////////////////////////////////////////////////////////
 
-            case 'Y':
-                process_short_selling_price_restriction_state_message(message);
-                break;
+// live order, from add until fully executed or deleted
+struct order {
+    std::uint32_t price = 0;
+    std::uint32_t quantity = 0;
+    std::uint32_t orderbook_id = 0;
+    std::uint8_t buy_sell_indicator = 0;
+    decltype(jnx::itch::group::data) group;
+};
 
-            case 'A':
-                process_order_added_without_attributes_message(message);
-                break;
+// live orders by order number, resolves price, side and orderbook onto executions, deletes and replaces
+struct order_book {
+
+    order_index index;
+    order_pool<order> pool;
+
+    // message types that change or read order state
+    static bool tracks(const char type) {
+        switch (type) {
+            case order_added_with_attributes_message::type:
+            case order_added_without_attributes_message::type:
+            case order_executed_message::type:
+            case order_deleted_message::type:
+            case order_replaced_message::type:
+                return true;
+            default:
+                return false;
+        }
+    }
 
-            case 'F':
-                process_order_added_with_attributes_message(message);
+    void apply(record& record) {
+        switch (record.message_type.data) {
+            case order_added_with_attributes_message::type:
+            case order_added_without_attributes_message::type:
+                add(record);
                 break;
 
-            case 'E':
-                process_order_executed_message(message);
+            case order_executed_message::type:
+                reduce(record, record.executed_quantity.data.value_or(0));
                 break;
 
-            case 'D':
-                process_order_deleted_message(message);
+            case order_deleted_message::type:
+                reduce(record, std::numeric_limits<std::uint32_t>::max());
                 break;
 
-            case 'U':
-                process_order_replaced_message(message);
+            case order_replaced_message::type:
+                replace(record);
                 break;
 
             default:
@@ -1738,169 +1842,190 @@ struct converter {
         }
     }
 
-    void process_order_added_with_attributes_message(u_char **message) {
-        record.timestamp_nanoseconds.set(message);
-        record.order_number.set(message);
-        record.buy_sell_indicator.set(message);
-        record.quantity.set(message);
-        record.orderbook_id.set(message);
-        record.group.set(message);
-        record.price.set(message);
-        record.attribution.set(message);
-        record.order_type.set(message);
-    }
+    void add(record& record) {
+        if (!record.order_number.data) {
+            return;
+        }
 
-    void process_order_added_without_attributes_message(u_char **message) {
-        record.timestamp_nanoseconds.set(message);
-        record.order_number.set(message);
-        record.buy_sell_indicator.set(message);
-        record.quantity.set(message);
-        record.orderbook_id.set(message);
-        record.group.set(message);
-        record.price.set(message);
-    }
+        const auto position = pool.allocate();
+        auto& order = pool[position];
+        order.price = record.price.data.value_or(0);
+        order.quantity = record.quantity.data.value_or(0);
+        order.orderbook_id = record.orderbook_id.data.value_or(0);
+        order.buy_sell_indicator = record.buy_sell_indicator.data.value_or(0);
+        order.group = record.group.data;
+
+        // a reused order number replaces the stale order
+        if (const auto previous = index.insert(*record.order_number.data, position); previous != order_index::empty) {
+            pool.release(previous);
+        }
 
-    void process_order_deleted_message(u_char **message) {
-        record.timestamp_nanoseconds.set(message);
-        record.order_number.set(message);
+        record.remaining_quantity.data = order.quantity;
     }
 
-    void process_order_executed_message(u_char **message) {
-        record.timestamp_nanoseconds.set(message);
-        record.order_number.set(message);
-        record.executed_quantity.set(message);
-        record.match_number.set(message);
-    }
+    void reduce(record& record, const std::uint32_t quantity) {
+        if (!record.order_number.data) {
+            return;
+        }
 
-    void process_order_replaced_message(u_char **message) {
-        record.timestamp_nanoseconds.set(message);
-        record.original_order_number.set(message);
-        record.new_order_number.set(message);
-        record.quantity.set(message);
-        record.price.set(message);
-    }
+        const auto key = *record.order_number.data;
+        const auto position = index.find(key);
+        if (position == order_index::empty) {
+            return;
+        }
 
-    void process_orderbook_directory_message(u_char **message) {
-        record.timestamp_nanoseconds.set(message);
-        record.orderbook_id.set(message);
-        record.orderbook_code.set(message);
-        record.group.set(message);
-        record.round_lot_size.set(message);
-        record.price_tick_size_table_id.set(message);
-        record.price_decimals.set(message);
-        record.upper_price_limit.set(message);
-        record.lower_price_limit.set(message);
-    }
+        auto& order = pool[position];
+        order.quantity -= std::min(order.quantity, quantity);
+        resolve(record, order);
 
-    void process_price_tick_size_message(u_char **message) {
-        record.timestamp_nanoseconds.set(message);
-        record.price_tick_size_table_id.set(message);
-        record.price_tick_size.set(message);
-        record.price_start.set(message);
+        if (order.quantity == 0) {
+            index.erase(key);
+            pool.release(position);
+        }
     }
 
-    void process_short_selling_price_restriction_state_message(u_char **message) {
-        record.timestamp_nanoseconds.set(message);
-        record.orderbook_id.set(message);
-        record.group.set(message);
-        record.short_selling_state.set(message);
-    }
+    // the new order number inherits side and orderbook, price and quantity come from the replace
+    void replace(record& record) {
+        if (!record.original_order_number.data || !record.new_order_number.data) {
+            return;
+        }
 
-    void process_system_event_message(u_char **message) {
-        record.timestamp_nanoseconds.set(message);
-        record.group.set(message);
-        record.system_event.set(message);
-    }
+        const auto position = index.erase(*record.original_order_number.data);
+        if (position == order_index::empty) {
+            return;
+        }
 
-    void process_timestamp_seconds_message(u_char **message) {
-        record.timestamp_seconds.set(message);
-    }
+        auto& order = pool[position];
+        order.price = record.price.data.value_or(order.price);
+        order.quantity = record.quantity.data.value_or(0);
+        resolve(record, order);
 
-    void process_trading_state_message(u_char **message) {
-        record.timestamp_nanoseconds.set(message);
-        record.orderbook_id.set(message);
-        record.group.set(message);
-        record.trading_state.set(message);
+        if (const auto previous = index.insert(*record.new_order_number.data, position); previous != order_index::empty) {
+            pool.release(previous);
+        }
     }
 
-    // required to finish parquet file
-    void close() {
-        writer << parquet::EndRowGroup;
+    static void resolve(record& record, const order& order) {
+        if (!record.price.data) {
+            record.price.data = order.price;
+        }
+        if (!record.buy_sell_indicator.data) {
+            record.buy_sell_indicator.data = order.buy_sell_indicator;
+        }
+        if (!record.orderbook_id.data) {
+            record.orderbook_id.data = order.orderbook_id;
+        }
+        if (!record.group.data) {
+            record.group.data = order.group;
+        }
+        record.remaining_quantity.data = order.quantity;
     }
 };
 
-void write_parquet(const options& options) {
-    // open capture file
-    char buffer[PCAP_ERRBUF_SIZE];
-    const auto pcap = pcap_open_offline(options.pcap_file.c_str(), buffer);
-    if (pcap == nullptr)
-    {
-        throw std::runtime_error("Unable to open file "); // need to add buffer
-    }
+///////////////////////////////////////////////////////////////////////
+// converter interface
+///////////////////////////////////////////////////////////////////////
 
-    converter converter(options);
+// instrument directory and the message that lists an instrument
+using instrument_directory = orderbook_directory;
+using directory_message = orderbook_directory_message;
 
-    // loop through packets
-    pcap_pkthdr* header;
-    const u_char* packet;
+// columns of the --orderbook-id, --from and --to, and order number query filters, time filters the event timestamp the clock builds from the seconds messages
+using instrument_field = orderbook_id;
+using time_field = event_timestamp;
+using order_field = order_number;
 
-    while (true) {
-        switch (pcap_next_ex(pcap, &header, &packet)) {
-        case 1:
-            converter.process(header, packet);
-            break;
-        case 0:
-            // timeout
-        case -1:
-            //     std::cerr << "Error: " << pcap_geterr(p) << std::endl;
-        case -2:
-            // end-of-file
-        default:
-            converter.close();
-            pcap_close(pcap);
-            return;
-        }
+// partition columns of a dataset, in directory order
+inline constexpr std::string_view default_partitioning = "date=/message_type=/orderbook_bucket=";
+
+// command line names of the symbol and instrument filters, and their usage with the time format
+inline constexpr std::string_view symbol_option = "--symbol";
+inline constexpr std::string_view instrument_option = "--orderbook-id";
+inline constexpr std::string_view filter_usage = "[--symbol code] [--orderbook-id id] [--from yyyy-mm-ddThh:mm:ss] [--to yyyy-mm-ddThh:mm:ss]";
+
+// --from and --to, utc nanoseconds since the epoch from yyyy-mm-ddThh:mm:ss[.fraction]
+inline std::uint64_t time_filter(const std::string& text) {
+    std::tm time{};
+    double seconds = 0;
+
+    if (std::sscanf(text.c_str(), "%d-%d-%dT%d:%d:%lf", &time.tm_year, &time.tm_mon, &time.tm_mday, &time.tm_hour, &time.tm_min, &seconds) != 6) {
+        throw std::invalid_argument("Invalid time " + text);
     }
+
+    time.tm_year -= 1900;
+    time.tm_mon -= 1;
+
+    return static_cast<std::uint64_t>(timegm(&time)) * 1'000'000'000ull + static_cast<std::uint64_t>(seconds * 1e9 + 0.5);
 }
 
-void read_parquet(const std::string& parquet_file) {
-    std::shared_ptr<arrow::io::ReadableFile> infile;
+// message types the directory, order book or event clock are built from, order messages only while orders are tracked
+inline bool primes(const char type, const bool orders) {
+    return type == orderbook_directory_message::type || type == timestamp_seconds_message::type || (orders && order_book::tracks(type));
+}
 
-    PARQUET_ASSIGN_OR_THROW(infile, arrow::io::ReadableFile::Open(parquet_file));
+// decode a message through the converter's definition of its type, false for a type outside the feed
+template <typename converter>
+bool dispatch(converter& target, u_char **message, const char message_type) {
+    switch (message_type) {
+        case 'T':
+            target.template process_message<timestamp_seconds_message>(message);
+            break;
 
-    parquet::StreamReader reader{ parquet::ParquetFileReader::Open(infile) };
+        case 'S':
+            target.template process_message<system_event_message>(message);
+            break;
 
-    jnx::itch::record record{};
+        case 'L':
+            target.template process_message<price_tick_size_message>(message);
+            break;
 
-    while (!reader.eof()) {
-        reader >> record;
-        std::cout << record;
-    }
-}
+        case 'R':
+            target.process_directory_message(message);
+            break;
 
-int main(const int argc, char** argv) {
+        case 'H':
+            target.template process_message<trading_state_message>(message);
+            break;
 
-    // parse arguments
-    options options;
+        case 'Y':
+            target.template process_message<short_selling_price_restriction_state_message>(message);
+            break;
 
-    if (argc == 3)
-    {
-        options.pcap_file = argv[1];
-        options.parquet_file = argv[2];
-    }
-    else if (argc == 2)
-    {
-        options.pcap_file = argv[1];
-    }
-    else
-    {
-        std::cout << "usage: " << argv[0] << " pcap_file parquet_file" << std::endl;
-        return -1;
+        case 'A':
+            target.template process_message<order_added_without_attributes_message>(message);
+            break;
+
+        case 'F':
+            target.template process_message<order_added_with_attributes_message>(message);
+            break;
+
+        case 'E':
+            target.template process_message<order_executed_message>(message);
+            break;
+
+        case 'D':
+            target.template process_message<order_deleted_message>(message);
+            break;
+
+        case 'U':
+            target.template process_message<order_replaced_message>(message);
+            break;
+
+        default:
+            return false;
     }
 
-    write_parquet(options);
+    return true;
+}
+}
+
+// the feed the shared converter is built for
+namespace feed = jnx::itch;
 
-    read_parquet(options.parquet_file);
+#include "itch_converter.h"
 
-    return 0;
-}
\ No newline at end of file
+#ifndef OMI_BENCHMARK
+int main(const int argc, char** argv) {
+    return run(argc, argv);
+}
+#endif
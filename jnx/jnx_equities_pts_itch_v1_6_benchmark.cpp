@@ -0,0 +1,613 @@
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <new>
+#include <random>
+
+// the converter is benchmarked as built, only its command line is left out
+#define OMI_BENCHMARK
+#include "jnx_equities_pts_itch_v1_6.cpp"
+
+///////////////////////////////////////////////////////////////////////
+// allocation counting
+///////////////////////////////////////////////////////////////////////
+
+// heap allocations through the global operator new, arrow buffers are counted by its memory pool
+inline std::atomic<std::uint64_t> allocations{0};
+
+void* operator new(const std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (auto pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+namespace benchmark {
+
+inline std::uint64_t allocated() {
+    return allocations.load(std::memory_order_relaxed) + static_cast<std::uint64_t>(arrow::default_memory_pool()->num_allocations());
+}
+
+// keeps a result the optimizer would otherwise drop
+template <typename value>
+void keep(const value& result) {
+    asm volatile("" : : "g"(&result) : "memory");
+}
+
+///////////////////////////////////////////////////////////////////////
+// synthetic pts session
+///////////////////////////////////////////////////////////////////////
+
+// deterministic itch messages in moldudp64 packets, the mix follows a regular trading day: mostly adds, deletes and replaces of resting orders with a seconds message per second
+struct generator {
+
+    static constexpr std::uint16_t orderbooks = 512;
+    static constexpr std::size_t resting_limit = 1 << 16;
+    static constexpr std::size_t payload_limit = 1400; // moldudp64 bytes per packet
+    static constexpr std::size_t header_size = 14 + 20 + 8; // ethernet, ip and udp
+
+    // message type and weight per thousand
+    static constexpr std::array<std::pair<char, std::uint32_t>, 6> mix{{
+        {'A', 390}, {'F', 10}, {'D', 370}, {'U', 160}, {'E', 60}, {'H', 10}}};
+
+    std::mt19937_64 random;
+    std::vector<u_char> bytes; // message being written
+    std::vector<std::pair<std::uint64_t, std::uint16_t>> resting; // order number and orderbook
+    std::uint64_t next_order = 1;
+    std::uint64_t next_match = 1;
+    std::uint64_t clock = 30'000'000'000'000; // nanoseconds since midnight, 8:20
+    std::uint64_t order = 0; // order number the message refers to
+    std::uint64_t replacement = 0;
+    std::uint16_t orderbook = 1;
+    std::uint64_t second = 0; // of the last seconds message
+    std::uint64_t drop_every = 0; // every nth packet is left out of the capture, zero keeps them all
+
+    explicit generator(const std::uint64_t seed) : random{seed} {}
+
+    std::uint64_t uniform(const std::uint64_t count) {
+        return random() % count;
+    }
+
+    void put(const std::uint64_t value, const std::uint32_t size) {
+        for (auto shift = size; shift > 0; --shift) {
+            bytes.push_back(static_cast<u_char>(value >> ((shift - 1) * 8)));
+        }
+    }
+
+    void letters(const std::uint32_t size) {
+        for (std::uint32_t index = 0; index < size; ++index) {
+            bytes.push_back(static_cast<u_char>('A' + uniform(26)));
+        }
+    }
+
+    // four letter code of an orderbook, space padded
+    void ticker(const std::uint32_t size) {
+        auto value = orderbook;
+        for (std::uint32_t index = 0; index < size; ++index) {
+            bytes.push_back(index < 4 ? static_cast<u_char>('A' + value % 26) : ' ');
+            value /= 26;
+        }
+    }
+
+    // one field, big endian as on the wire
+    template <typename field>
+    void put() {
+        constexpr std::string_view name = field::name;
+
+        if constexpr (name == "timestamp_nanoseconds") {
+            put(clock % 1'000'000'000, field::size);
+        }
+        else if constexpr (name == "timestamp_seconds") {
+            put(clock / 1'000'000'000, field::size);
+        }
+        else if constexpr (name == "orderbook_id") {
+            put(orderbook, field::size);
+        }
+        else if constexpr (name == "order_number" || name == "original_order_number") {
+            put(order, field::size);
+        }
+        else if constexpr (name == "new_order_number") {
+            put(replacement, field::size);
+        }
+        else if constexpr (name == "match_number") {
+            put(next_match++, field::size);
+        }
+        else if constexpr (name == "orderbook_code") {
+            ticker(field::size);
+        }
+        else if constexpr (name == "buy_sell_indicator") {
+            bytes.push_back(uniform(2) == 0 ? 'B' : 'S');
+        }
+        else if constexpr (name == "price") {
+            put(1'000 + uniform(50'000), field::size);
+        }
+        else if constexpr (name == "quantity" || name == "executed_quantity") {
+            put(100 * (1 + uniform(10)), field::size);
+        }
+        else if constexpr (field::size == 1 || field::parquet_type == parquet::Type::BYTE_ARRAY) {
+            letters(field::size);
+        }
+        else {
+            for (std::uint32_t index = 0; index < field::size; ++index) {
+                bytes.push_back(static_cast<u_char>(random()));
+            }
+        }
+    }
+
+    template <typename... fields>
+    void put(const jnx::itch::field_list<fields...>&) {
+        (put<fields>(), ...);
+    }
+
+    template <typename... messages>
+    void put(const char type, const jnx::itch::message_types<messages...>*) {
+        (void)((type == messages::type && (bytes.push_back(static_cast<u_char>(messages::type)), put(typename messages::fields{}), true)) || ...);
+    }
+
+    // resting order for executions, deletes and replaces, removed when the message ends it
+    void refer(const bool ends) {
+        if (resting.empty()) {
+            order = next_order++;
+            orderbook = static_cast<std::uint16_t>(1 + uniform(orderbooks));
+            return;
+        }
+
+        const auto index = uniform(resting.size());
+        order = resting[index].first;
+        orderbook = resting[index].second;
+
+        if (ends) {
+            resting[index] = resting.back();
+            resting.pop_back();
+        }
+    }
+
+    // encode one message of a type
+    void message(const char type) {
+        bytes.clear();
+
+        // seconds messages carry the clock of the message they precede
+        if (type == 'T') {
+            second = clock / 1'000'000'000;
+        } else {
+            clock += 1 + uniform(20'000);
+        }
+
+        switch (type) {
+            case 'A':
+            case 'F':
+                order = next_order++;
+                orderbook = static_cast<std::uint16_t>(1 + uniform(orderbooks));
+                if (resting.size() < resting_limit) {
+                    resting.emplace_back(order, orderbook);
+                }
+                break;
+
+            case 'D':
+                refer(true);
+                break;
+
+            case 'U':
+                refer(true);
+                replacement = next_order++;
+                resting.emplace_back(replacement, orderbook);
+                break;
+
+            case 'E':
+                refer(false);
+                break;
+
+            default:
+                orderbook = static_cast<std::uint16_t>(1 + uniform(orderbooks));
+                break;
+        }
+
+        put(type, static_cast<const jnx::itch::all_messages*>(nullptr));
+    }
+
+    // next message type of the mix
+    char pick() {
+        auto draw = uniform(1000);
+        for (const auto& [type, weight] : mix) {
+            if (draw < weight) {
+                return type;
+            }
+            draw -= weight;
+        }
+        return 'A';
+    }
+
+    // pcap of count messages after a system event and the orderbook directory, returns the capture bytes
+    std::uint64_t capture(const std::string& path, const std::uint64_t count) {
+        std::ofstream out{path, std::ios::binary};
+        if (!out) {
+            throw std::runtime_error("Unable to create file " + path);
+        }
+
+        const auto write = [&](const auto value, const std::size_t size) {
+            out.write(reinterpret_cast<const char*>(&value), static_cast<std::streamsize>(size));
+        };
+
+        // microsecond pcap, ethernet link type
+        write(std::uint32_t{0xa1b2c3d4}, 4);
+        write(std::uint16_t{2}, 2);
+        write(std::uint16_t{4}, 2);
+        write(std::uint64_t{0}, 8);
+        write(std::uint32_t{65535}, 4);
+        write(std::uint32_t{1}, 4);
+
+        std::vector<u_char> payload;
+        std::uint64_t sequence = 1;
+        std::uint64_t written = 0;
+        std::uint64_t bytes_written = 24;
+        std::uint16_t messages = 0;
+        std::uint64_t packets = 0;
+
+        const auto flush = [&] {
+            if (messages == 0) {
+                return;
+            }
+
+            // a lost packet, its sequence numbers are never sent and leave a gap
+            if (drop_every > 0 && ++packets % drop_every == 0) {
+                sequence += messages;
+                messages = 0;
+                payload.clear();
+                return;
+            }
+
+            // moldudp64 header
+            std::array<u_char, 20> mold{'0', '0', '0', '0', '0', '0', '0', '0', '0', '1'};
+            for (std::size_t index = 0; index < 8; ++index) {
+                mold[10 + index] = static_cast<u_char>(sequence >> ((7 - index) * 8));
+            }
+            mold[18] = static_cast<u_char>(messages >> 8);
+            mold[19] = static_cast<u_char>(messages);
+
+            const auto udp_length = static_cast<std::uint16_t>(8 + mold.size() + payload.size());
+            const auto ip_length = static_cast<std::uint16_t>(20 + udp_length);
+            const auto length = static_cast<std::uint32_t>(14 + ip_length);
+
+            std::array<u_char, header_size> header{
+                0x01, 0x00, 0x5e, 0x36, 0x0c, 0x6f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x08, 0x00,
+                0x45, 0x00, static_cast<u_char>(ip_length >> 8), static_cast<u_char>(ip_length), 0x00, 0x00, 0x00, 0x00, 0x40, 0x11, 0x00, 0x00,
+                10, 0, 0, 1, 233, 54, 12, 111,
+                0x67, 0x6d, 0x67, 0x6d, static_cast<u_char>(udp_length >> 8), static_cast<u_char>(udp_length), 0x00, 0x00};
+
+            const auto time = 1'700'000'000'000'000'000 + clock;
+            write(static_cast<std::uint32_t>(time / 1'000'000'000), 4);
+            write(static_cast<std::uint32_t>(time % 1'000'000'000 / 1000), 4);
+            write(length, 4);
+            write(length, 4);
+
+            out.write(reinterpret_cast<const char*>(header.data()), header.size());
+            out.write(reinterpret_cast<const char*>(mold.data()), mold.size());
+            out.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+
+            bytes_written += 16 + length;
+            sequence += messages;
+            messages = 0;
+            payload.clear();
+        };
+
+        // length prefixed message into the packet, up to eight a packet
+        const auto append = [&] {
+            if (payload.size() + 2 + bytes.size() > payload_limit || messages == 8) {
+                flush();
+            }
+
+            payload.push_back(static_cast<u_char>(bytes.size() >> 8));
+            payload.push_back(static_cast<u_char>(bytes.size()));
+            payload.insert(payload.end(), bytes.begin(), bytes.end());
+            messages += 1;
+            written += 1;
+        };
+
+        message('T');
+        append();
+        message('S');
+        append();
+
+        for (std::uint16_t index = 1; index <= orderbooks && written < count; ++index) {
+            bytes.clear();
+            orderbook = index;
+            clock += 1000;
+            put('R', static_cast<const jnx::itch::all_messages*>(nullptr));
+            append();
+        }
+
+        while (written < count) {
+            message(pick());
+
+            // nanosecond timestamps are relative to the last seconds message
+            if (clock / 1'000'000'000 != second) {
+                auto pending = std::move(bytes);
+                message('T');
+                append();
+                bytes = std::move(pending);
+            }
+            append();
+        }
+        flush();
+
+        return bytes_written;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////
+// measurement
+///////////////////////////////////////////////////////////////////////
+
+struct measurement {
+    std::string layer;
+    std::string name;
+    double seconds = 0;
+    std::uint64_t operations = 0;
+    std::uint64_t bytes = 0; // zero when throughput in bytes means nothing
+    std::uint64_t allocations = 0;
+};
+
+inline std::ostream& operator<<(std::ostream& out, const measurement& result) {
+    const auto operations = static_cast<double>(std::max<std::uint64_t>(result.operations, 1));
+
+    out << std::left << std::setw(8) << result.layer << std::setw(62) << result.name << std::right << std::fixed
+        << std::setprecision(2) << std::setw(12) << result.seconds * 1e9 / operations << " ns"
+        << std::setprecision(2) << std::setw(12) << operations / result.seconds / 1e6 << " M/s";
+
+    if (result.bytes > 0) {
+        out << std::setw(12) << static_cast<double>(result.bytes) / result.seconds / 1e6 << " MB/s";
+    } else {
+        out << std::setw(17) << "";
+    }
+
+    return out << std::setprecision(4) << std::setw(12) << static_cast<double>(result.allocations) / operations << " allocs";
+}
+
+template <typename body>
+measurement measure(std::string layer, std::string name, const std::uint64_t operations, const std::uint64_t bytes, body&& run) {
+    const auto before = allocated();
+    const auto start = std::chrono::steady_clock::now();
+
+    run();
+
+    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return measurement{std::move(layer), std::move(name), seconds, operations, bytes, allocated() - before};
+}
+
+///////////////////////////////////////////////////////////////////////
+// layers
+///////////////////////////////////////////////////////////////////////
+
+struct settings {
+    std::uint64_t messages = 2'000'000; // end to end capture
+    std::size_t count = 1 << 16; // values or messages per field, message and encode round
+    std::size_t rounds = 32;
+    std::uint64_t seed = 1;
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "omi-benchmark";
+    bool keep_files = false;
+};
+
+// field set() over encoded values
+template <typename field>
+measurement decode_field(generator& source, const settings& settings) {
+    source.bytes.clear();
+    for (std::size_t index = 0; index < settings.count; ++index) {
+        source.put<field>();
+    }
+
+    field value;
+
+    return measure("field", std::string{field::name} + "::set", settings.count * settings.rounds, source.bytes.size() * settings.rounds, [&] {
+        for (std::size_t round = 0; round < settings.rounds; ++round) {
+            auto current = source.bytes.data();
+            for (std::size_t index = 0; index < settings.count; ++index) {
+                value.set(&current);
+                keep(value.data);
+            }
+        }
+    });
+}
+
+// one process_*_message over encoded messages of its type
+template <typename message>
+measurement decode_message(generator& source, converter& converter, void (::converter::*process)(u_char**), const settings& settings) {
+    std::vector<u_char> messages;
+    std::size_t size = 0;
+
+    for (std::size_t index = 0; index < settings.count; ++index) {
+        source.message(message::type);
+        size = source.bytes.size();
+        messages.insert(messages.end(), source.bytes.begin(), source.bytes.end());
+    }
+
+    return measure("message", std::string{"process_"} + message::name, settings.count * settings.rounds, messages.size() * settings.rounds, [&] {
+        for (std::size_t round = 0; round < settings.rounds; ++round) {
+            for (std::size_t index = 0; index < settings.count; ++index) {
+                auto current = messages.data() + index * size + 1;
+                (converter.*process)(&current);
+                keep(converter.record);
+            }
+        }
+    });
+}
+
+void decode_messages(std::vector<measurement>& results, generator& source, const settings& settings) {
+    options options;
+    options.parquet_file = (settings.directory / "messages.parquet").string();
+
+    converter converter(options);
+
+    results.push_back(decode_message<jnx::itch::order_added_with_attributes_message>(source, converter, &::converter::process_message<jnx::itch::order_added_with_attributes_message>, settings));
+    results.push_back(decode_message<jnx::itch::order_added_without_attributes_message>(source, converter, &::converter::process_message<jnx::itch::order_added_without_attributes_message>, settings));
+    results.push_back(decode_message<jnx::itch::order_deleted_message>(source, converter, &::converter::process_message<jnx::itch::order_deleted_message>, settings));
+    results.push_back(decode_message<jnx::itch::order_executed_message>(source, converter, &::converter::process_message<jnx::itch::order_executed_message>, settings));
+    results.push_back(decode_message<jnx::itch::order_replaced_message>(source, converter, &::converter::process_message<jnx::itch::order_replaced_message>, settings));
+    results.push_back(decode_message<jnx::itch::orderbook_directory_message>(source, converter, &::converter::process_directory_message, settings));
+    results.push_back(decode_message<jnx::itch::price_tick_size_message>(source, converter, &::converter::process_message<jnx::itch::price_tick_size_message>, settings));
+    results.push_back(decode_message<jnx::itch::short_selling_price_restriction_state_message>(source, converter, &::converter::process_message<jnx::itch::short_selling_price_restriction_state_message>, settings));
+    results.push_back(decode_message<jnx::itch::system_event_message>(source, converter, &::converter::process_message<jnx::itch::system_event_message>, settings));
+    results.push_back(decode_message<jnx::itch::timestamp_seconds_message>(source, converter, &::converter::process_message<jnx::itch::timestamp_seconds_message>, settings));
+    results.push_back(decode_message<jnx::itch::trading_state_message>(source, converter, &::converter::process_message<jnx::itch::trading_state_message>, settings));
+
+    converter.close();
+}
+
+// wide rows of the message mix into column batches, then into a parquet row group per profile
+void encode(std::vector<measurement>& results, generator& source, const settings& settings) {
+    options options;
+    options.parquet_file = (settings.directory / "encode.parquet").string();
+
+    std::vector<jnx::itch::record> records;
+    {
+        converter converter(options);
+
+        for (std::size_t index = 0; index < settings.count; ++index) {
+            source.message(source.pick());
+            auto current = source.bytes.data();
+            converter.record.message_type.set(&current);
+            converter.process(&current, converter.record.message_type.data);
+            records.push_back(converter.record);
+            converter.clear();
+        }
+
+        converter.close();
+    }
+
+    jnx::itch::record_batch batch{records.size()};
+
+    results.push_back(measure("encode", "record_batch::append", records.size() * settings.rounds, 0, [&] {
+        for (std::size_t round = 0; round < settings.rounds; ++round) {
+            batch.clear();
+            for (const auto& record : records) {
+                batch.append(record);
+            }
+        }
+        keep(batch);
+    }));
+
+    const auto schema = arrow_schema<jnx::itch::record_batch>();
+
+    results.push_back(measure("encode", "arrow ipc record batch", records.size() * settings.rounds, 0, [&] {
+        for (std::size_t round = 0; round < settings.rounds; ++round) {
+            std::shared_ptr<arrow::Buffer> message;
+            PARQUET_ASSIGN_OR_THROW(message, arrow::ipc::SerializeRecordBatch(*arrow_batch(batch, schema), arrow::ipc::IpcWriteOptions::Defaults()));
+            keep(message);
+        }
+    }));
+
+    for (const auto profile : {"", "fast-lz4", "archive-zstd"}) {
+        options.profile = profile;
+        const auto properties = writer_properties(options);
+
+        results.push_back(measure("encode", std::string{"row group write "} + (*profile ? profile : "default"), records.size() * settings.rounds, 0, [&] {
+            for (std::size_t round = 0; round < settings.rounds; ++round) {
+                auto file = parquet::ParquetFileWriter::Open(open_file(options.parquet_file), jnx::itch::record_batch::schema(), properties);
+                auto group = file->AppendBufferedRowGroup();
+                batch.write(group);
+                group->Close();
+                file->Close();
+            }
+        }));
+    }
+}
+
+// pcap to parquet through write_parquet
+void end_to_end(std::vector<measurement>& results, const settings& settings) {
+    generator source{settings.seed};
+
+    options base;
+    base.pcap_file = (settings.directory / "synthetic.pcap").string();
+    base.parquet_file = (settings.directory / "synthetic.parquet").string();
+
+    const auto bytes = source.capture(base.pcap_file, settings.messages);
+
+    const std::vector<std::pair<std::string, std::function<void(options&)>>> variants{
+        {"libpcap wide", [](options&) {}},
+        {"mmap wide", [](options& options) { options.mmap = true; }},
+        {"mmap wide orders", [](options& options) { options.mmap = true; options.orders = true; }},
+        {"mmap wide encoders", [](options& options) { options.mmap = true; options.encoder_threads = 2; }},
+        {"mmap narrow", [](options& options) { options.mmap = true; options.wide = false; options.narrow = true; }},
+        {"mmap wide archive-zstd", [](options& options) { options.mmap = true; options.profile = "archive-zstd"; }}};
+
+    for (const auto& [name, configure] : variants) {
+        auto options = base;
+        configure(options);
+
+        results.push_back(measure("file", "pcap to parquet " + name, settings.messages, bytes, [&] {
+            write_parquet(options);
+        }));
+    }
+}
+
+}
+
+#ifndef OMI_TEST
+int main(const int argc, char** argv) {
+    benchmark::settings settings;
+
+    for (auto index = 1; index < argc; ++index) {
+        const std::string argument{argv[index]};
+
+        if (argument == "--messages" && index + 1 < argc) {
+            settings.messages = std::stoull(argv[++index]);
+        }
+        else if (argument == "--count" && index + 1 < argc) {
+            settings.count = std::max<std::size_t>(std::stoul(argv[++index]), 1);
+        }
+        else if (argument == "--rounds" && index + 1 < argc) {
+            settings.rounds = std::max<std::size_t>(std::stoul(argv[++index]), 1);
+        }
+        else if (argument == "--seed" && index + 1 < argc) {
+            settings.seed = std::stoull(argv[++index]);
+        }
+        else if (argument == "--directory" && index + 1 < argc) {
+            settings.directory = argv[++index];
+        }
+        else if (argument == "--keep") {
+            settings.keep_files = true;
+        }
+        else {
+            std::cout << "usage: " << argv[0] << " [--messages count] [--count values] [--rounds count] [--seed value] [--directory path] [--keep]" << std::endl;
+            return -1;
+        }
+    }
+
+    std::filesystem::create_directories(settings.directory);
+
+    std::vector<benchmark::measurement> results;
+    benchmark::generator source{settings.seed};
+
+    results.push_back(benchmark::decode_field<jnx::itch::timestamp_nanoseconds>(source, settings));
+    results.push_back(benchmark::decode_field<jnx::itch::timestamp_seconds>(source, settings));
+    results.push_back(benchmark::decode_field<jnx::itch::orderbook_id>(source, settings));
+    results.push_back(benchmark::decode_field<jnx::itch::price>(source, settings));
+    results.push_back(benchmark::decode_field<jnx::itch::quantity>(source, settings));
+    results.push_back(benchmark::decode_field<jnx::itch::order_number>(source, settings));
+    results.push_back(benchmark::decode_field<jnx::itch::buy_sell_indicator>(source, settings));
+
+    benchmark::decode_messages(results, source, settings);
+    benchmark::encode(results, source, settings);
+    benchmark::end_to_end(results, settings);
+
+    for (const auto& result : results) {
+        std::cout << result << std::endl;
+    }
+
+    if (!settings.keep_files) {
+        std::filesystem::remove_all(settings.directory);
+    }
+
+    return 0;
+}
+#endif
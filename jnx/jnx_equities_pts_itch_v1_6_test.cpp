@@ -0,0 +1,132 @@
+#include <cstdlib>
+
+// the benchmark's synthetic session, its command line is left out
+#define OMI_TEST
+#include "jnx_equities_pts_itch_v1_6_benchmark.cpp"
+
+namespace test {
+
+struct settings {
+    std::uint64_t messages = 200'000;
+    std::uint64_t seed = 1;
+    std::uint64_t drop_every = 97; // lost packets, so the gap table has rows
+    std::size_t threads = 4;
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "omi-jnx-test";
+    bool keep_files = false;
+};
+
+// every row of the files in file order as one table
+std::shared_ptr<arrow::Table> read_rows(const std::vector<std::string>& files) {
+    std::shared_ptr<arrow::Schema> schema;
+    std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+
+    for (const auto& file : files) {
+        query_reader reader{file, query{}};
+        schema = reader.schema;
+        reader.scan([&](const std::shared_ptr<arrow::RecordBatch>& batch) { batches.push_back(batch); });
+    }
+
+    std::shared_ptr<arrow::Table> table;
+    PARQUET_ASSIGN_OR_THROW(table, arrow::Table::FromRecordBatches(schema, batches));
+    return table;
+}
+
+// part files of a parallel run in part order, or their sidecar tables when named
+std::vector<std::string> parts(const std::string& parquet_file, const std::string& sidecar = {}) {
+    std::vector<std::string> files;
+
+    for (std::size_t part = 0;; ++part) {
+        auto file = part_file(parquet_file, part);
+        if (!sidecar.empty()) {
+            file = message_file(file, sidecar);
+        }
+        if (!std::filesystem::exists(file)) {
+            return files;
+        }
+        files.push_back(file);
+    }
+}
+
+bool same(const std::string& name, const std::shared_ptr<arrow::Table>& serial, const std::shared_ptr<arrow::Table>& parallel) {
+    if (serial->num_rows() == 0) {
+        std::cerr << name << ": the serial run wrote no rows" << std::endl;
+        return false;
+    }
+    if (!serial->Equals(*parallel)) {
+        std::cerr << name << ": " << parallel->num_rows() << " parallel rows differ from " << serial->num_rows() << " serial rows" << std::endl;
+        return false;
+    }
+
+    std::cout << name << ": " << serial->num_rows() << " rows match" << std::endl;
+    return true;
+}
+
+// one synthetic capture with lost packets converted serially and in chunks, with live orders tracked across chunk boundaries
+bool chunks_match_serial(const settings& settings) {
+    benchmark::generator source{settings.seed};
+    source.drop_every = settings.drop_every;
+
+    options serial;
+    serial.pcap_file = (settings.directory / "synthetic.pcap").string();
+    serial.parquet_file = (settings.directory / "serial.parquet").string();
+    serial.orders = true;
+
+    source.capture(serial.pcap_file, settings.messages);
+
+    auto parallel = serial;
+    parallel.parquet_file = (settings.directory / "parallel.parquet").string();
+    parallel.threads = settings.threads;
+
+    write_parquet(serial);
+    write_parquet(parallel);
+
+    const auto files = parts(parallel.parquet_file);
+    if (files.size() < 2) {
+        std::cerr << "chunks: the capture split into " << files.size() << " parts" << std::endl;
+        return false;
+    }
+
+    const auto rows = same("rows", read_rows({serial.parquet_file}), read_rows(files));
+    const auto gaps = same("gaps", read_rows({message_file(serial.parquet_file, "gaps")}), read_rows(parts(parallel.parquet_file, "gaps")));
+    return rows && gaps;
+}
+
+}
+
+int main(const int argc, char** argv) {
+    test::settings settings;
+
+    for (auto index = 1; index < argc; ++index) {
+        const std::string argument{argv[index]};
+
+        if (argument == "--messages" && index + 1 < argc) {
+            settings.messages = std::stoull(argv[++index]);
+        }
+        else if (argument == "--seed" && index + 1 < argc) {
+            settings.seed = std::stoull(argv[++index]);
+        }
+        else if (argument == "--threads" && index + 1 < argc) {
+            settings.threads = std::max<std::size_t>(std::stoul(argv[++index]), 2);
+        }
+        else if (argument == "--directory" && index + 1 < argc) {
+            settings.directory = argv[++index];
+        }
+        else if (argument == "--keep") {
+            settings.keep_files = true;
+        }
+        else {
+            std::cout << "usage: " << argv[0] << " [--messages count] [--seed value] [--threads chunks] [--directory path] [--keep]" << std::endl;
+            return -1;
+        }
+    }
+
+    std::filesystem::create_directories(settings.directory);
+
+    const auto passed = test::chunks_match_serial(settings);
+
+    if (!settings.keep_files) {
+        std::filesystem::remove_all(settings.directory);
+    }
+
+    return passed ? 0 : 1;
+}
@@ -1,17 +1,26 @@
+#include <algorithm>
+#include <array>
 #include <chrono>
-#include <cstring>
+#include <cstdio>
 #include <ctime>
+#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "pcap.h"
-#include "netinet/if_ether.h"
-#include "netinet/ip.h"
-#include "netinet/udp.h"
-#include "arrow/io/file.h"
-#include "parquet/exception.h"
-#include "parquet/stream_reader.h"
-#include "parquet/stream_writer.h"
+#include "parquet/file_writer.h"
+#include "parquet/schema.h"
+
+#include "itch_types.h"
 
 namespace nasdaq::itch {
 
@@ -26,6 +35,7 @@ struct pcap_index {
     static constexpr auto repetition = parquet::Repetition::REQUIRED;
     static constexpr auto parquet_type = parquet::Type::INT64;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_64;
+    static constexpr auto encoding = parquet::Encoding::DELTA_BINARY_PACKED;
 
     pcap_index() = default;
 
@@ -48,38 +58,34 @@ inline auto& operator<<(std::ostream& stream, const pcap_index& field) {
     return stream << field.data;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const pcap_index& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, pcap_index& field) {
-    return stream >> field.data;
-}
-
 // pcap timestamp
 struct pcap_timestamp {
 
-    static constexpr auto name = "timestamp";
+    static constexpr auto name = "pcap_timestamp";
     static constexpr auto repetition = parquet::Repetition::REQUIRED;
     static constexpr auto parquet_type = parquet::Type::INT64;
-    static constexpr auto converted_type = parquet::ConvertedType::TIMESTAMP_MICROS;
+    static constexpr auto encoding = parquet::Encoding::DELTA_BINARY_PACKED;
 
     pcap_timestamp() = default;
 
-    void set(const std::chrono::microseconds value) {
+    void set(const std::chrono::nanoseconds value) {
         data = value;
     }
 
+    // captures are opened with nanosecond precision, so tv_usec holds nanoseconds
     void set(const pcap_pkthdr *pkthdr) {
-        const auto duration = std::chrono::seconds{pkthdr->ts.tv_sec} + std::chrono::microseconds{pkthdr->ts.tv_usec};
-        data = duration_cast<std::chrono::microseconds>(duration);
+        data = std::chrono::seconds{pkthdr->ts.tv_sec} + std::chrono::nanoseconds{pkthdr->ts.tv_usec};
+    }
+
+    static auto logical_type() {
+        return parquet::LogicalType::Timestamp(true, parquet::LogicalType::TimeUnit::NANOS);
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, logical_type(), parquet_type);
     }
 
-    std::chrono::microseconds data;
+    std::chrono::nanoseconds data;
 };
 
 inline auto& operator<<(std::ostream& stream, const pcap_timestamp& field) {
@@ -87,18 +93,6 @@ inline auto& operator<<(std::ostream& stream, const pcap_timestamp& field) {
     return stream << std::put_time(std::gmtime(&timestamp), "%Y-%m-%d %X");
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const pcap_timestamp& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, pcap_timestamp& field) {
-    std::chrono::microseconds microseconds;
-    stream >> microseconds;
-    field.set(microseconds);
-
-    return stream;
-}
-
 ///////////////////////////////////////////////////////////////////////
 // itch header types
 ///////////////////////////////////////////////////////////////////////
@@ -115,7 +109,7 @@ struct session {
     session() = default;
 
     void set(u_char** current) {
-        data.assign(reinterpret_cast<char *>(*current), size);
+        data.assign(*current, size);
         *current += size;
     }
 
@@ -123,21 +117,13 @@ struct session {
         return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
-    std::string data;
+    fixed_string<size> data;
 };
 
 inline auto& operator<<(std::ostream& stream, const session& field) {
     return stream << field.data;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const session& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, session& field) {
-    return stream >> field.data;
-}
-
 // message sequence
 struct message_sequence {
 
@@ -145,12 +131,13 @@ struct message_sequence {
     static constexpr auto repetition = parquet::Repetition::REQUIRED;
     static constexpr auto parquet_type = parquet::Type::INT64;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_64;
+    static constexpr auto encoding = parquet::Encoding::DELTA_BINARY_PACKED;
     static constexpr std::uint32_t size = 8;
 
     message_sequence() = default;
 
     void set(u_char** current) {
-        data = htobe64(*reinterpret_cast<std::uint64_t*>(*current));
+        data = load_big_endian<std::uint64_t>(*current);
         *current += size;
     }
 
@@ -169,14 +156,6 @@ inline auto& operator<<(std::ostream& stream, const message_sequence& field) {
     return stream << field.data;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const message_sequence& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, message_sequence& field) {
-    return stream >> field.data;
-}
-
 // message index (count)
 struct message_index {
 
@@ -189,7 +168,7 @@ struct message_index {
     message_index() = default;
 
     void set(u_char** current) {
-        count = htobe16(*reinterpret_cast<uint16_t*>(*current));
+        count = load_big_endian<std::uint16_t>(*current);
         data = 0;
         *current += size;
     }
@@ -211,14 +190,6 @@ inline auto& operator<<(std::ostream& stream, const message_index& field) {
     return stream << field.data;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const message_index& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, message_index& field) {
-    return stream >> field.data;
-}
-
 // message length
 struct message_length {
 
@@ -228,7 +199,7 @@ struct message_length {
     message_length() = default;
 
     void set(u_char** current, u_char** message) {
-        data = htobe16(*reinterpret_cast<std::uint16_t*>(*current));
+        data = load_big_endian<std::uint16_t>(*current);
         *current += size;
         *message = *current;
         *current += data;
@@ -264,17 +235,6 @@ inline auto& operator<<(std::ostream& stream, const message_type& field) {
     return stream << field.data;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const message_type& field) {
-    return stream << static_cast<uint8_t>(field.data);
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, message_type& field) {
-    uint8_t data = 0;
-    stream >> data;
-    field.data = static_cast<char>(data);
-    return stream;
-}
-
 ///////////////////////////////////////////////////////////////////////
 // itch message types
 ///////////////////////////////////////////////////////////////////////
@@ -295,11 +255,7 @@ struct attribution {
     }
 
     void set(u_char** current) {
-        std::uint32_t index = 0;
-        for (; index < size; ++index) {
-            if (*(*current + index) == ' ') { break; }
-        }
-        data = std::string_view(reinterpret_cast<char *>(*current), index);
+        data.emplace(*current);
         *current += size;
     }
 
@@ -307,7 +263,7 @@ struct attribution {
         return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
-    std::optional<std::string> data;
+    std::optional<fixed_string<size>> data;
 };
 
 inline auto& operator<<(std::ostream& stream, const attribution& field) {
@@ -318,27 +274,19 @@ inline auto& operator<<(std::ostream& stream, const attribution& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const attribution& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, attribution& field) {
-    return stream >> field.data;
-}
-
 // Indicates the number of the extensions to the Reopening Auction
 struct auction_collar_extension {
 
     static constexpr auto name = "auction_collar_extension";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
+    static constexpr auto parquet_type = parquet::Type::INT32;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
     static constexpr std::uint32_t size = 4;
 
     auction_collar_extension() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -347,7 +295,7 @@ struct auction_collar_extension {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -361,27 +309,18 @@ inline auto& operator<<(std::ostream& stream, const auction_collar_extension& fi
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const auction_collar_extension& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, auction_collar_extension& field) {
-    return stream >> field.data;
-}
-
 // Reference price used to set the Auction Collars
 struct auction_collar_reference_price {
 
     static constexpr auto name = "auction_collar_reference_price";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
-    static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
+    static constexpr auto parquet_type = parquet::Type::INT64;
     static constexpr std::uint32_t size = 4;
 
     auction_collar_reference_price() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -389,8 +328,12 @@ struct auction_collar_reference_price {
         data.reset();
     }
 
+    static auto logical_type() {
+        return parquet::LogicalType::Decimal(10, 4);
+    }
+
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, logical_type(), parquet_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -404,14 +347,6 @@ inline auto& operator<<(std::ostream& stream, const auction_collar_reference_pri
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const auction_collar_reference_price& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, auction_collar_reference_price& field) {
-    return stream >> field.data;
-}
-
 // Denotes if an issue or quoting participant record is set-up in NASDAQ systems in a live/production, test, or demo state. Please note that firms should only show live issues and quoting participants on public quotation displays.
 struct authenticity {
 
@@ -447,14 +382,6 @@ inline auto& operator<<(std::ostream& stream, const authenticity& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const authenticity& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, authenticity& field) {
-    return stream >> field.data;
-}
-
 // Denotes the MWCB Level that was breached.
 struct breached_level {
 
@@ -490,14 +417,6 @@ inline auto& operator<<(std::ostream& stream, const breached_level& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const breached_level& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, breached_level& field) {
-    return stream >> field.data;
-}
-
 // The type of order being added.
 struct buy_sell_indicator {
 
@@ -533,27 +452,19 @@ inline auto& operator<<(std::ostream& stream, const buy_sell_indicator& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const buy_sell_indicator& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, buy_sell_indicator& field) {
-    return stream >> field.data;
-}
-
 // The number of shares being removed from the display size of the order as the result of a cancellation.
 struct canceled_shares {
 
     static constexpr auto name = "canceled_shares";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
+    static constexpr auto parquet_type = parquet::Type::INT32;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
     static constexpr std::uint32_t size = 4;
 
     canceled_shares() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -562,7 +473,7 @@ struct canceled_shares {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -576,27 +487,18 @@ inline auto& operator<<(std::ostream& stream, const canceled_shares& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const canceled_shares& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, canceled_shares& field) {
-    return stream >> field.data;
-}
-
 // The price at which the cross occurred.  Refer to Data Types for field processing notes.
 struct cross_price {
 
     static constexpr auto name = "cross_price";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
-    static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
+    static constexpr auto parquet_type = parquet::Type::INT64;
     static constexpr std::uint32_t size = 4;
 
     cross_price() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -604,8 +506,12 @@ struct cross_price {
         data.reset();
     }
 
+    static auto logical_type() {
+        return parquet::LogicalType::Decimal(10, 4);
+    }
+
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, logical_type(), parquet_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -619,27 +525,19 @@ inline auto& operator<<(std::ostream& stream, const cross_price& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const cross_price& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, cross_price& field) {
-    return stream >> field.data;
-}
-
 // The number of shares matched in the
 struct cross_shares {
 
     static constexpr auto name = "cross_shares";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT64;
+    static constexpr auto parquet_type = parquet::Type::INT64;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_64;
     static constexpr std::uint32_t size = 8;
 
     cross_shares() = default;
 
     void set(u_char** current) {
-        data = htobe64(*reinterpret_cast<std::uint64_t*>(*current));
+        data = load_big_endian<std::uint64_t>(*current);
         *current += size;
     }
 
@@ -648,7 +546,7 @@ struct cross_shares {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint64_t> data;
@@ -662,14 +560,6 @@ inline auto& operator<<(std::ostream& stream, const cross_shares& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const cross_shares& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, cross_shares& field) {
-    return stream >> field.data;
-}
-
 // The NASDAQ cross session for which the message is being generated.
 struct cross_type {
 
@@ -705,27 +595,18 @@ inline auto& operator<<(std::ostream& stream, const cross_type& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const cross_type& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, cross_type& field) {
-    return stream >> field.data;
-}
-
 // The price at which the NOII shares are being calculated.   Refer to Data Types for field processing notes.
 struct current_reference_price {
 
     static constexpr auto name = "current_reference_price";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
-    static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
+    static constexpr auto parquet_type = parquet::Type::INT64;
     static constexpr std::uint32_t size = 4;
 
     current_reference_price() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -733,8 +614,12 @@ struct current_reference_price {
         data.reset();
     }
 
+    static auto logical_type() {
+        return parquet::LogicalType::Decimal(10, 4);
+    }
+
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, logical_type(), parquet_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -748,14 +633,6 @@ inline auto& operator<<(std::ostream& stream, const current_reference_price& fie
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const current_reference_price& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, current_reference_price& field) {
-    return stream >> field.data;
-}
-
 // Indicates whether the security is an exchange traded product (ETP):
 struct etp_flag {
 
@@ -791,27 +668,19 @@ inline auto& operator<<(std::ostream& stream, const etp_flag& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const etp_flag& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, etp_flag& field) {
-    return stream >> field.data;
-}
-
 // Tracks the integral relationship of the ETP to the underlying index.   Example: If the underlying Index increases by a value of 1 and the ETP’s Leverage factor is 3, indicates the ETF will increase/decrease (see Inverse) by 3. Note: Leverage Factor of 1 indicates the ETP is NOT leveraged. This field is used for LULD Tier I price band calculation purposes.
 struct etp_leverage_factor {
 
     static constexpr auto name = "etp_leverage_factor";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
+    static constexpr auto parquet_type = parquet::Type::INT32;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
     static constexpr std::uint32_t size = 4;
 
     etp_leverage_factor() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -820,7 +689,7 @@ struct etp_leverage_factor {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -834,14 +703,6 @@ inline auto& operator<<(std::ostream& stream, const etp_leverage_factor& field)
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const etp_leverage_factor& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, etp_leverage_factor& field) {
-    return stream >> field.data;
-}
-
 // System Event Codes
 struct event_code {
 
@@ -877,27 +738,19 @@ inline auto& operator<<(std::ostream& stream, const event_code& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const event_code& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, event_code& field) {
-    return stream >> field.data;
-}
-
 // The number of shares executed.
 struct executed_shares {
 
     static constexpr auto name = "executed_shares";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
+    static constexpr auto parquet_type = parquet::Type::INT32;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
     static constexpr std::uint32_t size = 4;
 
     executed_shares() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -906,7 +759,7 @@ struct executed_shares {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -920,27 +773,18 @@ inline auto& operator<<(std::ostream& stream, const executed_shares& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const executed_shares& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, executed_shares& field) {
-    return stream >> field.data;
-}
-
 // The price at which the order execution occurred. Refer to Data Types for field processing notes.
 struct execution_price {
 
     static constexpr auto name = "execution_price";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
-    static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
+    static constexpr auto parquet_type = parquet::Type::INT64;
     static constexpr std::uint32_t size = 4;
 
     execution_price() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -948,8 +792,12 @@ struct execution_price {
         data.reset();
     }
 
+    static auto logical_type() {
+        return parquet::LogicalType::Decimal(10, 4);
+    }
+
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, logical_type(), parquet_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -963,27 +811,18 @@ inline auto& operator<<(std::ostream& stream, const execution_price& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const execution_price& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, execution_price& field) {
-    return stream >> field.data;
-}
-
 // A hypothetical auction-clearing price for cross orders only. Refer to Data Types for field processing notes.
 struct far_price {
 
     static constexpr auto name = "far_price";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
-    static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
+    static constexpr auto parquet_type = parquet::Type::INT64;
     static constexpr std::uint32_t size = 4;
 
     far_price() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -991,8 +830,12 @@ struct far_price {
         data.reset();
     }
 
+    static auto logical_type() {
+        return parquet::LogicalType::Decimal(10, 4);
+    }
+
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, logical_type(), parquet_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -1006,14 +849,6 @@ inline auto& operator<<(std::ostream& stream, const far_price& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const far_price& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, far_price& field) {
-    return stream >> field.data;
-}
-
 // For NASDAQ-listed issues, this field indicates when a firm is not in compliance with NASDAQ continued listing requirements.
 struct financial_status_indicator {
 
@@ -1049,14 +884,6 @@ inline auto& operator<<(std::ostream& stream, const financial_status_indicator&
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const financial_status_indicator& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, financial_status_indicator& field) {
-    return stream >> field.data;
-}
-
 // The market side of the order imbalance.
 struct imbalance_direction {
 
@@ -1092,27 +919,19 @@ inline auto& operator<<(std::ostream& stream, const imbalance_direction& field)
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const imbalance_direction& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, imbalance_direction& field) {
-    return stream >> field.data;
-}
-
 // The number of shares not paired at the Current Reference Price.
 struct imbalance_shares {
 
     static constexpr auto name = "imbalance_shares";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT64;
+    static constexpr auto parquet_type = parquet::Type::INT64;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_64;
     static constexpr std::uint32_t size = 8;
 
     imbalance_shares() = default;
 
     void set(u_char** current) {
-        data = htobe64(*reinterpret_cast<std::uint64_t*>(*current));
+        data = load_big_endian<std::uint64_t>(*current);
         *current += size;
     }
 
@@ -1121,7 +940,7 @@ struct imbalance_shares {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint64_t> data;
@@ -1135,14 +954,6 @@ inline auto& operator<<(std::ostream& stream, const imbalance_shares& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const imbalance_shares& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, imbalance_shares& field) {
-    return stream >> field.data;
-}
-
 // Interest Flag
 struct interest_flag {
 
@@ -1178,14 +989,6 @@ inline auto& operator<<(std::ostream& stream, const interest_flag& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const interest_flag& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, interest_flag& field) {
-    return stream >> field.data;
-}
-
 // Indicates the directional relationship between the ETP and underlying index. Example: An ETP Leverage Factor of 3 and an Inverse value of ‘Y’ indicates the ETP will decrease by a value of 3.
 struct inverse_indicator {
 
@@ -1221,14 +1024,6 @@ inline auto& operator<<(std::ostream& stream, const inverse_indicator& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const inverse_indicator& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, inverse_indicator& field) {
-    return stream >> field.data;
-}
-
 // Indicates if the NASDAQ security is set up for IPO release.   This field is intended to help NASDAQ market participant firms comply with FINRA Rule 5131(b).
 struct ipo_flag {
 
@@ -1264,27 +1059,18 @@ inline auto& operator<<(std::ostream& stream, const ipo_flag& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const ipo_flag& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, ipo_flag& field) {
-    return stream >> field.data;
-}
-
 // Denotes the IPO price to be used for intraday net change calculations. Prices are given in decimal format with 6 whole number places followed by 4 decimal digits.
 struct ipo_price {
 
     static constexpr auto name = "ipo_price";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
-    static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
+    static constexpr auto parquet_type = parquet::Type::INT64;
     static constexpr std::uint32_t size = 4;
 
     ipo_price() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -1292,8 +1078,12 @@ struct ipo_price {
         data.reset();
     }
 
+    static auto logical_type() {
+        return parquet::LogicalType::Decimal(10, 4);
+    }
+
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, logical_type(), parquet_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -1307,14 +1097,6 @@ inline auto& operator<<(std::ostream& stream, const ipo_price& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const ipo_price& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, ipo_price& field) {
-    return stream >> field.data;
-}
-
 // Anticipated quotation release time. This value would be used when NASDAQ Market Operations initially enters the IPO instrument for release.IPO release canceled/postponed.This value would be used when NASDAQ Market Operations cancels or postpones the release of the IPO instrument.
 struct ipo_quotation_release_qualifier {
 
@@ -1350,27 +1132,19 @@ inline auto& operator<<(std::ostream& stream, const ipo_quotation_release_qualif
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const ipo_quotation_release_qualifier& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, ipo_quotation_release_qualifier& field) {
-    return stream >> field.data;
-}
-
 // Denotes the IPO release time, in seconds since midnight, for quotation to the nearest second.
 struct ipo_quotation_release_time {
 
     static constexpr auto name = "ipo_quotation_release_time";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
+    static constexpr auto parquet_type = parquet::Type::INT32;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
     static constexpr std::uint32_t size = 4;
 
     ipo_quotation_release_time() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -1379,7 +1153,7 @@ struct ipo_quotation_release_time {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -1393,14 +1167,6 @@ inline auto& operator<<(std::ostream& stream, const ipo_quotation_release_time&
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const ipo_quotation_release_time& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, ipo_quotation_release_time& field) {
-    return stream >> field.data;
-}
-
 // Identifies the security class for the issue as assigned by NASDAQ. See Appendix for allowable values.
 struct issue_classification {
 
@@ -1436,14 +1202,6 @@ inline auto& operator<<(std::ostream& stream, const issue_classification& field)
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const issue_classification& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, issue_classification& field) {
-    return stream >> field.data;
-}
-
 // Identifies the security sub-type for the issue as assigned by NASDAQ. See Appendix for allowable values.
 struct issue_sub_type {
 
@@ -1460,11 +1218,7 @@ struct issue_sub_type {
     }
 
     void set(u_char** current) {
-        std::uint32_t index = 0;
-        for (; index < size; ++index) {
-            if (*(*current + index) == ' ') { break; }
-        }
-        data = std::string_view(reinterpret_cast<char *>(*current), index);
+        data.emplace(*current);
         *current += size;
     }
 
@@ -1472,7 +1226,7 @@ struct issue_sub_type {
         return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
-    std::optional<std::string> data;
+    std::optional<fixed_string<size>> data;
 };
 
 inline auto& operator<<(std::ostream& stream, const issue_sub_type& field) {
@@ -1483,27 +1237,18 @@ inline auto& operator<<(std::ostream& stream, const issue_sub_type& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const issue_sub_type& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, issue_sub_type& field) {
-    return stream >> field.data;
-}
-
 // Denotes the MWCB Level 1 Value.
 struct level_1 {
 
     static constexpr auto name = "level_1";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT64;
-    static constexpr auto converted_type = parquet::ConvertedType::UINT_64;
+    static constexpr auto parquet_type = parquet::Type::INT64;
     static constexpr std::uint32_t size = 8;
 
     level_1() = default;
 
     void set(u_char** current) {
-        data = htobe64(*reinterpret_cast<std::uint64_t*>(*current));
+        data = load_big_endian<std::uint64_t>(*current);
         *current += size;
     }
 
@@ -1511,8 +1256,12 @@ struct level_1 {
         data.reset();
     }
 
+    static auto logical_type() {
+        return parquet::LogicalType::Decimal(18, 8);
+    }
+
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, logical_type(), parquet_type);
     }
 
     std::optional<std::uint64_t> data;
@@ -1526,27 +1275,18 @@ inline auto& operator<<(std::ostream& stream, const level_1& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const level_1& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, level_1& field) {
-    return stream >> field.data;
-}
-
 // Denotes the MWCB Level 2 Value.
 struct level_2 {
 
     static constexpr auto name = "level_2";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT64;
-    static constexpr auto converted_type = parquet::ConvertedType::UINT_64;
+    static constexpr auto parquet_type = parquet::Type::INT64;
     static constexpr std::uint32_t size = 8;
 
     level_2() = default;
 
     void set(u_char** current) {
-        data = htobe64(*reinterpret_cast<std::uint64_t*>(*current));
+        data = load_big_endian<std::uint64_t>(*current);
         *current += size;
     }
 
@@ -1554,8 +1294,12 @@ struct level_2 {
         data.reset();
     }
 
+    static auto logical_type() {
+        return parquet::LogicalType::Decimal(18, 8);
+    }
+
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, logical_type(), parquet_type);
     }
 
     std::optional<std::uint64_t> data;
@@ -1569,27 +1313,18 @@ inline auto& operator<<(std::ostream& stream, const level_2& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const level_2& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, level_2& field) {
-    return stream >> field.data;
-}
-
 // Denotes the MWCB Level 3 Value.
 struct level_3 {
 
     static constexpr auto name = "level_3";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT64;
-    static constexpr auto converted_type = parquet::ConvertedType::UINT_64;
+    static constexpr auto parquet_type = parquet::Type::INT64;
     static constexpr std::uint32_t size = 8;
 
     level_3() = default;
 
     void set(u_char** current) {
-        data = htobe64(*reinterpret_cast<std::uint64_t*>(*current));
+        data = load_big_endian<std::uint64_t>(*current);
         *current += size;
     }
 
@@ -1597,8 +1332,12 @@ struct level_3 {
         data.reset();
     }
 
+    static auto logical_type() {
+        return parquet::LogicalType::Decimal(18, 8);
+    }
+
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, logical_type(), parquet_type);
     }
 
     std::optional<std::uint64_t> data;
@@ -1612,27 +1351,19 @@ inline auto& operator<<(std::ostream& stream, const level_3& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const level_3& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, level_3& field) {
-    return stream >> field.data;
-}
-
 // Locate code identifying the security
 struct locate_code {
 
     static constexpr auto name = "locate_code";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
+    static constexpr auto parquet_type = parquet::Type::INT32;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_16;
     static constexpr std::uint32_t size = 2;
 
     locate_code() = default;
 
     void set(u_char** current) {
-        data = htobe16(*reinterpret_cast<std::uint16_t*>(*current));
+        data = load_big_endian<std::uint16_t>(*current);
         *current += size;
     }
 
@@ -1641,7 +1372,7 @@ struct locate_code {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint16_t> data;
@@ -1655,27 +1386,18 @@ inline auto& operator<<(std::ostream& stream, const locate_code& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const locate_code& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, locate_code& field) {
-    return stream >> field.data;
-}
-
 // Indicates the price of the Lower Auction Collar Threshold
 struct lower_auction_collar_price {
 
     static constexpr auto name = "lower_auction_collar_price";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
-    static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
+    static constexpr auto parquet_type = parquet::Type::INT64;
     static constexpr std::uint32_t size = 4;
 
     lower_auction_collar_price() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -1683,8 +1405,12 @@ struct lower_auction_collar_price {
         data.reset();
     }
 
+    static auto logical_type() {
+        return parquet::LogicalType::Decimal(10, 4);
+    }
+
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, logical_type(), parquet_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -1698,14 +1424,6 @@ inline auto& operator<<(std::ostream& stream, const lower_auction_collar_price&
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const lower_auction_collar_price& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, lower_auction_collar_price& field) {
-    return stream >> field.data;
-}
-
 // Indicates which Limit Up / Limit Down price band calculation parameter is to be used for the instrument.
 struct luld_reference_price_tier {
 
@@ -1741,14 +1459,6 @@ inline auto& operator<<(std::ostream& stream, const luld_reference_price_tier& f
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const luld_reference_price_tier& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, luld_reference_price_tier& field) {
-    return stream >> field.data;
-}
-
 // Indicates Listing market or listing market tier for the issue
 struct market_category {
 
@@ -1784,14 +1494,6 @@ inline auto& operator<<(std::ostream& stream, const market_category& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const market_category& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, market_category& field) {
-    return stream >> field.data;
-}
-
 // Indicates the quoting participant’s registration status in relation to SEC Rules 101 and 104 of Regulation M
 struct market_maker_mode {
 
@@ -1827,14 +1529,6 @@ inline auto& operator<<(std::ostream& stream, const market_maker_mode& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const market_maker_mode& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, market_maker_mode& field) {
-    return stream >> field.data;
-}
-
 // Indicates the market participant’s current registration status in the issue
 struct market_participant_state {
 
@@ -1870,27 +1564,21 @@ inline auto& operator<<(std::ostream& stream, const market_participant_state& fi
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const market_participant_state& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, market_participant_state& field) {
-    return stream >> field.data;
-}
-
 // The NASDAQ generated day-unique Match Number of this execution. The match number is also referenced in the Trade Break Message.
 struct match_number {
 
     static constexpr auto name = "match_number";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT64;
+    static constexpr auto parquet_type = parquet::Type::INT64;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_64;
+    static constexpr auto encoding = parquet::Encoding::DELTA_BINARY_PACKED;
+    static constexpr bool lookup = true; // point lookups, bloom filtered
     static constexpr std::uint32_t size = 8;
 
     match_number() = default;
 
     void set(u_char** current) {
-        data = htobe64(*reinterpret_cast<std::uint64_t*>(*current));
+        data = load_big_endian<std::uint64_t>(*current);
         *current += size;
     }
 
@@ -1899,7 +1587,7 @@ struct match_number {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint64_t> data;
@@ -1913,14 +1601,6 @@ inline auto& operator<<(std::ostream& stream, const match_number& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const match_number& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, match_number& field) {
-    return stream >> field.data;
-}
-
 // Denotes the market participant identifier for which the position message is being generated
 struct mpid {
 
@@ -1937,11 +1617,7 @@ struct mpid {
     }
 
     void set(u_char** current) {
-        std::uint32_t index = 0;
-        for (; index < size; ++index) {
-            if (*(*current + index) == ' ') { break; }
-        }
-        data = std::string_view(reinterpret_cast<char *>(*current), index);
+        data.emplace(*current);
         *current += size;
     }
 
@@ -1949,7 +1625,7 @@ struct mpid {
         return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
-    std::optional<std::string> data;
+    std::optional<fixed_string<size>> data;
 };
 
 inline auto& operator<<(std::ostream& stream, const mpid& field) {
@@ -1960,27 +1636,18 @@ inline auto& operator<<(std::ostream& stream, const mpid& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const mpid& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, mpid& field) {
-    return stream >> field.data;
-}
-
 // A hypothetical auction-clearing price for cross orders as well as continuous orders. Refer to Data Types for field processing notes.
 struct near_price {
 
     static constexpr auto name = "near_price";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
-    static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
+    static constexpr auto parquet_type = parquet::Type::INT64;
     static constexpr std::uint32_t size = 4;
 
     near_price() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -1988,8 +1655,12 @@ struct near_price {
         data.reset();
     }
 
+    static auto logical_type() {
+        return parquet::LogicalType::Decimal(10, 4);
+    }
+
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, logical_type(), parquet_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -2003,27 +1674,21 @@ inline auto& operator<<(std::ostream& stream, const near_price& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const near_price& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, near_price& field) {
-    return stream >> field.data;
-}
-
 // The new reference number for this order at time of replacement. Please note that the NASDAQ system will use this new order reference number for all subsequent updates.
 struct new_order_reference_number {
 
     static constexpr auto name = "new_order_reference_number";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT64;
+    static constexpr auto parquet_type = parquet::Type::INT64;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_64;
+    static constexpr auto encoding = parquet::Encoding::DELTA_BINARY_PACKED;
+    static constexpr bool lookup = true; // point lookups, bloom filtered
     static constexpr std::uint32_t size = 8;
 
     new_order_reference_number() = default;
 
     void set(u_char** current) {
-        data = htobe64(*reinterpret_cast<std::uint64_t*>(*current));
+        data = load_big_endian<std::uint64_t>(*current);
         *current += size;
     }
 
@@ -2032,7 +1697,7 @@ struct new_order_reference_number {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint64_t> data;
@@ -2046,27 +1711,21 @@ inline auto& operator<<(std::ostream& stream, const new_order_reference_number&
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const new_order_reference_number& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, new_order_reference_number& field) {
-    return stream >> field.data;
-}
-
 // The unique reference number assigned to the new order at the time of receipt.
 struct order_reference_number {
 
     static constexpr auto name = "order_reference_number";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT64;
+    static constexpr auto parquet_type = parquet::Type::INT64;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_64;
+    static constexpr auto encoding = parquet::Encoding::DELTA_BINARY_PACKED;
+    static constexpr bool lookup = true; // point lookups, bloom filtered
     static constexpr std::uint32_t size = 8;
 
     order_reference_number() = default;
 
     void set(u_char** current) {
-        data = htobe64(*reinterpret_cast<std::uint64_t*>(*current));
+        data = load_big_endian<std::uint64_t>(*current);
         *current += size;
     }
 
@@ -2075,7 +1734,7 @@ struct order_reference_number {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint64_t> data;
@@ -2089,27 +1748,21 @@ inline auto& operator<<(std::ostream& stream, const order_reference_number& fiel
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const order_reference_number& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, order_reference_number& field) {
-    return stream >> field.data;
-}
-
 // The original reference number of the order being replaced.
 struct original_order_reference_number {
 
     static constexpr auto name = "original_order_reference_number";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT64;
+    static constexpr auto parquet_type = parquet::Type::INT64;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_64;
+    static constexpr auto encoding = parquet::Encoding::DELTA_BINARY_PACKED;
+    static constexpr bool lookup = true; // point lookups, bloom filtered
     static constexpr std::uint32_t size = 8;
 
     original_order_reference_number() = default;
 
     void set(u_char** current) {
-        data = htobe64(*reinterpret_cast<std::uint64_t*>(*current));
+        data = load_big_endian<std::uint64_t>(*current);
         *current += size;
     }
 
@@ -2118,7 +1771,7 @@ struct original_order_reference_number {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint64_t> data;
@@ -2132,27 +1785,19 @@ inline auto& operator<<(std::ostream& stream, const original_order_reference_num
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const original_order_reference_number& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, original_order_reference_number& field) {
-    return stream >> field.data;
-}
-
 // The total number of shares that are eligible to be matched at the Current Reference Price.
 struct paired_shares {
 
     static constexpr auto name = "paired_shares";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT64;
+    static constexpr auto parquet_type = parquet::Type::INT64;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_64;
     static constexpr std::uint32_t size = 8;
 
     paired_shares() = default;
 
     void set(u_char** current) {
-        data = htobe64(*reinterpret_cast<std::uint64_t*>(*current));
+        data = load_big_endian<std::uint64_t>(*current);
         *current += size;
     }
 
@@ -2161,7 +1806,7 @@ struct paired_shares {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint64_t> data;
@@ -2175,27 +1820,19 @@ inline auto& operator<<(std::ostream& stream, const paired_shares& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const paired_shares& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, paired_shares& field) {
-    return stream >> field.data;
-}
-
 // The display price of the new order.  Refer to Data Types for field processing notes.
 struct price {
 
     static constexpr auto name = "price";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
-    static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
+    static constexpr auto parquet_type = parquet::Type::INT64;
+    static constexpr auto encoding = parquet::Encoding::RLE_DICTIONARY;
     static constexpr std::uint32_t size = 4;
 
     price() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -2203,8 +1840,12 @@ struct price {
         data.reset();
     }
 
+    static auto logical_type() {
+        return parquet::LogicalType::Decimal(10, 4);
+    }
+
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, logical_type(), parquet_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -2218,14 +1859,6 @@ inline auto& operator<<(std::ostream& stream, const price& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const price& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, price& field) {
-    return stream >> field.data;
-}
-
 // This field indicates the absolute value of the percentage of deviation of the Near Indicative Clearing Price to the nearest Current Reference Price.
 struct price_variation_indicator {
 
@@ -2261,14 +1894,6 @@ inline auto& operator<<(std::ostream& stream, const price_variation_indicator& f
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const price_variation_indicator& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, price_variation_indicator& field) {
-    return stream >> field.data;
-}
-
 // Indicates if the market participant firm qualifies as a Primary Market Maker in accordance with NASDAQ marketplace rules
 struct primary_market_maker {
 
@@ -2304,14 +1929,6 @@ inline auto& operator<<(std::ostream& stream, const primary_market_maker& field)
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const primary_market_maker& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, primary_market_maker& field) {
-    return stream >> field.data;
-}
-
 // Indicates if the execution should be reflected on time and sale displays and volume calculations.
 struct printable {
 
@@ -2347,14 +1964,6 @@ inline auto& operator<<(std::ostream& stream, const printable& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const printable& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, printable& field) {
-    return stream >> field.data;
-}
-
 // Trading Action reason
 struct reason {
 
@@ -2371,11 +1980,7 @@ struct reason {
     }
 
     void set(u_char** current) {
-        std::uint32_t index = 0;
-        for (; index < size; ++index) {
-            if (*(*current + index) == ' ') { break; }
-        }
-        data = std::string_view(reinterpret_cast<char *>(*current), index);
+        data.emplace(*current);
         *current += size;
     }
 
@@ -2383,7 +1988,7 @@ struct reason {
         return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
-    std::optional<std::string> data;
+    std::optional<fixed_string<size>> data;
 };
 
 inline auto& operator<<(std::ostream& stream, const reason& field) {
@@ -2394,14 +1999,6 @@ inline auto& operator<<(std::ostream& stream, const reason& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const reason& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, reason& field) {
-    return stream >> field.data;
-}
-
 // Denotes the Reg SHO Short Sale Price Test Restriction status for the issue at the time of the message dissemination
 struct reg_sho_action {
 
@@ -2437,14 +2034,6 @@ inline auto& operator<<(std::ostream& stream, const reg_sho_action& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const reg_sho_action& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, reg_sho_action& field) {
-    return stream >> field.data;
-}
-
 // Reserved
 struct reserved {
 
@@ -2480,27 +2069,19 @@ inline auto& operator<<(std::ostream& stream, const reserved& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const reserved& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, reserved& field) {
-    return stream >> field.data;
-}
-
 // Denotes the number of shares that represent a round lot for the issue
 struct round_lot_size {
 
     static constexpr auto name = "round_lot_size";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
+    static constexpr auto parquet_type = parquet::Type::INT32;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
     static constexpr std::uint32_t size = 4;
 
     round_lot_size() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -2509,7 +2090,7 @@ struct round_lot_size {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -2523,14 +2104,6 @@ inline auto& operator<<(std::ostream& stream, const round_lot_size& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const round_lot_size& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, round_lot_size& field) {
-    return stream >> field.data;
-}
-
 // Indicates if NASDAQ system limits order entry for issue
 struct round_lots_only {
 
@@ -2566,27 +2139,20 @@ inline auto& operator<<(std::ostream& stream, const round_lots_only& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const round_lots_only& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, round_lots_only& field) {
-    return stream >> field.data;
-}
-
 // The total number of shares associated with the order being added to the book.
 struct shares {
 
     static constexpr auto name = "shares";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
+    static constexpr auto parquet_type = parquet::Type::INT32;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
+    static constexpr auto encoding = parquet::Encoding::RLE_DICTIONARY;
     static constexpr std::uint32_t size = 4;
 
     shares() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -2595,7 +2161,7 @@ struct shares {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -2609,14 +2175,6 @@ inline auto& operator<<(std::ostream& stream, const shares& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const shares& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, shares& field) {
-    return stream >> field.data;
-}
-
 // Indicates if a security is subject to mandatory close-out of short sales under SEC Rule 203(b)(3).
 struct short_sale_threshold_indicator {
 
@@ -2652,14 +2210,6 @@ inline auto& operator<<(std::ostream& stream, const short_sale_threshold_indicat
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const short_sale_threshold_indicator& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, short_sale_threshold_indicator& field) {
-    return stream >> field.data;
-}
-
 // Denotes the security symbol for the issue in the NASDAQ execution system.
 struct stock {
 
@@ -2676,11 +2226,7 @@ struct stock {
     }
 
     void set(u_char** current) {
-        std::uint32_t index = 0;
-        for (; index < size; ++index) {
-            if (*(*current + index) == ' ') { break; }
-        }
-        data = std::string_view(reinterpret_cast<char *>(*current), index);
+        data.emplace(*current);
         *current += size;
     }
 
@@ -2688,7 +2234,7 @@ struct stock {
         return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
-    std::optional<std::string> data;
+    std::optional<fixed_string<size>> data;
 };
 
 inline auto& operator<<(std::ostream& stream, const stock& field) {
@@ -2699,27 +2245,19 @@ inline auto& operator<<(std::ostream& stream, const stock& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const stock& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, stock& field) {
-    return stream >> field.data;
-}
-
 // Always 0
 struct stock_locate {
 
     static constexpr auto name = "stock_locate";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
+    static constexpr auto parquet_type = parquet::Type::INT32;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_16;
     static constexpr std::uint32_t size = 2;
 
     stock_locate() = default;
 
     void set(u_char** current) {
-        data = htobe16(*reinterpret_cast<std::uint16_t*>(*current));
+        data = load_big_endian<std::uint16_t>(*current);
         *current += size;
     }
 
@@ -2728,7 +2266,7 @@ struct stock_locate {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint16_t> data;
@@ -2742,40 +2280,33 @@ inline auto& operator<<(std::ostream& stream, const stock_locate& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const stock_locate& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, stock_locate& field) {
-    return stream >> field.data;
-}
-
 // Nanoseconds since midnight.
 struct timestamp {
 
     static constexpr auto name = "timestamp";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT64;
-    static constexpr auto converted_type = parquet::ConvertedType::UINT_64;
+    static constexpr auto parquet_type = parquet::Type::INT64;
+    static constexpr auto encoding = parquet::Encoding::DELTA_BINARY_PACKED;
     static constexpr std::uint32_t size = 6;
 
     timestamp() = default;
 
+    // 48 bit big endian, high 16 bits then low 32 bits, no loop and no read past the field
     void set(u_char** current) {
-        std::uint64_t value = 0;
-        for( size_t i = 0; i < size; ++i ) {
-            value = (value << 8) + **current;
-            *current += 1;
-        }
-        data = value;
+        data = std::uint64_t{load_big_endian<std::uint16_t>(*current)} << 32 | load_big_endian<std::uint32_t>(*current + 2);
+        *current += size;
     }
 
     void reset() {
         data.reset();
     }
 
+    static auto logical_type() {
+        return parquet::LogicalType::Time(false, parquet::LogicalType::TimeUnit::NANOS);
+    }
+
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, logical_type(), parquet_type);
     }
 
     std::optional<std::uint64_t> data;
@@ -2789,27 +2320,19 @@ inline auto& operator<<(std::ostream& stream, const timestamp& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const timestamp& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, timestamp& field) {
-    return stream >> field.data;
-}
-
 // NASDAQ OMX internal tracking number
 struct tracking_number {
 
     static constexpr auto name = "tracking_number";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
+    static constexpr auto parquet_type = parquet::Type::INT32;
     static constexpr auto converted_type = parquet::ConvertedType::UINT_16;
     static constexpr std::uint32_t size = 2;
 
     tracking_number() = default;
 
     void set(u_char** current) {
-        data = htobe16(*reinterpret_cast<std::uint16_t*>(*current));
+        data = load_big_endian<std::uint16_t>(*current);
         *current += size;
     }
 
@@ -2818,7 +2341,7 @@ struct tracking_number {
     }
 
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
     }
 
     std::optional<std::uint16_t> data;
@@ -2832,14 +2355,6 @@ inline auto& operator<<(std::ostream& stream, const tracking_number& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const tracking_number& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, tracking_number& field) {
-    return stream >> field.data;
-}
-
 // Indicates the current trading state for the stock.  Allowable values:
 struct trading_state {
 
@@ -2875,27 +2390,18 @@ inline auto& operator<<(std::ostream& stream, const trading_state& field) {
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const trading_state& field) {
-    return stream << field.data;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, trading_state& field) {
-    return stream >> field.data;
-}
-
 // Indicates the price of the Upper Auction Collar Threshold
 struct upper_auction_collar_price {
 
     static constexpr auto name = "upper_auction_collar_price";
     static constexpr auto repetition = parquet::Repetition::OPTIONAL;
-    static constexpr auto type = parquet::Type::INT32;
-    static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
+    static constexpr auto parquet_type = parquet::Type::INT64;
     static constexpr std::uint32_t size = 4;
 
     upper_auction_collar_price() = default;
 
     void set(u_char** current) {
-        data = htobe32(*reinterpret_cast<std::uint32_t*>(*current));
+        data = load_big_endian<std::uint32_t>(*current);
         *current += size;
     }
 
@@ -2903,8 +2409,12 @@ struct upper_auction_collar_price {
         data.reset();
     }
 
+    static auto logical_type() {
+        return parquet::LogicalType::Decimal(10, 4);
+    }
+
     static auto node() {
-        return parquet::schema::PrimitiveNode::Make(name, repetition, type, converted_type);
+        return parquet::schema::PrimitiveNode::Make(name, repetition, logical_type(), parquet_type);
     }
 
     std::optional<std::uint32_t> data;
@@ -2918,12 +2428,110 @@ inline auto& operator<<(std::ostream& stream, const upper_auction_collar_price&
     return stream;
 }
 
-inline auto& operator<<(parquet::StreamWriter& stream, const upper_auction_collar_price& field) {
-    return stream << field.data;
+///////////////////////////////////////////////////////////////////////
+// enrichment types
+///////////////////////////////////////////////////////////////////////
+
+// symbol of the stock locate, from the stock directory
+struct symbol {
+
+    static constexpr auto name = "symbol";
+    static constexpr auto repetition = parquet::Repetition::OPTIONAL;
+    static constexpr auto parquet_type = parquet::Type::BYTE_ARRAY;
+    static constexpr auto converted_type = parquet::ConvertedType::UTF8;
+    static constexpr std::uint32_t size = 8;
+
+    symbol() = default;
+
+    void reset() {
+        data.reset();
+    }
+
+    void set(const std::optional<fixed_string<size>>& value) {
+        data = value;
+    }
+
+    static auto node() {
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
+    }
+
+    std::optional<fixed_string<size>> data;
+};
+
+inline auto& operator<<(std::ostream& stream, const symbol& field) {
+    if (field.data) {
+        return stream << field.data.value();
+    }
+
+    return stream;
+}
+
+// shares left on the order after the message, from the order book
+struct remaining_shares {
+
+    static constexpr auto name = "remaining_shares";
+    static constexpr auto repetition = parquet::Repetition::OPTIONAL;
+    static constexpr auto parquet_type = parquet::Type::INT32;
+    static constexpr auto converted_type = parquet::ConvertedType::UINT_32;
+    static constexpr std::uint32_t size = 4;
+
+    remaining_shares() = default;
+
+    void reset() {
+        data.reset();
+    }
+
+    static auto node() {
+        return parquet::schema::PrimitiveNode::Make(name, repetition, parquet_type, converted_type);
+    }
+
+    std::optional<std::uint32_t> data;
+};
+
+inline auto& operator<<(std::ostream& stream, const remaining_shares& field) {
+    if (field.data) {
+        return stream << field.data.value();
+    }
+
+    return stream;
 }
 
-inline auto& operator>>(parquet::StreamReader& stream, upper_auction_collar_price& field) {
-    return stream >> field.data;
+// exchange event time, utc nanoseconds since the epoch from the itch time of day and the capture date
+struct event_timestamp {
+
+    static constexpr auto name = "event_timestamp";
+    static constexpr auto repetition = parquet::Repetition::OPTIONAL;
+    static constexpr auto parquet_type = parquet::Type::INT64;
+    static constexpr auto encoding = parquet::Encoding::DELTA_BINARY_PACKED;
+    static constexpr std::uint32_t size = 8;
+
+    event_timestamp() = default;
+
+    void reset() {
+        data.reset();
+    }
+
+    void set(const std::chrono::nanoseconds value) {
+        data = value;
+    }
+
+    static auto logical_type() {
+        return parquet::LogicalType::Timestamp(true, parquet::LogicalType::TimeUnit::NANOS);
+    }
+
+    static auto node() {
+        return parquet::schema::PrimitiveNode::Make(name, repetition, logical_type(), parquet_type);
+    }
+
+    std::optional<std::chrono::nanoseconds> data;
+};
+
+inline auto& operator<<(std::ostream& stream, const event_timestamp& field) {
+    if (field.data) {
+        return stream << field.data->count();
+    }
+
+    return stream;
 }
 
 ///////////////////////////////////////////////////////////////////////
@@ -3007,144 +2615,139 @@ struct record {
     nasdaq::itch::trading_state trading_state;
     nasdaq::itch::upper_auction_collar_price upper_auction_collar_price;
 
+    // enrichment fields
+    nasdaq::itch::symbol symbol;
+    nasdaq::itch::remaining_shares remaining_shares;
+    nasdaq::itch::event_timestamp event_timestamp;
+
     record() = default;
 
-    // reset composite message record
-    void reset() {
-        attribution.reset();
-        auction_collar_extension.reset();
-        auction_collar_reference_price.reset();
-        authenticity.reset();
-        breached_level.reset();
-        buy_sell_indicator.reset();
-        canceled_shares.reset();
-        cross_price.reset();
-        cross_shares.reset();
-        cross_type.reset();
-        current_reference_price.reset();
-        etp_flag.reset();
-        etp_leverage_factor.reset();
-        event_code.reset();
-        executed_shares.reset();
-        execution_price.reset();
-        far_price.reset();
-        financial_status_indicator.reset();
-        imbalance_direction.reset();
-        imbalance_shares.reset();
-        interest_flag.reset();
-        inverse_indicator.reset();
-        ipo_flag.reset();
-        ipo_price.reset();
-        ipo_quotation_release_qualifier.reset();
-        ipo_quotation_release_time.reset();
-        issue_classification.reset();
-        issue_sub_type.reset();
-        level_1.reset();
-        level_2.reset();
-        level_3.reset();
-        locate_code.reset();
-        lower_auction_collar_price.reset();
-        luld_reference_price_tier.reset();
-        market_category.reset();
-        market_maker_mode.reset();
-        market_participant_state.reset();
-        match_number.reset();
-        mpid.reset();
-        near_price.reset();
-        new_order_reference_number.reset();
-        order_reference_number.reset();
-        original_order_reference_number.reset();
-        paired_shares.reset();
-        price.reset();
-        price_variation_indicator.reset();
-        primary_market_maker.reset();
-        printable.reset();
-        reason.reset();
-        reg_sho_action.reset();
-        reserved.reset();
-        round_lot_size.reset();
-        round_lots_only.reset();
-        shares.reset();
-        short_sale_threshold_indicator.reset();
-        stock.reset();
-        stock_locate.reset();
-        timestamp.reset();
-        tracking_number.reset();
-        trading_state.reset();
-        upper_auction_collar_price.reset();
+    // pcap and header columns, first in the schema
+    static constexpr std::size_t header_columns = 6;
+
+    // reset composite message record, header fields carry over to the next message of the packet
+    void reset() {
+        for_each_field<header_columns>([](auto& field) { field.reset(); });
+    }
+
+    // parquet column fields
+    auto fields() const {
+        return std::tie(
+            pcap_index,
+            pcap_timestamp,
+            session,
+            message_sequence,
+            message_index,
+            message_type,
+            attribution,
+            auction_collar_extension,
+            auction_collar_reference_price,
+            authenticity,
+            breached_level,
+            buy_sell_indicator,
+            canceled_shares,
+            cross_price,
+            cross_shares,
+            cross_type,
+            current_reference_price,
+            etp_flag,
+            etp_leverage_factor,
+            event_code,
+            executed_shares,
+            execution_price,
+            far_price,
+            financial_status_indicator,
+            imbalance_direction,
+            imbalance_shares,
+            interest_flag,
+            inverse_indicator,
+            ipo_flag,
+            ipo_price,
+            ipo_quotation_release_qualifier,
+            ipo_quotation_release_time,
+            issue_classification,
+            issue_sub_type,
+            level_1,
+            level_2,
+            level_3,
+            locate_code,
+            lower_auction_collar_price,
+            luld_reference_price_tier,
+            market_category,
+            market_maker_mode,
+            market_participant_state,
+            match_number,
+            mpid,
+            near_price,
+            new_order_reference_number,
+            order_reference_number,
+            original_order_reference_number,
+            paired_shares,
+            price,
+            price_variation_indicator,
+            primary_market_maker,
+            printable,
+            reason,
+            reg_sho_action,
+            reserved,
+            round_lot_size,
+            round_lots_only,
+            shares,
+            short_sale_threshold_indicator,
+            stock,
+            stock_locate,
+            timestamp,
+            tracking_number,
+            trading_state,
+            upper_auction_collar_price,
+            symbol,
+            remaining_shares,
+            event_timestamp
+        );
+    }
+
+    // apply to every column field from first on, in schema order
+    template <std::size_t first = 0, typename function>
+    void for_each_field(function&& apply) const {
+        const auto all = fields();
+        [&]<std::size_t... index>(std::index_sequence<index...>) {
+            (apply(std::get<first + index>(all)), ...);
+        }(std::make_index_sequence<std::tuple_size_v<decltype(all)> - first>{});
+    }
+
+    template <std::size_t first = 0, typename function>
+    void for_each_field(function&& apply) {
+        std::as_const(*this).template for_each_field<first>([&](const auto& field) {
+            apply(const_cast<std::remove_cvref_t<decltype(field)>&>(field));
+        });
     }
 
     // parquet schema nodes
     static auto nodes() {
-        return parquet::schema::NodeVector {
-            nasdaq::itch::pcap_index::node(),
-            nasdaq::itch::pcap_timestamp::node(),
-            nasdaq::itch::session::node(),
-            nasdaq::itch::message_sequence::node(),
-            nasdaq::itch::message_index::node(),
-            nasdaq::itch::message_type::node(),
-            nasdaq::itch::attribution::node(),
-            nasdaq::itch::auction_collar_extension::node(),
-            nasdaq::itch::auction_collar_reference_price::node(),
-            nasdaq::itch::authenticity::node(),
-            nasdaq::itch::breached_level::node(),
-            nasdaq::itch::buy_sell_indicator::node(),
-            nasdaq::itch::canceled_shares::node(),
-            nasdaq::itch::cross_price::node(),
-            nasdaq::itch::cross_shares::node(),
-            nasdaq::itch::cross_type::node(),
-            nasdaq::itch::current_reference_price::node(),
-            nasdaq::itch::etp_flag::node(),
-            nasdaq::itch::etp_leverage_factor::node(),
-            nasdaq::itch::event_code::node(),
-            nasdaq::itch::executed_shares::node(),
-            nasdaq::itch::execution_price::node(),
-            nasdaq::itch::far_price::node(),
-            nasdaq::itch::financial_status_indicator::node(),
-            nasdaq::itch::imbalance_direction::node(),
-            nasdaq::itch::imbalance_shares::node(),
-            nasdaq::itch::interest_flag::node(),
-            nasdaq::itch::inverse_indicator::node(),
-            nasdaq::itch::ipo_flag::node(),
-            nasdaq::itch::ipo_price::node(),
-            nasdaq::itch::ipo_quotation_release_qualifier::node(),
-            nasdaq::itch::ipo_quotation_release_time::node(),
-            nasdaq::itch::issue_classification::node(),
-            nasdaq::itch::issue_sub_type::node(),
-            nasdaq::itch::level_1::node(),
-            nasdaq::itch::level_2::node(),
-            nasdaq::itch::level_3::node(),
-            nasdaq::itch::locate_code::node(),
-            nasdaq::itch::lower_auction_collar_price::node(),
-            nasdaq::itch::luld_reference_price_tier::node(),
-            nasdaq::itch::market_category::node(),
-            nasdaq::itch::market_maker_mode::node(),
-            nasdaq::itch::market_participant_state::node(),
-            nasdaq::itch::match_number::node(),
-            nasdaq::itch::mpid::node(),
-            nasdaq::itch::near_price::node(),
-            nasdaq::itch::new_order_reference_number::node(),
-            nasdaq::itch::order_reference_number::node(),
-            nasdaq::itch::original_order_reference_number::node(),
-            nasdaq::itch::paired_shares::node(),
-            nasdaq::itch::price::node(),
-            nasdaq::itch::price_variation_indicator::node(),
-            nasdaq::itch::primary_market_maker::node(),
-            nasdaq::itch::printable::node(),
-            nasdaq::itch::reason::node(),
-            nasdaq::itch::reg_sho_action::node(),
-            nasdaq::itch::reserved::node(),
-            nasdaq::itch::round_lot_size::node(),
-            nasdaq::itch::round_lots_only::node(),
-            nasdaq::itch::shares::node(),
-            nasdaq::itch::short_sale_threshold_indicator::node(),
-            nasdaq::itch::stock::node(),
-            nasdaq::itch::stock_locate::node(),
-            nasdaq::itch::timestamp::node(),
-            nasdaq::itch::tracking_number::node(),
-            nasdaq::itch::trading_state::node(),
-            nasdaq::itch::upper_auction_collar_price::node()
-        };
+        return []<typename... fields>(std::type_identity<std::tuple<fields...>>) {
+            return parquet::schema::NodeVector { std::remove_cvref_t<fields>::node()... };
+        }(std::type_identity<decltype(std::declval<const record&>().fields())>{});
+    }
+
+    // parquet column field by type
+    template <typename field>
+    const auto& get() const {
+        return std::get<const field&>(fields());
+    }
+
+    template <typename field>
+    auto& get() {
+        return const_cast<field&>(std::as_const(*this).template get<field>());
+    }
+
+    // schema column of a field
+    template <typename field>
+    static constexpr int column() {
+        return []<typename... fields>(std::type_identity<std::tuple<fields...>>) {
+            int index = 0;
+            (void)((std::is_same_v<const field&, fields> || (++index, false)) || ...);
+            return index;
+        }(std::type_identity<decltype(std::declval<const record&>().fields())>{});
     }
 
     // parquet schema
@@ -3153,699 +2756,886 @@ struct record {
     }
 };
 
-inline auto& operator<<(parquet::StreamWriter& stream, const record& row) {
-    return stream
-        << row.pcap_index
-        << row.pcap_timestamp
-        << row.session
-        << row.message_sequence
-        << row.message_index
-        << row.message_type
-        << row.attribution
-        << row.auction_collar_extension
-        << row.auction_collar_reference_price
-        << row.authenticity
-        << row.breached_level
-        << row.buy_sell_indicator
-        << row.canceled_shares
-        << row.cross_price
-        << row.cross_shares
-        << row.cross_type
-        << row.current_reference_price
-        << row.etp_flag
-        << row.etp_leverage_factor
-        << row.event_code
-        << row.executed_shares
-        << row.execution_price
-        << row.far_price
-        << row.financial_status_indicator
-        << row.imbalance_direction
-        << row.imbalance_shares
-        << row.interest_flag
-        << row.inverse_indicator
-        << row.ipo_flag
-        << row.ipo_price
-        << row.ipo_quotation_release_qualifier
-        << row.ipo_quotation_release_time
-        << row.issue_classification
-        << row.issue_sub_type
-        << row.level_1
-        << row.level_2
-        << row.level_3
-        << row.locate_code
-        << row.lower_auction_collar_price
-        << row.luld_reference_price_tier
-        << row.market_category
-        << row.market_maker_mode
-        << row.market_participant_state
-        << row.match_number
-        << row.mpid
-        << row.near_price
-        << row.new_order_reference_number
-        << row.order_reference_number
-        << row.original_order_reference_number
-        << row.paired_shares
-        << row.price
-        << row.price_variation_indicator
-        << row.primary_market_maker
-        << row.printable
-        << row.reason
-        << row.reg_sho_action
-        << row.reserved
-        << row.round_lot_size
-        << row.round_lots_only
-        << row.shares
-        << row.short_sale_threshold_indicator
-        << row.stock
-        << row.stock_locate
-        << row.timestamp
-        << row.tracking_number
-        << row.trading_state
-        << row.upper_auction_collar_price
-        << parquet::EndRow;
-}
-
-inline auto& operator>>(parquet::StreamReader& stream, record& row) {
-    return stream
-        >> row.pcap_index
-        >> row.pcap_timestamp
-        >> row.session
-        >> row.message_sequence
-        >> row.message_index
-        >> row.message_type
-        >> row.attribution
-        >> row.auction_collar_extension
-        >> row.auction_collar_reference_price
-        >> row.authenticity
-        >> row.breached_level
-        >> row.buy_sell_indicator
-        >> row.canceled_shares
-        >> row.cross_price
-        >> row.cross_shares
-        >> row.cross_type
-        >> row.current_reference_price
-        >> row.etp_flag
-        >> row.etp_leverage_factor
-        >> row.event_code
-        >> row.executed_shares
-        >> row.execution_price
-        >> row.far_price
-        >> row.financial_status_indicator
-        >> row.imbalance_direction
-        >> row.imbalance_shares
-        >> row.interest_flag
-        >> row.inverse_indicator
-        >> row.ipo_flag
-        >> row.ipo_price
-        >> row.ipo_quotation_release_qualifier
-        >> row.ipo_quotation_release_time
-        >> row.issue_classification
-        >> row.issue_sub_type
-        >> row.level_1
-        >> row.level_2
-        >> row.level_3
-        >> row.locate_code
-        >> row.lower_auction_collar_price
-        >> row.luld_reference_price_tier
-        >> row.market_category
-        >> row.market_maker_mode
-        >> row.market_participant_state
-        >> row.match_number
-        >> row.mpid
-        >> row.near_price
-        >> row.new_order_reference_number
-        >> row.order_reference_number
-        >> row.original_order_reference_number
-        >> row.paired_shares
-        >> row.price
-        >> row.price_variation_indicator
-        >> row.primary_market_maker
-        >> row.printable
-        >> row.reason
-        >> row.reg_sho_action
-        >> row.reserved
-        >> row.round_lot_size
-        >> row.round_lots_only
-        >> row.shares
-        >> row.short_sale_threshold_indicator
-        >> row.stock
-        >> row.stock_locate
-        >> row.timestamp
-        >> row.tracking_number
-        >> row.trading_state
-        >> row.upper_auction_collar_price
-        >> parquet::EndRow;
-}
-
 inline auto& operator<<(std::ostream& stream, const record& row) {
-    return stream
-        << row.pcap_index <<","
-        << row.pcap_timestamp <<","
-        << row.session <<","
-        << row.message_sequence <<","
-        << row.message_index <<","
-        << row.message_type <<","
-        << row.attribution <<","
-        << row.auction_collar_extension <<","
-        << row.auction_collar_reference_price <<","
-        << row.authenticity <<","
-        << row.breached_level <<","
-        << row.buy_sell_indicator <<","
-        << row.canceled_shares <<","
-        << row.cross_price <<","
-        << row.cross_shares <<","
-        << row.cross_type <<","
-        << row.current_reference_price <<","
-        << row.etp_flag <<","
-        << row.etp_leverage_factor <<","
-        << row.event_code <<","
-        << row.executed_shares <<","
-        << row.execution_price <<","
-        << row.far_price <<","
-        << row.financial_status_indicator <<","
-        << row.imbalance_direction <<","
-        << row.imbalance_shares <<","
-        << row.interest_flag <<","
-        << row.inverse_indicator <<","
-        << row.ipo_flag <<","
-        << row.ipo_price <<","
-        << row.ipo_quotation_release_qualifier <<","
-        << row.ipo_quotation_release_time <<","
-        << row.issue_classification <<","
-        << row.issue_sub_type <<","
-        << row.level_1 <<","
-        << row.level_2 <<","
-        << row.level_3 <<","
-        << row.locate_code <<","
-        << row.lower_auction_collar_price <<","
-        << row.luld_reference_price_tier <<","
-        << row.market_category <<","
-        << row.market_maker_mode <<","
-        << row.market_participant_state <<","
-        << row.match_number <<","
-        << row.mpid <<","
-        << row.near_price <<","
-        << row.new_order_reference_number <<","
-        << row.order_reference_number <<","
-        << row.original_order_reference_number <<","
-        << row.paired_shares <<","
-        << row.price <<","
-        << row.price_variation_indicator <<","
-        << row.primary_market_maker <<","
-        << row.printable <<","
-        << row.reason <<","
-        << row.reg_sho_action <<","
-        << row.reserved <<","
-        << row.round_lot_size <<","
-        << row.round_lots_only <<","
-        << row.shares <<","
-        << row.short_sale_threshold_indicator <<","
-        << row.stock <<","
-        << row.stock_locate <<","
-        << row.timestamp <<","
-        << row.tracking_number <<","
-        << row.trading_state <<","
-        << row.upper_auction_collar_price <<","
-        << std::endl;
-}
+    row.for_each_field([&](const auto& field) { stream << field << ","; });
+    return stream << std::endl;
 }
 
 ///////////////////////////////////////////////////////////////////////
-// itch converter
+// stock directory
 ///////////////////////////////////////////////////////////////////////
 
-// parquet options
-struct options {
-    std::string pcap_file = "itch.pcap";
-    std::string parquet_file = "itch.parquet";
-    std::int64_t max_row_group_size = 1000;
-};
+// stock locate to symbol and listing metadata, filled from stock directory messages
+struct stock_directory {
+
+    struct listing {
+        decltype(nasdaq::itch::stock::data) stock;
+        decltype(nasdaq::itch::market_category::data) market_category;
+        decltype(nasdaq::itch::round_lot_size::data) round_lot_size;
+    };
+
+    // every possible locate code, lookups are a direct index
+    stock_directory() : listings(std::size_t{std::numeric_limits<std::uint16_t>::max()} + 1) {}
 
-// itch converter
-struct converter {
+    void add(const record& record) {
+        if (!record.stock_locate.data) {
+            return;
+        }
 
-    nasdaq::itch::record record;
-    parquet::StreamWriter writer;
-    std::shared_ptr<arrow::io::FileOutputStream> outfile;
-    std::shared_ptr<parquet::schema::GroupNode> schema;
-    parquet::WriterProperties::Builder builder;
+        auto& listing = listings[*record.stock_locate.data];
+        listing.stock = record.stock.data;
+        listing.market_category = record.market_category.data;
+        listing.round_lot_size = record.round_lot_size.data;
+    }
 
-    explicit converter(const options& options) : record{} {
-        PARQUET_ASSIGN_OR_THROW(outfile, arrow::io::FileOutputStream::Open(options.parquet_file));
-        schema = nasdaq::itch::record::schema();
-        writer = parquet::StreamWriter{parquet::ParquetFileWriter::Open(outfile, schema, builder.build())};
-        writer.SetMaxRowGroupSize(options.max_row_group_size);
+    void enrich(record& record) const {
+        if (record.stock_locate.data) {
+            record.symbol.set(listings[*record.stock_locate.data].stock);
+        }
     }
 
-    // return udp payload and length by skipping headers in a packet
-    bool try_get_nasdaq_itch(const u_char *packet, u_char **payload, std::int32_t *length) {
+    std::vector<listing> listings;
+};
 
-        record.pcap_index.increment();
+// shard key, rows without an instrument go to the first shard
+inline std::uint64_t instrument(const record& record) {
+    return record.stock_locate.data.value_or(0);
+}
 
-        *payload = const_cast<u_char*>(packet);
+// dataset partition column of the instrument buckets, ie locate_bucket=3
+inline constexpr std::string_view instrument_partition = "locate_bucket";
 
-        // ethernet header
-        *payload += 12;
+///////////////////////////////////////////////////////////////////////
+// event time
+///////////////////////////////////////////////////////////////////////
 
-        while (ntohs(*reinterpret_cast<const u_short*>(*payload)) != ETHERTYPE_IP) {
-            *payload += 4;
-        }
-        *payload += 2;
+// itch time of day to utc, the exchange midnight is found from the capture clock so no time zone database is needed
+struct event_clock {
 
-        // internet protocol header
-        auto ipheader = reinterpret_cast<const ip*>(*payload);
-        u_int ip_length = ipheader->ip_hl * 4;
-        *payload += ip_length;
+    // utc offsets are whole quarter hours
+    using quarter_hours = std::chrono::duration<std::int64_t, std::ratio<900>>;
 
-        // found upd
-        if (ipheader->ip_p == IPPROTO_UDP) {
-            auto udp = reinterpret_cast<const udphdr*>(*payload);
-            auto udphdr_length = sizeof(udphdr);
-            *length = ntohs(udp->uh_ulen) - udphdr_length;
-            *payload += udphdr_length;
+    std::chrono::nanoseconds midnight{0}; // utc time of the exchange midnight, zero until a capture time is seen
 
-            return true;
+    void enrich(record& record) {
+        // raw dumps carry no capture clock
+        if (!record.timestamp.data || record.pcap_timestamp.data.count() == 0) {
+            return;
         }
 
-        *length = 0;
-        *payload = nullptr;
+        const std::chrono::nanoseconds time{*record.timestamp.data};
+        const auto captured = record.pcap_timestamp.data;
 
-        return false;
-    }
-
-    // process itch packet
-    void process(const pcap_pkthdr* header, const u_char* packet) {
+        // kept while the capture clock stays on the same day, so clock jitter never moves it
+        if (midnight.count() == 0 || std::chrono::abs(captured - time - midnight) > std::chrono::hours{1}) {
+            midnight = std::chrono::round<quarter_hours>(captured - time);
+        }
 
-        std::int32_t length = 0;
-        u_char* current = nullptr;
-        u_char* message = nullptr;
+        record.event_timestamp.set(midnight + time);
+    }
+};
 
-        if (try_get_nasdaq_itch(packet, &current, &length)) {
+///////////////////////////////////////////////////////////////////////
+// itch message tables
+///////////////////////////////////////////////////////////////////////
 
-            record.pcap_timestamp.set(header);
+// fields set by one message type
+template <typename... fields>
+struct field_list {
 
-            record.session.set(&current);
-            record.message_sequence.set(&current);
-            record.message_index.set(&current);
+    // bytes the fields take on the wire after the message type
+    static constexpr std::uint32_t size = (fields::size + ... + 0);
 
-            while (record.message_index.increment()) {
+    // narrow message batch, header columns plus the fields, the symbol and the event time
+    using message_batch = batch<
+        column<pcap_index>,
+        column<pcap_timestamp>,
+        column<session>,
+        column<message_sequence>,
+        column<message_index>,
+        column<message_type>,
+        column<fields, parquet::Repetition::REQUIRED>...,
+        column<symbol>,
+        column<event_timestamp>>;
 
-                record.reset();
+    static void reset(record& record) {
+        (record.template get<fields>().reset(), ...);
+    }
 
-                record.message_length.set(&current, &message);
-                record.message_type.set(&message);
-                record.message_sequence.increment();
+    // decode the fields in wire order, unrolled per message type
+    static void decode(record& record, u_char** message) {
+        (record.template get<fields>().set(message), ...);
+    }
+};
+
+// fields set after decoding by the directory and order book
+using enrichment_fields = field_list<event_timestamp, symbol, remaining_shares, price, buy_sell_indicator, stock>;
+
+// Add Order No Mpid Attribution Message
+struct add_order_no_mpid_attribution_message {
+    static constexpr auto name = "add_order_no_mpid_attribution_message";
+    static constexpr auto type = 'A';
 
-                process(&message, record.message_type.data);
+    using fields = field_list<
+        stock_locate,
+        tracking_number,
+        timestamp,
+        order_reference_number,
+        buy_sell_indicator,
+        shares,
+        stock,
+        price>;
+
+    using batch = fields::message_batch;
+};
+
+// Add Order With Mpid Attribution Message
+struct add_order_with_mpid_attribution_message {
+    static constexpr auto name = "add_order_with_mpid_attribution_message";
+    static constexpr auto type = 'F';
+
+    using fields = field_list<
+        stock_locate,
+        tracking_number,
+        timestamp,
+        order_reference_number,
+        buy_sell_indicator,
+        shares,
+        stock,
+        price,
+        attribution>;
+
+    using batch = fields::message_batch;
+};
+
+// Broken Trade Message
+struct broken_trade_message {
+    static constexpr auto name = "broken_trade_message";
+    static constexpr auto type = 'B';
+
+    using fields = field_list<
+        stock_locate,
+        tracking_number,
+        timestamp,
+        match_number>;
+
+    using batch = fields::message_batch;
+};
+
+// Cross Trade Message
+struct cross_trade_message {
+    static constexpr auto name = "cross_trade_message";
+    static constexpr auto type = 'Q';
+
+    using fields = field_list<
+        stock_locate,
+        tracking_number,
+        timestamp,
+        cross_shares,
+        stock,
+        cross_price,
+        match_number,
+        cross_type>;
+
+    using batch = fields::message_batch;
+};
+
+// Ipo Quoting Period Update
+struct ipo_quoting_period_update {
+    static constexpr auto name = "ipo_quoting_period_update";
+    static constexpr auto type = 'K';
+
+    using fields = field_list<
+        stock_locate,
+        tracking_number,
+        timestamp,
+        stock,
+        ipo_quotation_release_time,
+        ipo_quotation_release_qualifier,
+        ipo_price>;
+
+    using batch = fields::message_batch;
+};
+
+// Luld Auction Collar Message
+struct luld_auction_collar_message {
+    static constexpr auto name = "luld_auction_collar_message";
+    static constexpr auto type = 'J';
+
+    using fields = field_list<
+        stock_locate,
+        tracking_number,
+        timestamp,
+        stock,
+        auction_collar_reference_price,
+        upper_auction_collar_price,
+        lower_auction_collar_price,
+        auction_collar_extension>;
+
+    using batch = fields::message_batch;
+};
+
+// Market Participant Position Message
+struct market_participant_position_message {
+    static constexpr auto name = "market_participant_position_message";
+    static constexpr auto type = 'L';
+
+    using fields = field_list<
+        stock_locate,
+        tracking_number,
+        timestamp,
+        mpid,
+        stock,
+        primary_market_maker,
+        market_maker_mode,
+        market_participant_state>;
+
+    using batch = fields::message_batch;
+};
+
+// Mwcb Decline Level Message
+struct mwcb_decline_level_message {
+    static constexpr auto name = "mwcb_decline_level_message";
+    static constexpr auto type = 'V';
+
+    using fields = field_list<
+        stock_locate,
+        tracking_number,
+        timestamp,
+        level_1,
+        level_2,
+        level_3>;
+
+    using batch = fields::message_batch;
+};
+
+// Mwcb Status Level Message
+struct mwcb_status_level_message {
+    static constexpr auto name = "mwcb_status_level_message";
+    static constexpr auto type = 'W';
+
+    using fields = field_list<
+        stock_locate,
+        tracking_number,
+        timestamp,
+        breached_level>;
+
+    using batch = fields::message_batch;
+};
+
+// Net Order Imbalance Indicator Message
+struct net_order_imbalance_indicator_message {
+    static constexpr auto name = "net_order_imbalance_indicator_message";
+    static constexpr auto type = 'I';
+
+    using fields = field_list<
+        stock_locate,
+        tracking_number,
+        timestamp,
+        paired_shares,
+        imbalance_shares,
+        imbalance_direction,
+        stock,
+        far_price,
+        near_price,
+        current_reference_price,
+        cross_type,
+        price_variation_indicator>;
+
+    using batch = fields::message_batch;
+};
+
+// Non Cross Trade Message
+struct non_cross_trade_message {
+    static constexpr auto name = "non_cross_trade_message";
+    static constexpr auto type = 'P';
+
+    using fields = field_list<
+        stock_locate,
+        tracking_number,
+        timestamp,
+        order_reference_number,
+        buy_sell_indicator,
+        shares,
+        stock,
+        price,
+        match_number>;
+
+    using batch = fields::message_batch;
+};
+
+// Order Cancel Message
+struct order_cancel_message {
+    static constexpr auto name = "order_cancel_message";
+    static constexpr auto type = 'X';
+
+    using fields = field_list<
+        stock_locate,
+        tracking_number,
+        timestamp,
+        order_reference_number,
+        canceled_shares>;
+
+    using batch = fields::message_batch;
+};
+
+// Order Delete Message
+struct order_delete_message {
+    static constexpr auto name = "order_delete_message";
+    static constexpr auto type = 'D';
+
+    using fields = field_list<
+        stock_locate,
+        tracking_number,
+        timestamp,
+        order_reference_number>;
+
+    using batch = fields::message_batch;
+};
+
+// Order Executed Message
+struct order_executed_message {
+    static constexpr auto name = "order_executed_message";
+    static constexpr auto type = 'E';
+
+    using fields = field_list<
+        stock_locate,
+        tracking_number,
+        timestamp,
+        order_reference_number,
+        executed_shares,
+        match_number>;
+
+    using batch = fields::message_batch;
+};
+
+// Order Executed With Price Message
+struct order_executed_with_price_message {
+    static constexpr auto name = "order_executed_with_price_message";
+    static constexpr auto type = 'C';
+
+    using fields = field_list<
+        stock_locate,
+        tracking_number,
+        timestamp,
+        order_reference_number,
+        executed_shares,
+        match_number,
+        printable,
+        execution_price>;
+
+    using batch = fields::message_batch;
+};
+
+// Order Replace Message
+struct order_replace_message {
+    static constexpr auto name = "order_replace_message";
+    static constexpr auto type = 'U';
+
+    using fields = field_list<
+        stock_locate,
+        tracking_number,
+        timestamp,
+        original_order_reference_number,
+        new_order_reference_number,
+        shares,
+        price>;
+
+    using batch = fields::message_batch;
+};
+
+// Reg Sho Short Sale Price Test Restricted Indicator Message
+struct reg_sho_short_sale_price_test_restricted_indicator_message {
+    static constexpr auto name = "reg_sho_short_sale_price_test_restricted_indicator_message";
+    static constexpr auto type = 'Y';
+
+    using fields = field_list<
+        locate_code,
+        tracking_number,
+        timestamp,
+        stock,
+        reg_sho_action>;
+
+    using batch = fields::message_batch;
+};
 
-                writer << record;
+// Retail Interest Message
+struct retail_interest_message {
+    static constexpr auto name = "retail_interest_message";
+    static constexpr auto type = 'N';
+
+    using fields = field_list<
+        stock_locate,
+        tracking_number,
+        timestamp,
+        stock,
+        interest_flag>;
+
+    using batch = fields::message_batch;
+};
+
+// Stock Directory Message
+struct stock_directory_message {
+    static constexpr auto name = "stock_directory_message";
+    static constexpr auto type = 'R';
+
+    using fields = field_list<
+        stock_locate,
+        tracking_number,
+        timestamp,
+        stock,
+        market_category,
+        financial_status_indicator,
+        round_lot_size,
+        round_lots_only,
+        issue_classification,
+        issue_sub_type,
+        authenticity,
+        short_sale_threshold_indicator,
+        ipo_flag,
+        luld_reference_price_tier,
+        etp_flag,
+        etp_leverage_factor,
+        inverse_indicator>;
+
+    using batch = fields::message_batch;
+};
+
+// Stock Trading Action Message
+struct stock_trading_action_message {
+    static constexpr auto name = "stock_trading_action_message";
+    static constexpr auto type = 'H';
+
+    using fields = field_list<
+        stock_locate,
+        tracking_number,
+        timestamp,
+        stock,
+        trading_state,
+        reserved,
+        reason>;
+
+    using batch = fields::message_batch;
+};
+
+// System Event Message
+struct system_event_message {
+    static constexpr auto name = "system_event_message";
+    static constexpr auto type = 'S';
+
+    using fields = field_list<
+        stock_locate,
+        tracking_number,
+        timestamp,
+        event_code>;
+
+    using batch = fields::message_batch;
+};
+
+// message type dispatch through tables indexed by the type character
+template <typename... messages>
+struct message_types {
+
+    // bytes of the shortest message in the feed
+    static constexpr std::uint32_t smallest_wire_size = std::min({(message_type::size + messages::fields::size)...});
+
+    // message name by type, null for types outside the feed
+    static const char* name_of(const char type) {
+        const char* name = nullptr;
+        (void)((type == messages::type && (name = messages::name, true)) || ...);
+        return name;
+    }
+
+    // bytes a message of this type needs on the wire, the type included, zero for types outside the feed
+    static std::uint32_t wire_size(const char type) {
+        static constexpr auto table = [] {
+            std::array<std::uint32_t, 256> table{};
+            ((table[static_cast<std::uint8_t>(messages::type)] = message_type::size + messages::fields::size), ...);
+            return table;
+        }();
+
+        return table[static_cast<std::uint8_t>(type)];
+    }
+
+    // clear the fields a message of this type set
+    static void reset(record& record) {
+        static constexpr auto table = [] {
+            std::array<void (*)(nasdaq::itch::record&), 256> table{};
+            table.fill([](nasdaq::itch::record&) {});
+            ((table[static_cast<std::uint8_t>(messages::type)] = &messages::fields::reset), ...);
+            return table;
+        }();
+
+        table[static_cast<std::uint8_t>(record.message_type.data)](record);
+    }
+
+    // append a wide row touching only the columns a message of this type can set
+    template <typename batch>
+    static void append(batch& rows, const record& record) {
+        static constexpr auto table = [] {
+            std::array<void (*)(batch&, const nasdaq::itch::record&), 256> table{};
+            table.fill([](batch& rows, const nasdaq::itch::record& record) { rows.append_sparse(record, enrichment_fields{}); });
+            ((table[static_cast<std::uint8_t>(messages::type)] = [](batch& rows, const nasdaq::itch::record& record) {
+                rows.append_sparse(record, typename messages::fields{}, enrichment_fields{});
+            }), ...);
+            return table;
+        }();
+
+        table[static_cast<std::uint8_t>(record.message_type.data)](rows, record);
+    }
+};
+
+using all_messages = message_types<
+    add_order_no_mpid_attribution_message,
+    add_order_with_mpid_attribution_message,
+    broken_trade_message,
+    cross_trade_message,
+    ipo_quoting_period_update,
+    luld_auction_collar_message,
+    market_participant_position_message,
+    mwcb_decline_level_message,
+    mwcb_status_level_message,
+    net_order_imbalance_indicator_message,
+    non_cross_trade_message,
+    order_cancel_message,
+    order_delete_message,
+    order_executed_message,
+    order_executed_with_price_message,
+    order_replace_message,
+    reg_sho_short_sale_price_test_restricted_indicator_message,
+    retail_interest_message,
+    stock_directory_message,
+    stock_trading_action_message,
+    system_event_message>;
+
+using wide_batch = batch_of<decltype(std::declval<const record&>().fields())>::type;
+
+// wide record column batch
+struct record_batch : wide_batch {
+
+    using wide_batch::wide_batch;
+
+    void append(const record& record) {
+        all_messages::append(*this, record);
+    }
+};
+
+// column encodings declared by the field types, dictionary columns fall back to plain
+template <typename... fields>
+void prefer_encodings(parquet::WriterProperties::Builder& builder, const std::tuple<const fields&...>*) {
+    ([&] {
+        if constexpr (requires { fields::encoding; }) {
+            if constexpr (fields::encoding == parquet::Encoding::RLE_DICTIONARY) {
+                builder.enable_dictionary(fields::name);
+            } else {
+                builder.disable_dictionary(fields::name);
+                builder.encoding(fields::name, fields::encoding);
             }
         }
-    }
+    }(), ...);
+}
 
-    void process(u_char **message, const char message_type) {
-        switch (message_type) {
-            case 'S':
-                process_system_event_message(message);
-                break;
+inline void prefer_encodings(parquet::WriterProperties::Builder& builder) {
+    prefer_encodings(builder, static_cast<const decltype(std::declval<const record&>().fields())*>(nullptr));
+}
 
-            case 'R':
-                process_stock_directory_message(message);
-                break;
+// point lookup columns declared by the field types
+template <typename... fields>
+std::vector<std::string> lookup_columns(const std::tuple<const fields&...>*) {
+    std::vector<std::string> columns;
+    ([&] {
+        if constexpr (requires { fields::lookup; }) {
+            columns.emplace_back(fields::name);
+        }
+    }(), ...);
+    return columns;
+}
 
-            case 'H':
-                process_stock_trading_action_message(message);
-                break;
+inline std::vector<std::string> lookup_columns() {
+    return lookup_columns(static_cast<const decltype(std::declval<const record&>().fields())*>(nullptr));
+}
 
-            case 'Y':
-                process_reg_sho_short_sale_price_test_restricted_indicator_message(message);
-                break;
+///////////////////////////////////////////////////////////////////////
+// order book
+///////////////////////////////////////////////////////////////////////
 
-            case 'L':
-                process_market_participant_position_message(message);
-                break;
+// live order, from add until fully executed, canceled or deleted
+struct order {
+    std::uint32_t price = 0;
+    std::uint32_t shares = 0;
+    std::uint8_t buy_sell_indicator = 0;
+    decltype(nasdaq::itch::stock::data) stock;
+};
+
+// live orders by order reference number, resolves price, side and stock onto executions, cancels and replaces
+struct order_book {
+
+    order_index index;
+    order_pool<order> pool;
+
+    // message types that change or read order state
+    static bool tracks(const char type) {
+        switch (type) {
+            case add_order_no_mpid_attribution_message::type:
+            case add_order_with_mpid_attribution_message::type:
+            case order_executed_message::type:
+            case order_executed_with_price_message::type:
+            case order_cancel_message::type:
+            case order_delete_message::type:
+            case order_replace_message::type:
+                return true;
+            default:
+                return false;
+        }
+    }
 
-            case 'V':
-                process_mwcb_decline_level_message(message);
+    void apply(record& record) {
+        switch (record.message_type.data) {
+            case add_order_no_mpid_attribution_message::type:
+            case add_order_with_mpid_attribution_message::type:
+                add(record);
                 break;
 
-            case 'W':
-                process_mwcb_status_level_message(message);
+            case order_executed_message::type:
+            case order_executed_with_price_message::type:
+                reduce(record, record.executed_shares.data.value_or(0));
                 break;
 
-            case 'K':
-                process_ipo_quoting_period_update(message);
+            case order_cancel_message::type:
+                reduce(record, record.canceled_shares.data.value_or(0));
                 break;
 
-            case 'A':
-                process_add_order_no_mpid_attribution_message(message);
+            case order_delete_message::type:
+                reduce(record, std::numeric_limits<std::uint32_t>::max());
                 break;
 
-            case 'J':
-                process_luld_auction_collar_message(message);
+            case order_replace_message::type:
+                replace(record);
                 break;
 
-            case 'F':
-                process_add_order_with_mpid_attribution_message(message);
+            default:
                 break;
+        }
+    }
 
-            case 'E':
-                process_order_executed_message(message);
-                break;
+    void add(record& record) {
+        if (!record.order_reference_number.data) {
+            return;
+        }
 
-            case 'C':
-                process_order_executed_with_price_message(message);
-                break;
+        const auto position = pool.allocate();
+        auto& order = pool[position];
+        order.price = record.price.data.value_or(0);
+        order.shares = record.shares.data.value_or(0);
+        order.buy_sell_indicator = record.buy_sell_indicator.data.value_or(0);
+        order.stock = record.stock.data;
 
-            case 'X':
-                process_order_cancel_message(message);
-                break;
+        // a reused reference replaces the stale order
+        if (const auto previous = index.insert(*record.order_reference_number.data, position); previous != order_index::empty) {
+            pool.release(previous);
+        }
 
-            case 'D':
-                process_order_delete_message(message);
-                break;
+        record.remaining_shares.data = order.shares;
+    }
 
-            case 'U':
-                process_order_replace_message(message);
-                break;
+    void reduce(record& record, const std::uint32_t shares) {
+        if (!record.order_reference_number.data) {
+            return;
+        }
 
-            case 'P':
-                process_non_cross_trade_message(message);
-                break;
+        const auto key = *record.order_reference_number.data;
+        const auto position = index.find(key);
+        if (position == order_index::empty) {
+            return;
+        }
 
-            case 'Q':
-                process_cross_trade_message(message);
-                break;
+        auto& order = pool[position];
+        order.shares -= std::min(order.shares, shares);
+        resolve(record, order);
 
-            case 'B':
-                process_broken_trade_message(message);
-                break;
+        if (order.shares == 0) {
+            index.erase(key);
+            pool.release(position);
+        }
+    }
 
-            case 'I':
-                process_net_order_imbalance_indicator_message(message);
-                break;
+    // the new reference inherits side and stock, price and shares come from the replace
+    void replace(record& record) {
+        if (!record.original_order_reference_number.data || !record.new_order_reference_number.data) {
+            return;
+        }
 
-            case 'N':
-                process_retail_interest_message(message);
-                break;
+        const auto position = index.erase(*record.original_order_reference_number.data);
+        if (position == order_index::empty) {
+            return;
+        }
 
-            default:
-                break;
+        auto& order = pool[position];
+        order.price = record.price.data.value_or(order.price);
+        order.shares = record.shares.data.value_or(0);
+        resolve(record, order);
+
+        if (const auto previous = index.insert(*record.new_order_reference_number.data, position); previous != order_index::empty) {
+            pool.release(previous);
         }
     }
 
-    void process_add_order_no_mpid_attribution_message(u_char **message) {
-        record.stock_locate.set(message);
-        record.tracking_number.set(message);
-        record.timestamp.set(message);
-        record.order_reference_number.set(message);
-        record.buy_sell_indicator.set(message);
-        record.shares.set(message);
-        record.stock.set(message);
-        record.price.set(message);
-    }
-
-    void process_add_order_with_mpid_attribution_message(u_char **message) {
-        record.stock_locate.set(message);
-        record.tracking_number.set(message);
-        record.timestamp.set(message);
-        record.order_reference_number.set(message);
-        record.buy_sell_indicator.set(message);
-        record.shares.set(message);
-        record.stock.set(message);
-        record.price.set(message);
-        record.attribution.set(message);
-    }
-
-    void process_broken_trade_message(u_char **message) {
-        record.stock_locate.set(message);
-        record.tracking_number.set(message);
-        record.timestamp.set(message);
-        record.match_number.set(message);
-    }
-
-    void process_cross_trade_message(u_char **message) {
-        record.stock_locate.set(message);
-        record.tracking_number.set(message);
-        record.timestamp.set(message);
-        record.cross_shares.set(message);
-        record.stock.set(message);
-        record.cross_price.set(message);
-        record.match_number.set(message);
-        record.cross_type.set(message);
-    }
-
-    void process_ipo_quoting_period_update(u_char **message) {
-        record.stock_locate.set(message);
-        record.tracking_number.set(message);
-        record.timestamp.set(message);
-        record.stock.set(message);
-        record.ipo_quotation_release_time.set(message);
-        record.ipo_quotation_release_qualifier.set(message);
-        record.ipo_price.set(message);
-    }
-
-    void process_luld_auction_collar_message(u_char **message) {
-        record.stock_locate.set(message);
-        record.tracking_number.set(message);
-        record.timestamp.set(message);
-        record.stock.set(message);
-        record.auction_collar_reference_price.set(message);
-        record.upper_auction_collar_price.set(message);
-        record.lower_auction_collar_price.set(message);
-        record.auction_collar_extension.set(message);
-    }
-
-    void process_market_participant_position_message(u_char **message) {
-        record.stock_locate.set(message);
-        record.tracking_number.set(message);
-        record.timestamp.set(message);
-        record.mpid.set(message);
-        record.stock.set(message);
-        record.primary_market_maker.set(message);
-        record.market_maker_mode.set(message);
-        record.market_participant_state.set(message);
-    }
-
-    void process_mwcb_decline_level_message(u_char **message) {
-        record.stock_locate.set(message);
-        record.tracking_number.set(message);
-        record.timestamp.set(message);
-        record.level_1.set(message);
-        record.level_2.set(message);
-        record.level_3.set(message);
-    }
-
-    void process_mwcb_status_level_message(u_char **message) {
-        record.stock_locate.set(message);
-        record.tracking_number.set(message);
-        record.timestamp.set(message);
-        record.breached_level.set(message);
-    }
-
-    void process_net_order_imbalance_indicator_message(u_char **message) {
-        record.stock_locate.set(message);
-        record.tracking_number.set(message);
-        record.timestamp.set(message);
-        record.paired_shares.set(message);
-        record.imbalance_shares.set(message);
-        record.imbalance_direction.set(message);
-        record.stock.set(message);
-        record.far_price.set(message);
-        record.near_price.set(message);
-        record.current_reference_price.set(message);
-        record.cross_type.set(message);
-        record.price_variation_indicator.set(message);
-    }
-
-    void process_non_cross_trade_message(u_char **message) {
-        record.stock_locate.set(message);
-        record.tracking_number.set(message);
-        record.timestamp.set(message);
-        record.order_reference_number.set(message);
-        record.buy_sell_indicator.set(message);
-        record.shares.set(message);
-        record.stock.set(message);
-        record.price.set(message);
-        record.match_number.set(message);
-    }
-
-    void process_order_cancel_message(u_char **message) {
-        record.stock_locate.set(message);
-        record.tracking_number.set(message);
-        record.timestamp.set(message);
-        record.order_reference_number.set(message);
-        record.canceled_shares.set(message);
-    }
-
-    void process_order_delete_message(u_char **message) {
-        record.stock_locate.set(message);
-        record.tracking_number.set(message);
-        record.timestamp.set(message);
-        record.order_reference_number.set(message);
-    }
-
-    void process_order_executed_message(u_char **message) {
-        record.stock_locate.set(message);
-        record.tracking_number.set(message);
-        record.timestamp.set(message);
-        record.order_reference_number.set(message);
-        record.executed_shares.set(message);
-        record.match_number.set(message);
-    }
-
-    void process_order_executed_with_price_message(u_char **message) {
-        record.stock_locate.set(message);
-        record.tracking_number.set(message);
-        record.timestamp.set(message);
-        record.order_reference_number.set(message);
-        record.executed_shares.set(message);
-        record.match_number.set(message);
-        record.printable.set(message);
-        record.execution_price.set(message);
-    }
-
-    void process_order_replace_message(u_char **message) {
-        record.stock_locate.set(message);
-        record.tracking_number.set(message);
-        record.timestamp.set(message);
-        record.original_order_reference_number.set(message);
-        record.new_order_reference_number.set(message);
-        record.shares.set(message);
-        record.price.set(message);
-    }
-
-    void process_reg_sho_short_sale_price_test_restricted_indicator_message(u_char **message) {
-        record.locate_code.set(message);
-        record.tracking_number.set(message);
-        record.timestamp.set(message);
-        record.stock.set(message);
-        record.reg_sho_action.set(message);
-    }
-
-    void process_retail_interest_message(u_char **message) {
-        record.stock_locate.set(message);
-        record.tracking_number.set(message);
-        record.timestamp.set(message);
-        record.stock.set(message);
-        record.interest_flag.set(message);
-    }
-
-    void process_stock_directory_message(u_char **message) {
-        record.stock_locate.set(message);
-        record.tracking_number.set(message);
-        record.timestamp.set(message);
-        record.stock.set(message);
-        record.market_category.set(message);
-        record.financial_status_indicator.set(message);
-        record.round_lot_size.set(message);
-        record.round_lots_only.set(message);
-        record.issue_classification.set(message);
-        record.issue_sub_type.set(message);
-        record.authenticity.set(message);
-        record.short_sale_threshold_indicator.set(message);
-        record.ipo_flag.set(message);
-        record.luld_reference_price_tier.set(message);
-        record.etp_flag.set(message);
-        record.etp_leverage_factor.set(message);
-        record.inverse_indicator.set(message);
-    }
-
-    void process_stock_trading_action_message(u_char **message) {
-        record.stock_locate.set(message);
-        record.tracking_number.set(message);
-        record.timestamp.set(message);
-        record.stock.set(message);
-        record.trading_state.set(message);
-        record.reserved.set(message);
-        record.reason.set(message);
-    }
-
-    void process_system_event_message(u_char **message) {
-        record.stock_locate.set(message);
-        record.tracking_number.set(message);
-        record.timestamp.set(message);
-        record.event_code.set(message);
-    }
-
-    // required to finish parquet file
-    void close() {
-        writer << parquet::EndRowGroup;
-    }
-};
-
-void write_parquet(const options& options) {
-    // open capture file
-    char buffer[PCAP_ERRBUF_SIZE];
-    const auto pcap = pcap_open_offline(options.pcap_file.c_str(), buffer);
-    if (pcap == nullptr)
-    {
-        throw std::runtime_error("Unable to open file "); // need to add buffer
-    }
-
-    converter converter(options);
-
-    // loop through packets
-    pcap_pkthdr* header;
-    const u_char* packet;
-
-    while (true) {
-        switch (pcap_next_ex(pcap, &header, &packet)) {
-        case 1:
-            converter.process(header, packet);
-            break;
-        case 0:
-            // timeout
-        case -1:
-            //     std::cerr << "Error: " << pcap_geterr(p) << std::endl;
-        case -2:
-            // end-of-file
-        default:
-            converter.close();
-            pcap_close(pcap);
-            return;
+    static void resolve(record& record, const order& order) {
+        if (!record.price.data) {
+            record.price.data = order.price;
+        }
+        if (!record.buy_sell_indicator.data) {
+            record.buy_sell_indicator.data = order.buy_sell_indicator;
         }
+        if (!record.stock.data) {
+            record.stock.data = order.stock;
+        }
+        record.remaining_shares.data = order.shares;
     }
-}
+};
 
-void read_parquet(const std::string& parquet_file) {
-    std::shared_ptr<arrow::io::ReadableFile> infile;
+///////////////////////////////////////////////////////////////////////
+// converter interface
+///////////////////////////////////////////////////////////////////////
+
+// instrument directory and the message that lists an instrument
+using instrument_directory = stock_directory;
+using directory_message = stock_directory_message;
 
-    PARQUET_ASSIGN_OR_THROW(infile, arrow::io::ReadableFile::Open(parquet_file));
+// columns of the --stock-locate, --from and --to, and order number query filters, time filters the itch timestamp
+using instrument_field = stock_locate;
+using time_field = timestamp;
+using order_field = order_reference_number;
 
-    parquet::StreamReader reader{ parquet::ParquetFileReader::Open(infile) };
+// partition columns of a dataset, in directory order
+inline constexpr std::string_view default_partitioning = "date=/message_type=/locate_bucket=";
 
-    nasdaq::itch::record record{};
+// command line names of the symbol and instrument filters, and their usage with the time format
+inline constexpr std::string_view symbol_option = "--stock";
+inline constexpr std::string_view instrument_option = "--stock-locate";
+inline constexpr std::string_view filter_usage = "[--stock symbol] [--stock-locate locate] [--from hh:mm:ss] [--to hh:mm:ss]";
 
-    while (!reader.eof()) {
-        reader >> record;
-        std::cout << record;
+// --from and --to, nanoseconds since midnight from hh:mm[:ss[.fraction]]
+inline std::uint64_t time_filter(const std::string& text) {
+    unsigned hours = 0;
+    unsigned minutes = 0;
+    double seconds = 0;
+
+    if (std::sscanf(text.c_str(), "%u:%u:%lf", &hours, &minutes, &seconds) < 2) {
+        throw std::invalid_argument("Invalid time " + text);
     }
+
+    return (hours * 3600ull + minutes * 60ull) * 1'000'000'000ull + static_cast<std::uint64_t>(seconds * 1e9 + 0.5);
 }
 
-int main(const int argc, char** argv) {
+// message types the directory, order book or event clock are built from, order messages only while orders are tracked
+inline bool primes(const char type, const bool orders) {
+    return type == stock_directory_message::type || (orders && order_book::tracks(type));
+}
 
-    // parse arguments
-    options options;
+// decode a message through the converter's definition of its type, false for a type outside the feed
+template <typename converter>
+bool dispatch(converter& target, u_char **message, const char message_type) {
+    switch (message_type) {
+        case 'S':
+            target.template process_message<system_event_message>(message);
+            break;
 
-    if (argc == 3)
-    {
-        options.pcap_file = argv[1];
-        options.parquet_file = argv[2];
-    }
-    else if (argc == 2)
-    {
-        options.pcap_file = argv[1];
-    }
-    else
-    {
-        std::cout << "usage: " << argv[0] << " pcap_file parquet_file" << std::endl;
-        return -1;
+        case 'R':
+            target.process_directory_message(message);
+            break;
+
+        case 'H':
+            target.template process_message<stock_trading_action_message>(message);
+            break;
+
+        case 'Y':
+            target.template process_message<reg_sho_short_sale_price_test_restricted_indicator_message>(message);
+            break;
+
+        case 'L':
+            target.template process_message<market_participant_position_message>(message);
+            break;
+
+        case 'V':
+            target.template process_message<mwcb_decline_level_message>(message);
+            break;
+
+        case 'W':
+            target.template process_message<mwcb_status_level_message>(message);
+            break;
+
+        case 'K':
+            target.template process_message<ipo_quoting_period_update>(message);
+            break;
+
+        case 'A':
+            target.template process_message<add_order_no_mpid_attribution_message>(message);
+            break;
+
+        case 'J':
+            target.template process_message<luld_auction_collar_message>(message);
+            break;
+
+        case 'F':
+            target.template process_message<add_order_with_mpid_attribution_message>(message);
+            break;
+
+        case 'E':
+            target.template process_message<order_executed_message>(message);
+            break;
+
+        case 'C':
+            target.template process_message<order_executed_with_price_message>(message);
+            break;
+
+        case 'X':
+            target.template process_message<order_cancel_message>(message);
+            break;
+
+        case 'D':
+            target.template process_message<order_delete_message>(message);
+            break;
+
+        case 'U':
+            target.template process_message<order_replace_message>(message);
+            break;
+
+        case 'P':
+            target.template process_message<non_cross_trade_message>(message);
+            break;
+
+        case 'Q':
+            target.template process_message<cross_trade_message>(message);
+            break;
+
+        case 'B':
+            target.template process_message<broken_trade_message>(message);
+            break;
+
+        case 'I':
+            target.template process_message<net_order_imbalance_indicator_message>(message);
+            break;
+
+        case 'N':
+            target.template process_message<retail_interest_message>(message);
+            break;
+
+        default:
+            return false;
     }
 
-    write_parquet(options);
+    return true;
+}
+}
+
+// the feed the shared converter is built for
+namespace feed = nasdaq::itch;
 
-    read_parquet(options.parquet_file);
+#include "itch_converter.h"
 
-    return 0;
-}
\ No newline at end of file
+#ifndef OMI_BENCHMARK
+int main(const int argc, char** argv) {
+    return run(argc, argv);
+}
+#endif